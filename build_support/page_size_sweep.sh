@@ -0,0 +1,33 @@
+#!/bin/bash
+
+## =================================================================
+## PAGE SIZE SWEEP
+##
+## Builds BusTub once for every supported page size, runs the
+## storage tests against each build and compares the builds with
+## the pagesize scenario of bustub-bpm-bench. Data and pool are
+## given in 4 KB units, so every build sees the same bytes.
+##
+## Usage: build_support/page_size_sweep.sh [bpm-bench options]
+## e.g.   build_support/page_size_sweep.sh --pages 8192 --pool-size 2048
+## =================================================================
+
+set -e
+
+DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" >/dev/null 2>&1 && pwd )"
+cd "$DIR/.."
+
+PAGE_SIZES="4096 8192 16384 32768"
+STORAGE_TESTS="lz_compressor_test disk_manager_test buffer_pool_manager_instance_test b_plus_tree_insert_test b_plus_tree_delete_test b_plus_tree_concurrent_test tuple_test"
+
+for page_size in ${PAGE_SIZES}; do
+  build_dir="build-page-${page_size}"
+  cmake -S . -B "${build_dir}" -DCMAKE_BUILD_TYPE=Release -DBUSTUB_PAGE_SIZE="${page_size}" >/dev/null
+  # shellcheck disable=SC2086
+  cmake --build "${build_dir}" -j"$(nproc)" --target ${STORAGE_TESTS} bpm-bench
+  (cd "${build_dir}" && ctest --output-on-failure -R "LZCompressor|DiskManager|BufferPoolManagerInstance|BPlusTree|Tuple")
+done
+
+for page_size in ${PAGE_SIZES}; do
+  "build-page-${page_size}/bin/bustub-bpm-bench" --scenario pagesize "$@"
+done
@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// access_buffer.cpp
+//
+// Identification: src/buffer/access_buffer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/access_buffer.h"
+
+#include <algorithm>
+#include <functional>
+#include <thread>  // NOLINT
+
+namespace bustub {
+
+namespace {
+auto ThreadStripe() -> size_t {
+  static thread_local size_t stripe = std::hash<std::thread::id>{}(std::this_thread::get_id());
+  return stripe;
+}
+}  // namespace
+
+AccessBuffer::AccessBuffer() {
+  for (auto &stripe : stripes_) {
+    for (size_t i = 0; i < STRIPE_CAPACITY; i++) {
+      stripe.slots_[i].sequence_.store(i, std::memory_order_relaxed);
+    }
+  }
+}
+
+auto AccessBuffer::TryRecord(const Event &event) -> bool {
+  auto &stripe = stripes_[ThreadStripe() % NUM_STRIPES];
+  uint64_t pos = stripe.tail_.load(std::memory_order_relaxed);
+  while (true) {
+    auto &slot = stripe.slots_[pos % STRIPE_CAPACITY];
+    uint64_t sequence = slot.sequence_.load(std::memory_order_acquire);
+    if (sequence == pos) {
+      // The slot is free for pos; claim it.
+      if (stripe.tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        slot.event_ = event;
+        slot.sequence_.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (sequence < pos) {
+      // The slot still holds the event of pos - STRIPE_CAPACITY: the ring is full.
+      return false;
+    } else {
+      // Another producer claimed pos first.
+      pos = stripe.tail_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+void AccessBuffer::Drain(std::vector<Event> *events) {
+  size_t first = events->size();
+  for (auto &stripe : stripes_) {
+    while (true) {
+      auto &slot = stripe.slots_[stripe.head_ % STRIPE_CAPACITY];
+      // A claimed slot whose event is not written yet ends the batch of this ring.
+      if (slot.sequence_.load(std::memory_order_acquire) != stripe.head_ + 1) {
+        break;
+      }
+      events->push_back(slot.event_);
+      slot.sequence_.store(stripe.head_ + STRIPE_CAPACITY, std::memory_order_release);
+      stripe.head_++;
+    }
+  }
+  std::sort(events->begin() + first, events->end(),
+            [](const Event &a, const Event &b) { return a.timestamp_ < b.timestamp_; });
+}
+
+}  // namespace bustub
@@ -0,0 +1,147 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.cpp
+//
+// Identification: src/buffer/arc_replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+ARCReplacer::ARCReplacer(size_t num_frames) : replacer_size_(num_frames), frames_(num_frames) {}
+
+auto ARCReplacer::PreferT1() const -> bool { return !t1_.empty() && (t1_size_ > p_ || t2_.empty()); }
+
+void ARCReplacer::Drop(frame_id_t frame_id) {
+  auto &frame = frames_[frame_id];
+  if (frame.is_evictable_) {
+    ListOf(frame_id).erase({frame.last_access_, frame_id});
+    curr_size_--;
+  }
+  (frame.in_t2_ ? t2_size_ : t1_size_)--;
+  frame = FrameInfo{};
+}
+
+auto ARCReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  bool from_t1 = PreferT1();
+  auto &list = from_t1 ? t1_ : t2_;
+  if (list.empty()) {
+    return false;
+  }
+  *frame_id = list.begin()->second;
+  (from_t1 ? b1_ : b2_).PushFront(frames_[*frame_id].page_id_);
+  Drop(*frame_id);
+  return true;
+}
+
+void ARCReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  auto &frame = frames_[frame_id];
+  if (frame.page_id_ != page_id && frame.page_id_ != INVALID_PAGE_ID) {
+    Drop(frame_id);
+  }
+  if (frame.is_evictable_) {
+    ListOf(frame_id).erase({frame.last_access_, frame_id});
+  }
+
+  if (frame.page_id_ == page_id) {
+    // Hit: the page has been seen twice now.
+    if (!frame.in_t2_) {
+      t1_size_--;
+      t2_size_++;
+      frame.in_t2_ = true;
+    }
+  } else if (b1_.Contains(page_id)) {
+    // Evicted from T1 too early: give T1 more room.
+    p_ = std::min(replacer_size_, p_ + std::max<size_t>(1, b2_.Size() / b1_.Size()));
+    b1_.Erase(page_id);
+    frame.page_id_ = page_id;
+    frame.in_t2_ = true;
+    t2_size_++;
+  } else if (b2_.Contains(page_id)) {
+    // Evicted from T2 too early: give T2 more room.
+    size_t delta = std::max<size_t>(1, b1_.Size() / b2_.Size());
+    p_ = p_ > delta ? p_ - delta : 0;
+    b2_.Erase(page_id);
+    frame.page_id_ = page_id;
+    frame.in_t2_ = true;
+    t2_size_++;
+  } else {
+    frame.page_id_ = page_id;
+    frame.in_t2_ = false;
+    t1_size_++;
+    // Keep |T1| + |B1| <= c and |T1| + |T2| + |B1| + |B2| <= 2c.
+    while (b1_.Size() > 0 && t1_size_ + b1_.Size() > replacer_size_) {
+      b1_.PopBack();
+    }
+    while (b2_.Size() > 0 && t1_size_ + t2_size_ + b1_.Size() + b2_.Size() > 2 * replacer_size_) {
+      b2_.PopBack();
+    }
+  }
+
+  frame.last_access_ = current_timestamp_++;
+  if (frame.is_evictable_) {
+    ListOf(frame_id).emplace(frame.last_access_, frame_id);
+  }
+}
+
+void ARCReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  auto &frame = frames_[frame_id];
+  if (frame.page_id_ == INVALID_PAGE_ID || frame.is_evictable_ == set_evictable) {
+    return;
+  }
+  if (set_evictable) {
+    ListOf(frame_id).emplace(frame.last_access_, frame_id);
+    curr_size_++;
+  } else {
+    ListOf(frame_id).erase({frame.last_access_, frame_id});
+    curr_size_--;
+  }
+  frame.is_evictable_ = set_evictable;
+}
+
+void ARCReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  if (frames_[frame_id].page_id_ == INVALID_PAGE_ID) {
+    return;
+  }
+  BUSTUB_ASSERT(frames_[frame_id].is_evictable_, "Remove is called on a non-evictable frame");
+  Drop(frame_id);
+}
+
+auto ARCReplacer::GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> candidates;
+  bool t1_first = PreferT1();
+  for (const auto *list : {t1_first ? &t1_ : &t2_, t1_first ? &t2_ : &t1_}) {
+    for (auto it = list->begin(); it != list->end() && candidates.size() < max_frames; it++) {
+      candidates.push_back(it->second);
+    }
+  }
+  return candidates;
+}
+
+auto ARCReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
+
+auto ARCReplacer::GetTarget() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return p_;
+}
+
+}  // namespace bustub
@@ -12,18 +12,46 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <future>  // NOLINT
+#include <string>
+#include <utility>
+
 #include "common/exception.h"
 #include "common/logger.h"
 #include "common/macros.h"
 namespace bustub {
 
 BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, size_t replacer_k,
-                                                     LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
-  // we allocate a consecutive memory space for the buffer pool
-  pages_ = new Page[pool_size_];
-  page_table_ = new ExtendibleHashTable<page_id_t, frame_id_t>(bucket_size_);
-  replacer_ = new LRUKReplacer(pool_size, replacer_k);
+                                                     LogManager *log_manager, size_t max_pool_size,
+                                                     ReplacerPolicy replacer_policy)
+    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, replacer_k, log_manager, max_pool_size,
+                                replacer_policy) {}
+
+BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                                                     DiskManager *disk_manager, size_t replacer_k,
+                                                     LogManager *log_manager, size_t max_pool_size,
+                                                     ReplacerPolicy replacer_policy)
+    : pool_size_(pool_size),
+      max_pool_size_(max_pool_size == 0 ? pool_size : max_pool_size),
+      num_instances_(num_instances),
+      instance_index_(instance_index),
+      next_page_id_(static_cast<page_id_t>(instance_index)),
+      disk_manager_(disk_manager),
+      log_manager_(log_manager),
+      frame_io_(max_pool_size_) {
+  BUSTUB_ASSERT(num_instances > 0, "If BPI is not part of a pool, then the pool size should just be 1");
+  BUSTUB_ASSERT(
+      instance_index < num_instances,
+      "BPI index cannot be greater than the number of BPIs in the pool. In non-parallel case, index should just be 0.");
+  BUSTUB_ASSERT(pool_size <= max_pool_size_, "pool size cannot exceed the maximum pool size");
+  // we allocate a consecutive, page-aligned memory space for the buffer pool, large enough to grow to max_pool_size_
+  arena_ = new FrameArena(pool_size_, true, max_pool_size_);
+  pages_ = arena_->GetPages();
+  page_table_ = new PageTable(pool_size_);
+  replacer_ = CreateReplacer(replacer_policy, max_pool_size_, replacer_k);
 
   // Initially, every page is in the free list.
   for (size_t i = 0; i < pool_size_; ++i) {
@@ -37,7 +65,11 @@ BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManag
 }
 
 BufferPoolManagerInstance::~BufferPoolManagerInstance() {
-  delete[] pages_;
+  WaitForWarmUp();
+  StopHotSetDumper();
+  StopPageCleaner();
+  StopPrefetcher();
+  delete arena_;
   delete page_table_;
   delete replacer_;
 }
@@ -59,34 +91,45 @@ BufferPoolManagerInstance::~BufferPoolManagerInstance() {
  * @return nullptr if no new pages could be created, otherwise pointer to new page
  */
 
-auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * {
-  latch_.lock();
+auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * { return NewPgImp(page_id, INVALID_PAGE_ID); }
+
+auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id, page_id_t hint) -> Page * {
+  std::unique_lock<std::mutex> lock(latch_);
+  if (NeedsBatchEviction()) {
+    EvictBatch(&lock);
+  }
   frame_id_t frame_id;
-  if (!free_list_.empty()) {
-    frame_id = free_list_.front();
-    free_list_.pop_front();
-  } else if (replacer_->Size() != 0) {
-    replacer_->Evict(&frame_id);
-    if (pages_[frame_id].IsDirty()) {
-      disk_manager_->WritePage(pages_[frame_id].GetPageId(), pages_[frame_id].GetData());
-      pages_[frame_id].is_dirty_ = false;
-    }
-    pages_[frame_id].ResetMemory();
-    page_table_->Remove(pages_[frame_id].GetPageId());
-    replacer_->Remove(frame_id);
-  } else {
-    latch_.unlock();
+  page_id_t victim_page_id = INVALID_PAGE_ID;
+  if (!AcquireFrame(&frame_id, &victim_page_id)) {
     return nullptr;
   }
-  page_id_t new_page_id = AllocatePage();
+  bool reused;
+  page_id_t new_page_id = AllocatePage(hint, &reused);
+  stat_new_pages_++;
 
   pages_[frame_id].page_id_ = new_page_id;
   pages_[frame_id].pin_count_++;
+  pages_[frame_id].is_dirty_ = reused;
   *page_id = new_page_id;
+  // Hits find the page as soon as it is in the page table, without the latch; the frame must be ready by then.
+  if (victim_page_id == INVALID_PAGE_ID) {
+    pages_[frame_id].ResetMemory();
+  } else {
+    frame_io_[frame_id].in_progress_ = true;
+  }
   page_table_->Insert(new_page_id, frame_id);
-  replacer_->RecordAccess(frame_id);
-  replacer_->SetEvictable(frame_id, false);
-  latch_.unlock();
+  replacer_->RecordAccessAndPin(frame_id, new_page_id);
+  if (victim_page_id == INVALID_PAGE_ID) {
+    return &pages_[frame_id];
+  }
+
+  // The frame still holds the dirty victim. Write it back without holding the latch; fetchers of the new page wait
+  // on the frame until it has been zeroed.
+  lock.unlock();
+  WriteBack(victim_page_id, frame_id);
+  pages_[frame_id].ResetMemory();
+  lock.lock();
+  FinishIO(victim_page_id, frame_id);
   return &pages_[frame_id];
 }
 
@@ -106,40 +149,72 @@ auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * {
  * @param page_id id of page to be fetched
  * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
  */
-auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * {
-  latch_.lock();
+auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * { return FetchPgImp(page_id, nullptr); }
+
+auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * {
+  std::unique_lock<std::mutex> lock(latch_, std::defer_lock);
   frame_id_t frame_id;
   if (page_table_->Find(page_id, frame_id)) {
-    pages_[frame_id].pin_count_++;
-    replacer_->RecordAccess(frame_id);
-    replacer_->SetEvictable(frame_id, false);
-    latch_.unlock();
-    return &pages_[frame_id];
-  }
-  // same as NewPgImp
-  if (!free_list_.empty()) {
-    frame_id = free_list_.front();
-    free_list_.pop_front();
-  } else if (replacer_->Size() != 0) {
-    replacer_->Evict(&frame_id);
-    if (pages_[frame_id].IsDirty()) {
-      disk_manager_->WritePage(pages_[frame_id].GetPageId(), pages_[frame_id].GetData());
-      pages_[frame_id].is_dirty_ = false;
+    // A hit only pins the frame. The page may have been evicted between the lookup and the pin; an evictor takes the
+    // page out of the page table before it looks at the pin count, so finding it again means it stays.
+    Page &page = pages_[frame_id];
+    page.pin_count_++;
+    frame_id_t pinned_frame_id;
+    if (page_table_->Find(page_id, pinned_frame_id) && pinned_frame_id == frame_id && page.GetPageId() == page_id) {
+      stat_hits_++;
+      replacer_->RecordAccessAndPin(frame_id, page_id);
+      if (frame_io_[frame_id].in_progress_) {
+        // Somebody else is still bringing the page in. The pin keeps the frame from being reused meanwhile.
+        lock.lock();
+        frame_io_[frame_id].cv_.wait(lock, [&] { return !frame_io_[frame_id].in_progress_; });
+      }
+      return &page;
+    }
+    // The frame belongs to somebody else now. Whoever unpinned it meanwhile may have left its release to us.
+    lock.lock();
+    if (--page.pin_count_ == 0 &&
+        (static_cast<size_t>(frame_id) >= pool_size_ ||
+         (page.GetPageId() != INVALID_PAGE_ID && page_table_->Find(page.GetPageId(), pinned_frame_id) &&
+          pinned_frame_id == frame_id))) {
+      ReleaseFrame(frame_id);
     }
-    pages_[frame_id].ResetMemory();
-    page_table_->Remove(pages_[frame_id].GetPageId());
-    replacer_->Remove(frame_id);
   } else {
-    latch_.unlock();
+    lock.lock();
+  }
+  while (true) {
+    if (page_table_->Find(page_id, frame_id)) {
+      stat_hits_++;
+      pages_[frame_id].pin_count_++;
+      replacer_->RecordAccessAndPin(frame_id, page_id);
+      // Somebody else is still bringing the page in. The pin keeps the frame from being reused meanwhile.
+      frame_io_[frame_id].cv_.wait(lock, [&] { return !frame_io_[frame_id].in_progress_; });
+      return &pages_[frame_id];
+    }
+    // The page was just evicted and is still being written back; reading it now would return stale data.
+    if (writing_back_.count(page_id) != 0) {
+      WaitForWriteBack(&lock, page_id);
+      continue;
+    }
+    if (!NeedsBatchEviction()) {
+      break;
+    }
+    // The latch is dropped while the batch is written, somebody else may bring the page in meanwhile.
+    EvictBatch(&lock);
+  }
+  // A deleted page must not come back in: NewPage may hand out its id again and would then find it resident.
+  if (disk_manager_->IsFreePage(page_id)) {
     return nullptr;
   }
-  disk_manager_->ReadPage(page_id, pages_[frame_id].data_);
-  pages_[frame_id].page_id_ = page_id;
-  pages_[frame_id].pin_count_++;
-  page_table_->Insert(page_id, frame_id);
-  replacer_->RecordAccess(frame_id);
-  replacer_->SetEvictable(frame_id, false);
-  latch_.unlock();
+
+  page_id_t victim_page_id = INVALID_PAGE_ID;
+  if (!AcquireFrame(&frame_id, &victim_page_id, strategy)) {
+    return nullptr;
+  }
+  stat_misses_++;
+  if (strategy != nullptr) {
+    strategy->Put(instance_index_, frame_id, page_id);
+  }
+  ReadIntoFrame(&lock, page_id, frame_id, victim_page_id);
   return &pages_[frame_id];
 }
 
@@ -157,53 +232,129 @@ auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * {
  * @return false if the page is not in the page table or its pin count is <= 0 before this call, true otherwise
  */
 auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool {
-  latch_.lock();
+  std::scoped_lock<std::mutex> lock(latch_);
+  return UnpinLocked(page_id, is_dirty);
+}
+
+auto BufferPoolManagerInstance::UnpinLocked(page_id_t page_id, bool is_dirty) -> bool {
   frame_id_t frame_id;
   // If page_id is not in the buffer pool or its pin count is already 0, return false
   if (!page_table_->Find(page_id, frame_id) || pages_[frame_id].pin_count_ <= 0) {
-    latch_.unlock();
     return false;
   }
-  // Decrement the pin count of a page.
-  pages_[frame_id].pin_count_--;
-  // If the pin count reaches 0, the frame should be evictable by the replacer.
-  if (pages_[frame_id].pin_count_ == 0) {
-    replacer_->SetEvictable(frame_id, true);
-    // Also, set the dirty flag on the page to indicate if the page was modified.
-  }
+  // Also, set the dirty flag on the page to indicate if the page was modified.
   if (!pages_[frame_id].is_dirty_) {
     pages_[frame_id].is_dirty_ = is_dirty;
   }
-  latch_.unlock();
+  // Decrement the pin count of a page. If the pin count reaches 0, the frame should be evictable by the replacer.
+  if (--pages_[frame_id].pin_count_ == 0) {
+    ReleaseFrame(frame_id);
+  }
   return true;
 }
 
+auto BufferPoolManagerInstance::FetchPgsImp(const std::vector<page_id_t> &page_ids, std::vector<Page *> *pages)
+    -> size_t {
+  std::vector<FrameLoad> misses;
+  std::vector<frame_id_t> loading;
+  std::vector<size_t> deferred;
+  pages->assign(page_ids.size(), nullptr);
+
+  std::unique_lock<std::mutex> lock(latch_);
+  if (NeedsBatchEviction()) {
+    EvictBatch(&lock);
+  }
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    page_id_t page_id = page_ids[i];
+    frame_id_t frame_id;
+    if (page_table_->Find(page_id, frame_id)) {
+      stat_hits_++;
+      pages_[frame_id].pin_count_++;
+      replacer_->RecordAccessAndPin(frame_id, page_id);
+      // Somebody else, or this batch, is still bringing the page in; wait for it once the batch's reads are done.
+      if (frame_io_[frame_id].in_progress_) {
+        loading.push_back(frame_id);
+      }
+      (*pages)[i] = &pages_[frame_id];
+      continue;
+    }
+    // Waiting for the write-back here could deadlock with another batch that waits for one of our victims.
+    if (writing_back_.count(page_id) != 0) {
+      deferred.push_back(i);
+      continue;
+    }
+    if (disk_manager_->IsFreePage(page_id)) {
+      continue;
+    }
+    page_id_t victim_page_id = INVALID_PAGE_ID;
+    if (!AcquireFrame(&frame_id, &victim_page_id)) {
+      continue;
+    }
+    stat_misses_++;
+    InstallPage(page_id, frame_id);
+    misses.push_back({page_id, frame_id, victim_page_id});
+    (*pages)[i] = &pages_[frame_id];
+  }
+
+  if (!misses.empty()) {
+    std::sort(misses.begin(), misses.end(),
+              [](const FrameLoad &a, const FrameLoad &b) { return a.page_id_ < b.page_id_; });
+    lock.unlock();
+    LoadFrames(misses);
+    lock.lock();
+    for (const auto &miss : misses) {
+      FinishIO(miss.victim_page_id_, miss.frame_id_);
+    }
+  }
+  for (auto frame_id : loading) {
+    frame_io_[frame_id].cv_.wait(lock, [&] { return !frame_io_[frame_id].in_progress_; });
+  }
+  lock.unlock();
+
+  for (auto i : deferred) {
+    (*pages)[i] = FetchPgImp(page_ids[i]);
+  }
+  return std::count_if(pages->begin(), pages->end(), [](Page *page) { return page != nullptr; });
+}
+
+auto BufferPoolManagerInstance::UnpinPgsImp(const std::vector<page_id_t> &page_ids, bool is_dirty) -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  size_t unpinned = 0;
+  for (auto page_id : page_ids) {
+    unpinned += UnpinLocked(page_id, is_dirty) ? 1 : 0;
+  }
+  return unpinned;
+}
+
 auto BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) -> bool {
-  latch_.lock();
   if (page_id == INVALID_PAGE_ID) {
-    latch_.unlock();
     return false;
   }
+  std::unique_lock<std::mutex> lock(latch_);
   frame_id_t frame_id;
-  if (page_table_->Find(page_id, frame_id)) {
-    disk_manager_->WritePage(page_id, pages_[frame_id].GetData());
-    pages_[frame_id].is_dirty_ = false;
-    latch_.unlock();
-    return true;
+  if (!page_table_->Find(page_id, frame_id)) {
+    return false;
   }
-  latch_.unlock();
-  return false;
+  FlushFrame(&lock, frame_id);
+  return true;
 }
 
 void BufferPoolManagerInstance::FlushAllPgsImp() {
-  latch_.lock();
-  for (size_t i = 0; i < pool_size_; i++) {
+  std::unique_lock<std::mutex> lock(latch_);
+  // Victims of a batch eviction are no longer in any frame's page id, wait until they are on disk.
+  while (!writing_back_.empty()) {
+    WaitForWriteBack(&lock, writing_back_.begin()->first);
+  }
+  // Frames that Resize() is draining may still hold dirty pages.
+  std::vector<frame_id_t> frame_ids;
+  for (size_t i = 0; i < arena_->GetNumFrames(); i++) {
     if (pages_[i].GetPageId() != INVALID_PAGE_ID) {
-      disk_manager_->WritePage(pages_[i].GetPageId(), pages_[i].GetData());
-      pages_[i].is_dirty_ = false;
+      frame_ids.push_back(static_cast<frame_id_t>(i));
     }
   }
-  latch_.unlock();
+  FlushFrames(&lock, frame_ids);
+  lock.unlock();
+  disk_manager_->Sync();
 }
 /**
  * TODO(P1): Add implementation
@@ -219,37 +370,816 @@ void BufferPoolManagerInstance::FlushAllPgsImp() {
  * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
  */
 auto BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) -> bool {
-  latch_.lock();
+  std::unique_lock<std::mutex> lock(latch_);
   frame_id_t frame_id;
-  // If page_id is not in the buffer pool, do nothing and return true
+  // An evicted copy that is still being written back would land on disk and in the victim cache after the page was
+  // freed, and show up in the page that reuses the id.
+  while (!page_table_->Find(page_id, frame_id) && writing_back_.count(page_id) != 0) {
+    WaitForWriteBack(&lock, page_id);
+  }
+  // If page_id is not in the buffer pool, free it on disk and return true. Only ids this instance handed out and
+  // that are not free yet; freeing any other id would let NewPage hand out a page that was never allocated.
   if (!page_table_->Find(page_id, frame_id)) {
-    latch_.unlock();
+    if (page_id < 0 || page_id >= next_page_id_ || disk_manager_->IsFreePage(page_id)) {
+      return true;
+    }
+    if (victim_cache_ != nullptr) {
+      victim_cache_->Erase(page_id);
+    }
+    DeallocatePage(page_id);
     return true;
   }
-  // If the page is pinned and cannot be deleted, return false immediately
-  if (pages_[frame_id].pin_count_ != 0) {
-    latch_.unlock();
+  // If the page is pinned and cannot be deleted, return false immediately. Delete it from the page table otherwise,
+  // unless a hit pins it in the meantime.
+  if (pages_[frame_id].pin_count_ != 0 || !DetachPage(frame_id)) {
     return false;
   }
 
   // reset metadata
   pages_[frame_id].ResetMemory();
   pages_[frame_id].page_id_ = INVALID_PAGE_ID;
-  pages_[frame_id].pin_count_ = 0;
   pages_[frame_id].is_dirty_ = false;
 
-  // delete from the page table;
-  page_table_->Remove(page_id);
-  // stop tracking the frame in the replacer
-  replacer_->Remove(frame_id);
-  // add the frame back to the free list.
-  free_list_.emplace_back(frame_id);
-  // Finally, you should call DeallocatePage() to imitate freeing the page on the disk.
+  // stop tracking the frame in the replacer, and add the frame back to the free list. A frame that Resize() is
+  // draining was made non-evictable and must not be reused.
+  if (static_cast<size_t>(frame_id) < pool_size_) {
+    replacer_->Remove(frame_id);
+    free_list_.emplace_back(frame_id);
+  } else {
+    replacer_->SetEvictable(frame_id, true);
+    replacer_->Remove(frame_id);
+  }
+  // Finally, free the page on disk so that its id can be reused.
   DeallocatePage(page_id);
-  latch_.unlock();
   return true;
 }
 
-auto BufferPoolManagerInstance::AllocatePage() -> page_id_t { return next_page_id_++; }
+auto BufferPoolManagerInstance::AcquireFrame(frame_id_t *frame_id, page_id_t *victim_page_id,
+                                             BufferAccessStrategy *strategy) -> bool {
+  frame_id_t ring_frame_id;
+  // The page leaves the page table first: a hit may still pin the frame until then, and make it non-evictable.
+  if (strategy != nullptr && CanRecycleRingFrame(strategy, &ring_frame_id) &&
+      EvictFrame(ring_frame_id, victim_page_id)) {
+    replacer_->Remove(ring_frame_id);
+    *frame_id = ring_frame_id;
+    stat_ring_reuses_++;
+    return true;
+  }
+  if (!free_list_.empty()) {
+    *frame_id = free_list_.front();
+    free_list_.pop_front();
+    return true;
+  }
+  // A frame whose page was hit meanwhile is non-evictable again, so this ends.
+  while (true) {
+    if (!replacer_->Evict(frame_id)) {
+      stat_no_frame_++;
+      return false;
+    }
+    if (EvictFrame(*frame_id, victim_page_id)) {
+      return true;
+    }
+  }
+}
+
+auto BufferPoolManagerInstance::CanRecycleRingFrame(BufferAccessStrategy *strategy, frame_id_t *frame_id) -> bool {
+  page_id_t ring_page_id;
+  if (!strategy->GetCurrent(instance_index_, frame_id, &ring_page_id)) {
+    return false;
+  }
+  // The frame may have been evicted and handed to somebody else since the strategy loaded it, or be drained by
+  // Resize(); leave it alone then.
+  return static_cast<size_t>(*frame_id) < pool_size_ && pages_[*frame_id].GetPageId() == ring_page_id &&
+         pages_[*frame_id].GetPinCount() == 0 && !frame_io_[*frame_id].in_progress_;
+}
+
+auto BufferPoolManagerInstance::EvictFrame(frame_id_t frame_id, page_id_t *victim_page_id) -> bool {
+  if (!DetachPage(frame_id)) {
+    return false;
+  }
+  stat_evictions_++;
+  Page &victim = pages_[frame_id];
+  if (victim.IsDirty() || victim_cache_ != nullptr) {
+    // Until the write-back finishes, a miss on the victim must wait instead of reading the stale copy on disk. A
+    // clean victim on its way to the victim cache is waited for as well; the miss then finds it there.
+    *victim_page_id = victim.GetPageId();
+    writing_back_[*victim_page_id] = frame_id;
+    frame_io_[frame_id].write_back_ = victim.IsDirty();
+  }
+  if (victim.IsDirty()) {
+    victim.is_dirty_ = false;
+    stat_write_backs_++;
+    // The cleaner did not keep up, give it a nudge.
+    if (page_cleaner_running_) {
+      page_cleaner_cv_.notify_one();
+    }
+  }
+  return true;
+}
+
+auto BufferPoolManagerInstance::DetachPage(frame_id_t frame_id) -> bool {
+  Page &page = pages_[frame_id];
+  page_table_->Remove(page.GetPageId());
+  // A hit pins the frame before it looks up the page again, so any hit that still gets the page shows up here.
+  if (page.GetPinCount() == 0) {
+    return true;
+  }
+  page_table_->Insert(page.GetPageId(), frame_id);
+  replacer_->RecordAccessAndPin(frame_id, page.GetPageId());
+  return false;
+}
+
+void BufferPoolManagerInstance::InstallPage(page_id_t page_id, frame_id_t frame_id) {
+  pages_[frame_id].page_id_ = page_id;
+  pages_[frame_id].pin_count_++;
+  // Concurrent fetchers of this page find it in the page table and wait on the frame until the I/O is done.
+  frame_io_[frame_id].in_progress_ = true;
+  page_table_->Insert(page_id, frame_id);
+  replacer_->RecordAccessAndPin(frame_id, page_id);
+}
+
+void BufferPoolManagerInstance::ReadIntoFrame(std::unique_lock<std::mutex> *lock, page_id_t page_id,
+                                              frame_id_t frame_id, page_id_t victim_page_id) {
+  // Do the I/O without holding the latch; only fetchers of this page wait for it.
+  InstallPage(page_id, frame_id);
+  lock->unlock();
+  if (victim_page_id != INVALID_PAGE_ID) {
+    WriteBack(victim_page_id, frame_id);
+  }
+  pages_[frame_id].ResetMemory();
+  ReadPageData(page_id, pages_[frame_id].data_);
+  lock->lock();
+  FinishIO(victim_page_id, frame_id);
+}
+
+void BufferPoolManagerInstance::WriteBack(page_id_t victim_page_id, frame_id_t frame_id) {
+  if (frame_io_[frame_id].write_back_) {
+    disk_manager_->WritePage(victim_page_id, pages_[frame_id].GetData());
+  }
+  if (victim_cache_ != nullptr) {
+    victim_cache_->Insert(victim_page_id, pages_[frame_id].GetData());
+  }
+}
+
+void BufferPoolManagerInstance::ReadPageData(page_id_t page_id, char *data) {
+  if (victim_cache_ != nullptr && victim_cache_->Lookup(page_id, data)) {
+    return;
+  }
+  disk_manager_->ReadPage(page_id, data);
+}
+
+void BufferPoolManagerInstance::LoadFrames(const std::vector<FrameLoad> &loads) {
+  // A victim has to be out of its frame before the new page is read over it.
+  std::vector<std::pair<const FrameLoad *, std::future<bool>>> writes;
+  for (const auto &load : loads) {
+    if (load.victim_page_id_ != INVALID_PAGE_ID && frame_io_[load.frame_id_].write_back_) {
+      writes.emplace_back(&load, disk_manager_->WritePageAsync(load.victim_page_id_, pages_[load.frame_id_].GetData()));
+    }
+  }
+  for (auto &[load, write] : writes) {
+    if (write.get()) {
+      continue;
+    }
+    // The frame keeps the victim for one more, synchronous try; after that it is lost like on the synchronous path.
+    stat_io_errors_++;
+    uint64_t errors = DiskManager::GetThreadIOErrors();
+    disk_manager_->WritePage(load->victim_page_id_, pages_[load->frame_id_].GetData());
+    if (DiskManager::GetThreadIOErrors() != errors) {
+      stat_io_errors_++;
+      LOG_WARN("cannot write back page %d", load->victim_page_id_);
+    }
+  }
+  std::vector<std::future<bool>> reads;
+  for (const auto &load : loads) {
+    Page &page = pages_[load.frame_id_];
+    if (load.victim_page_id_ != INVALID_PAGE_ID && victim_cache_ != nullptr) {
+      victim_cache_->Insert(load.victim_page_id_, page.GetData());
+    }
+    page.ResetMemory();
+    if (victim_cache_ == nullptr || !victim_cache_->Lookup(load.page_id_, page.data_)) {
+      reads.push_back(disk_manager_->ReadPageAsync(load.page_id_, page.data_));
+    }
+  }
+  for (auto &read : reads) {
+    if (!read.get()) {
+      stat_io_errors_++;
+    }
+  }
+}
+
+void BufferPoolManagerInstance::WaitForWriteBack(std::unique_lock<std::mutex> *lock, page_id_t page_id) {
+  frame_id_t writer = writing_back_.at(page_id);
+  // Once the wait is over, the page may have been fetched and evicted again by another frame, whose FinishIO() would
+  // not wake us up.
+  frame_io_[writer].cv_.wait(*lock, [&] {
+    auto it = writing_back_.find(page_id);
+    return it == writing_back_.end() || it->second != writer;
+  });
+}
+
+void BufferPoolManagerInstance::FinishIO(page_id_t victim_page_id, frame_id_t frame_id) {
+  if (victim_page_id != INVALID_PAGE_ID) {
+    writing_back_.erase(victim_page_id);
+  }
+  frame_io_[frame_id].in_progress_ = false;
+  frame_io_[frame_id].cv_.notify_all();
+}
+
+void BufferPoolManagerInstance::FlushFrame(std::unique_lock<std::mutex> *lock, frame_id_t frame_id) {
+  Page &page = pages_[frame_id];
+  // Pin the frame for the duration of the write so that it cannot be evicted or deleted underneath us.
+  page.pin_count_++;
+  replacer_->SetEvictable(frame_id, false);
+  frame_io_[frame_id].cv_.wait(*lock, [&] { return !frame_io_[frame_id].in_progress_; });
+  // Clear the dirty flag before writing: an UnpinPage(dirty) that races with the write sets it again.
+  page.is_dirty_ = false;
+  page_id_t page_id = page.GetPageId();
+  lock->unlock();
+  disk_manager_->WritePage(page_id, page.GetData());
+  lock->lock();
+  if (--page.pin_count_ == 0) {
+    ReleaseFrame(frame_id);
+  }
+}
+
+void BufferPoolManagerInstance::FlushFrames(std::unique_lock<std::mutex> *lock,
+                                            const std::vector<frame_id_t> &frame_ids) {
+  // Same as FlushFrame(), for all frames at once. A pinned frame cannot start another I/O, so once every wait is
+  // over, none of the frames is busy.
+  for (auto frame_id : frame_ids) {
+    pages_[frame_id].pin_count_++;
+    replacer_->SetEvictable(frame_id, false);
+  }
+  for (auto frame_id : frame_ids) {
+    frame_io_[frame_id].cv_.wait(*lock, [&] { return !frame_io_[frame_id].in_progress_; });
+  }
+  std::vector<page_id_t> page_ids;
+  for (auto frame_id : frame_ids) {
+    pages_[frame_id].is_dirty_ = false;
+    page_ids.push_back(pages_[frame_id].GetPageId());
+  }
+  lock->unlock();
+  std::vector<std::future<bool>> writes;
+  for (size_t i = 0; i < frame_ids.size(); i++) {
+    writes.push_back(disk_manager_->WritePageAsync(page_ids[i], pages_[frame_ids[i]].GetData()));
+  }
+  std::vector<bool> written;
+  for (auto &write : writes) {
+    written.push_back(write.get());
+  }
+  lock->lock();
+  for (size_t i = 0; i < frame_ids.size(); i++) {
+    frame_id_t frame_id = frame_ids[i];
+    if (!written[i]) {
+      // The page still differs from the disk, a later flush or eviction tries again.
+      stat_io_errors_++;
+      pages_[frame_id].is_dirty_ = true;
+    }
+    if (--pages_[frame_id].pin_count_ == 0) {
+      ReleaseFrame(frame_id);
+    }
+  }
+}
+
+void BufferPoolManagerInstance::ReleaseFrame(frame_id_t frame_id) {
+  if (static_cast<size_t>(frame_id) >= pool_size_) {
+    // Resize() evicts the page itself.
+    resize_cv_.notify_all();
+    return;
+  }
+  replacer_->SetEvictable(frame_id, true);
+}
+
+auto BufferPoolManagerInstance::Resize(size_t new_size) -> bool {
+  std::unique_lock<std::mutex> lock(latch_);
+  if (new_size == 0 || new_size > max_pool_size_ || resizing_) {
+    return false;
+  }
+  size_t old_size = pool_size_;
+  if (new_size >= old_size) {
+    arena_->Resize(new_size);
+    for (size_t i = old_size; i < new_size; i++) {
+      free_list_.emplace_back(static_cast<frame_id_t>(i));
+    }
+    pool_size_ = new_size;
+    return true;
+  }
+
+  // From here on, no page is loaded into the frames to be dropped, and their last unpin wakes us up instead of making
+  // them evictable.
+  resizing_ = true;
+  pool_size_ = new_size;
+  free_list_.remove_if([&](frame_id_t frame_id) { return static_cast<size_t>(frame_id) >= new_size; });
+  for (size_t i = new_size; i < old_size; i++) {
+    replacer_->SetEvictable(static_cast<frame_id_t>(i), false);
+  }
+  DrainFrames(&lock, new_size, old_size);
+  arena_->Resize(new_size);
+  resizing_ = false;
+  return true;
+}
+
+void BufferPoolManagerInstance::DrainFrames(std::unique_lock<std::mutex> *lock, size_t new_size, size_t old_size) {
+  while (true) {
+    bool drained = true;
+    for (size_t i = new_size; i < old_size; i++) {
+      auto frame_id = static_cast<frame_id_t>(i);
+      Page &page = pages_[frame_id];
+      // A frame of a batch eviction has already forgotten its page while the write-back is in progress.
+      if (page.GetPinCount() > 0 || frame_io_[frame_id].in_progress_) {
+        drained = false;
+        continue;
+      }
+      if (page.GetPageId() == INVALID_PAGE_ID) {
+        continue;
+      }
+      replacer_->SetEvictable(frame_id, true);
+      replacer_->Remove(frame_id);
+      page_id_t victim_page_id = INVALID_PAGE_ID;
+      if (!EvictFrame(frame_id, &victim_page_id)) {
+        drained = false;
+        continue;
+      }
+      // Forget the page before the latch is dropped, so that FlushAllPgsImp() leaves the frame alone.
+      page.page_id_ = INVALID_PAGE_ID;
+      if (victim_page_id != INVALID_PAGE_ID) {
+        frame_io_[frame_id].in_progress_ = true;
+        lock->unlock();
+        WriteBack(victim_page_id, frame_id);
+        lock->lock();
+        FinishIO(victim_page_id, frame_id);
+      }
+    }
+    if (drained) {
+      return;
+    }
+    resize_cv_.wait(*lock);
+  }
+}
+
+void BufferPoolManagerInstance::PrefetchPages(page_id_t first_page_id, size_t count,
+                                              std::shared_ptr<BufferAccessStrategy> strategy) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (prefetch_thread_ == nullptr) {
+    prefetch_running_ = true;
+    prefetch_thread_ = new std::thread(&BufferPoolManagerInstance::PrefetchLoop, this);
+  }
+  // Prefetching more than the pool can hold would only evict what was prefetched before.
+  for (size_t i = 0; i < count && prefetch_queue_.size() < pool_size_; i++) {
+    prefetch_queue_.emplace_back(first_page_id + static_cast<page_id_t>(i), strategy);
+  }
+  prefetch_cv_.notify_one();
+}
+
+void BufferPoolManagerInstance::StopPrefetcher() {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (prefetch_thread_ == nullptr) {
+      return;
+    }
+    prefetch_running_ = false;
+    prefetch_cv_.notify_one();
+  }
+  prefetch_thread_->join();
+  delete prefetch_thread_;
+  prefetch_thread_ = nullptr;
+}
+
+void BufferPoolManagerInstance::PrefetchLoop() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    prefetch_cv_.wait(lock, [&] { return !prefetch_running_ || !prefetch_queue_.empty(); });
+    if (!prefetch_running_) {
+      return;
+    }
+    // Read what is queued, up to a full queue depth, with one round of asynchronous requests.
+    std::vector<FrameLoad> loads;
+    while (!prefetch_queue_.empty() && loads.size() < static_cast<size_t>(ASYNC_IO_QUEUE_DEPTH)) {
+      auto [page_id, strategy] = std::move(prefetch_queue_.front());
+      prefetch_queue_.pop_front();
+      StartPrefetch(&lock, page_id, strategy.get(), &loads);
+    }
+    if (loads.empty()) {
+      continue;
+    }
+    lock.unlock();
+    LoadFrames(loads);
+    lock.lock();
+    for (const auto &load : loads) {
+      FinishIO(load.victim_page_id_, load.frame_id_);
+      // Nobody asked for the page yet, leave it evictable.
+      if (--pages_[load.frame_id_].pin_count_ == 0) {
+        ReleaseFrame(load.frame_id_);
+      }
+    }
+  }
+}
+
+void BufferPoolManagerInstance::StartPrefetch(std::unique_lock<std::mutex> *lock, page_id_t page_id,
+                                              BufferAccessStrategy *strategy, std::vector<FrameLoad> *loads) {
+  // Pages that were never allocated, or were deleted, must not enter the page table, NewPage would hand out the same
+  // id later.
+  if (page_id < 0 || page_id >= next_page_id_ ||
+      page_id % static_cast<page_id_t>(num_instances_) != static_cast<page_id_t>(instance_index_) ||
+      disk_manager_->IsFreePage(page_id)) {
+    return;
+  }
+  if (NeedsBatchEviction()) {
+    EvictBatch(lock);
+  }
+  frame_id_t frame_id;
+  if (page_table_->Find(page_id, frame_id) || writing_back_.count(page_id) != 0) {
+    return;
+  }
+  bool has_frame = strategy != nullptr ? CanRecycleRingFrame(strategy, &frame_id) : replacer_->Size() > 0;
+  if (free_list_.empty() && !has_frame) {
+    return;
+  }
+  page_id_t victim_page_id = INVALID_PAGE_ID;
+  if (!AcquireFrame(&frame_id, &victim_page_id, strategy)) {
+    return;
+  }
+  stat_prefetches_++;
+  if (strategy != nullptr) {
+    strategy->Put(instance_index_, frame_id, page_id);
+  }
+  InstallPage(page_id, frame_id);
+  loads->push_back({page_id, frame_id, victim_page_id});
+}
+
+void BufferPoolManagerInstance::RunPageCleaner(size_t low_watermark, size_t high_watermark) {
+  BUSTUB_ASSERT(low_watermark <= high_watermark, "low watermark must not exceed high watermark");
+  std::scoped_lock<std::mutex> lock(latch_);
+  cleaner_low_watermark_ = low_watermark;
+  cleaner_high_watermark_ = high_watermark;
+  if (page_cleaner_thread_ != nullptr) {
+    return;
+  }
+  page_cleaner_running_ = true;
+  page_cleaner_thread_ = new std::thread(&BufferPoolManagerInstance::PageCleanerLoop, this);
+}
+
+void BufferPoolManagerInstance::StopPageCleaner() {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (page_cleaner_thread_ == nullptr) {
+      return;
+    }
+    page_cleaner_running_ = false;
+    page_cleaner_cv_.notify_one();
+  }
+  page_cleaner_thread_->join();
+  delete page_cleaner_thread_;
+  page_cleaner_thread_ = nullptr;
+}
+
+void BufferPoolManagerInstance::PageCleanerLoop() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (page_cleaner_running_) {
+    CleanFrames(&lock);
+    page_cleaner_cv_.wait_for(lock, page_cleaner_interval);
+  }
+}
+
+void BufferPoolManagerInstance::CleanFrames(std::unique_lock<std::mutex> *lock) {
+  size_t ready = free_list_.size();
+  if (ready >= cleaner_low_watermark_) {
+    return;
+  }
+  std::vector<std::pair<page_id_t, frame_id_t>> dirty;
+  for (auto frame_id : replacer_->GetEvictionCandidates(cleaner_high_watermark_)) {
+    if (pages_[frame_id].IsDirty()) {
+      dirty.emplace_back(pages_[frame_id].GetPageId(), frame_id);
+    } else {
+      ready++;
+    }
+  }
+  if (ready >= cleaner_low_watermark_) {
+    return;
+  }
+  // Page-id order turns the write-backs into a mostly sequential pass over the file.
+  std::sort(dirty.begin(), dirty.end());
+  std::vector<frame_id_t> frame_ids;
+  for (const auto &[page_id, frame_id] : dirty) {
+    Page &page = pages_[frame_id];
+    if (page.GetPinCount() == 0 && !frame_io_[frame_id].in_progress_) {
+      frame_ids.push_back(frame_id);
+    }
+  }
+  FlushFrames(lock, frame_ids);
+  stat_background_write_backs_ += frame_ids.size();
+}
+
+void BufferPoolManagerInstance::EnableBatchEviction(size_t low_watermark, size_t batch_size) {
+  BUSTUB_ASSERT(low_watermark == 0 || batch_size > 0, "batch size must be positive");
+  std::scoped_lock<std::mutex> lock(latch_);
+  batch_low_watermark_ = low_watermark;
+  batch_size_ = batch_size;
+}
+
+auto BufferPoolManagerInstance::NeedsBatchEviction() -> bool {
+  return free_list_.size() < batch_low_watermark_ && !evicting_batch_ && replacer_->Size() > 0;
+}
+
+void BufferPoolManagerInstance::EvictBatch(std::unique_lock<std::mutex> *lock) {
+  stat_eviction_batches_++;
+  evicting_batch_ = true;
+  std::vector<std::pair<page_id_t, frame_id_t>> victims;
+  frame_id_t frame_id;
+  for (size_t i = 0; i < batch_size_ && replacer_->Evict(&frame_id); i++) {
+    page_id_t victim_page_id = INVALID_PAGE_ID;
+    if (!EvictFrame(frame_id, &victim_page_id)) {
+      continue;
+    }
+    // Forget the page before the latch is dropped, so that FlushAllPgsImp() and Resize() leave the frame alone.
+    pages_[frame_id].page_id_ = INVALID_PAGE_ID;
+    if (victim_page_id == INVALID_PAGE_ID) {
+      free_list_.emplace_back(frame_id);
+      continue;
+    }
+    frame_io_[frame_id].in_progress_ = true;
+    victims.emplace_back(victim_page_id, frame_id);
+  }
+  if (victims.empty()) {
+    evicting_batch_ = false;
+    return;
+  }
+
+  // Page-id order lets consecutive dirty pages go out in one request, and the runs in one pass over the file.
+  std::sort(victims.begin(), victims.end());
+  lock->unlock();
+  auto is_dirty = [&](size_t i) { return frame_io_[victims[i].second].write_back_; };
+  std::vector<const char *> run;
+  for (size_t begin = 0, end = 0; begin < victims.size(); begin = end) {
+    if (!is_dirty(begin)) {
+      end++;
+      continue;
+    }
+    run.clear();
+    while (end < victims.size() && is_dirty(end) &&
+           victims[end].first == victims[begin].first + static_cast<page_id_t>(end - begin)) {
+      run.push_back(pages_[victims[end].second].GetData());
+      end++;
+    }
+    disk_manager_->WritePages(victims[begin].first, run.data(), run.size());
+    stat_batch_writes_++;
+  }
+  if (victim_cache_ != nullptr) {
+    for (const auto &[victim_page_id, victim_frame_id] : victims) {
+      victim_cache_->Insert(victim_page_id, pages_[victim_frame_id].GetData());
+    }
+  }
+  lock->lock();
+  for (const auto &[victim_page_id, victim_frame_id] : victims) {
+    FinishIO(victim_page_id, victim_frame_id);
+    // Resize() may have shrunk the pool meanwhile.
+    if (static_cast<size_t>(victim_frame_id) < pool_size_) {
+      free_list_.emplace_back(victim_frame_id);
+    }
+  }
+  evicting_batch_ = false;
+  if (resizing_) {
+    resize_cv_.notify_all();
+  }
+}
+
+void BufferPoolManagerInstance::EnableVictimCache(size_t capacity_bytes) {
+  BUSTUB_ASSERT(victim_cache_ == nullptr, "the victim cache is enabled already");
+  victim_cache_ = std::make_unique<CompressedPageCache>(capacity_bytes);
+}
+
+auto BufferPoolManagerInstance::GetVictimCacheStats() -> CompressedPageCacheStats {
+  return victim_cache_ == nullptr ? CompressedPageCacheStats{} : victim_cache_->GetStats();
+}
+
+auto BufferPoolManagerInstance::SaveHotSet(const std::string &path) -> bool {
+  std::vector<HotPage> hot_pages;
+  page_id_t next_page_id;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    next_page_id = next_page_id_;
+    for (size_t i = 0; i < pool_size_; i++) {
+      auto frame_id = static_cast<frame_id_t>(i);
+      if (pages_[frame_id].GetPageId() != INVALID_PAGE_ID) {
+        hot_pages.push_back({pages_[frame_id].GetPageId(), replacer_->GetAccessHistory(frame_id)});
+      }
+    }
+  }
+
+  // Write a new file and rename it, so that a crash never leaves a torn hot set behind.
+  std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::trunc);
+    out << "bustub-hot-set 1\n" << num_instances_ << ' ' << instance_index_ << ' ' << next_page_id << '\n';
+    for (const auto &hot_page : hot_pages) {
+      out << hot_page.page_id_ << ' ' << hot_page.history_.size();
+      for (auto timestamp : hot_page.history_) {
+        out << ' ' << timestamp;
+      }
+      out << '\n';
+    }
+    if (!out.good()) {
+      LOG_WARN("cannot write hot set file %s", tmp_path.c_str());
+      return false;
+    }
+  }
+  return std::rename(tmp_path.c_str(), path.c_str()) == 0;
+}
+
+void BufferPoolManagerInstance::RunHotSetDumper(const std::string &path) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (hot_set_dumper_thread_ != nullptr) {
+    return;
+  }
+  hot_set_path_ = path;
+  hot_set_dumper_running_ = true;
+  hot_set_dumper_thread_ = new std::thread(&BufferPoolManagerInstance::HotSetDumperLoop, this);
+}
+
+void BufferPoolManagerInstance::StopHotSetDumper() {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (hot_set_dumper_thread_ == nullptr) {
+      return;
+    }
+    hot_set_dumper_running_ = false;
+    hot_set_dumper_cv_.notify_one();
+  }
+  hot_set_dumper_thread_->join();
+  delete hot_set_dumper_thread_;
+  hot_set_dumper_thread_ = nullptr;
+}
+
+void BufferPoolManagerInstance::HotSetDumperLoop() {
+  std::unique_lock<std::mutex> lock(latch_);
+  bool running = true;
+  while (running) {
+    hot_set_dumper_cv_.wait_for(lock, hot_set_dump_interval, [&] { return !hot_set_dumper_running_; });
+    running = hot_set_dumper_running_;
+    lock.unlock();
+    SaveHotSet(hot_set_path_);
+    lock.lock();
+  }
+}
+
+auto BufferPoolManagerInstance::WarmUp(const std::string &path, bool background) -> size_t {
+  std::ifstream in(path);
+  std::string magic;
+  int version;
+  uint32_t num_instances;
+  uint32_t instance_index;
+  page_id_t next_page_id;
+  if (!(in >> magic >> version >> num_instances >> instance_index >> next_page_id) || magic != "bustub-hot-set" ||
+      version != 1 || num_instances != num_instances_ || instance_index != instance_index_) {
+    LOG_WARN("cannot warm up from %s", path.c_str());
+    return 0;
+  }
+  std::vector<HotPage> hot_pages;
+  page_id_t page_id;
+  size_t history_size;
+  while (in >> page_id >> history_size) {
+    HotPage hot_page{page_id, std::vector<uint64_t>(history_size)};
+    for (auto &timestamp : hot_page.history_) {
+      in >> timestamp;
+    }
+    if (page_id >= 0 && page_id % static_cast<page_id_t>(num_instances_) == static_cast<page_id_t>(instance_index_)) {
+      hot_pages.push_back(std::move(hot_page));
+    }
+  }
+
+  std::unique_lock<std::mutex> lock(latch_);
+  if (warm_up_thread_ != nullptr) {
+    return 0;
+  }
+  // The saved pages exist on disk; NewPage must not hand out their ids again.
+  page_id_t current = next_page_id_;
+  while (current < next_page_id && !next_page_id_.compare_exchange_weak(current, next_page_id)) {
+  }
+  // Keep the most recently used pages that fit into the free frames. Pages without history go last.
+  if (hot_pages.size() > free_list_.size()) {
+    auto last_access = [](const HotPage &page) { return page.history_.empty() ? 0 : page.history_.back() + 1; };
+    std::sort(hot_pages.begin(), hot_pages.end(),
+              [&](const HotPage &a, const HotPage &b) { return last_access(a) > last_access(b); });
+    hot_pages.resize(free_list_.size());
+  }
+  std::sort(hot_pages.begin(), hot_pages.end(),
+            [](const HotPage &a, const HotPage &b) { return a.page_id_ < b.page_id_; });
+  size_t num_pages = hot_pages.size();
+  if (background) {
+    warm_up_thread_ = new std::thread([this, hot_pages = std::move(hot_pages)] { LoadHotSet(hot_pages); });
+    return num_pages;
+  }
+  lock.unlock();
+  return LoadHotSet(hot_pages);
+}
+
+void BufferPoolManagerInstance::WaitForWarmUp() {
+  std::thread *warm_up_thread;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    warm_up_thread = warm_up_thread_;
+  }
+  if (warm_up_thread == nullptr) {
+    return;
+  }
+  warm_up_thread->join();
+  std::scoped_lock<std::mutex> lock(latch_);
+  delete warm_up_thread_;
+  warm_up_thread_ = nullptr;
+}
+
+auto BufferPoolManagerInstance::LoadHotSet(const std::vector<HotPage> &hot_pages) -> size_t {
+  size_t loaded = 0;
+  std::vector<std::pair<page_id_t, frame_id_t>> chunk;
+  std::vector<char *> run;
+  std::unique_lock<std::mutex> lock(latch_);
+  for (size_t begin = 0; begin < hot_pages.size() && !free_list_.empty(); begin += WARM_UP_CHUNK_PAGES) {
+    // Queries may have brought some of the pages in, or taken free frames, since WarmUp() looked.
+    chunk.clear();
+    for (size_t i = begin; i < std::min<size_t>(begin + WARM_UP_CHUNK_PAGES, hot_pages.size()); i++) {
+      page_id_t page_id = hot_pages[i].page_id_;
+      frame_id_t frame_id;
+      if (page_table_->Find(page_id, frame_id) || writing_back_.count(page_id) != 0 ||
+          disk_manager_->IsFreePage(page_id)) {
+        continue;
+      }
+      if (free_list_.empty()) {
+        break;
+      }
+      frame_id = free_list_.front();
+      free_list_.pop_front();
+      pages_[frame_id].page_id_ = page_id;
+      pages_[frame_id].pin_count_++;
+      frame_io_[frame_id].in_progress_ = true;
+      page_table_->Insert(page_id, frame_id);
+      replacer_->RestoreAccessHistory(frame_id, page_id, hot_pages[i].history_);
+      chunk.emplace_back(page_id, frame_id);
+    }
+
+    lock.unlock();
+    for (size_t run_begin = 0, run_end = 0; run_begin < chunk.size(); run_begin = run_end) {
+      run.clear();
+      while (run_end < chunk.size() &&
+             chunk[run_end].first == chunk[run_begin].first + static_cast<page_id_t>(run_end - run_begin)) {
+        run.push_back(pages_[chunk[run_end].second].data_);
+        run_end++;
+      }
+      disk_manager_->ReadPages(chunk[run_begin].first, run.data(), run.size());
+    }
+    lock.lock();
+    for (const auto &[page_id, frame_id] : chunk) {
+      FinishIO(INVALID_PAGE_ID, frame_id);
+      if (--pages_[frame_id].pin_count_ == 0) {
+        ReleaseFrame(frame_id);
+      }
+    }
+    loaded += chunk.size();
+    stat_warm_up_pages_ += chunk.size();
+  }
+  return loaded;
+}
+
+auto BufferPoolManagerInstance::AllocatePage(page_id_t hint, bool *reused) -> page_id_t {
+  page_id_t page_id = disk_manager_->ReusePage(hint, num_instances_, instance_index_);
+  *reused = page_id != INVALID_PAGE_ID;
+  if (*reused) {
+    stat_reused_pages_++;
+    // The free page map outlives the buffer pool, the page may lie beyond the ids this instance handed out so far.
+    page_id_t current = next_page_id_;
+    const page_id_t next_page_id = page_id + static_cast<page_id_t>(num_instances_);
+    while (current < next_page_id && !next_page_id_.compare_exchange_weak(current, next_page_id)) {
+    }
+    ValidatePageId(page_id);
+    return page_id;
+  }
+  const page_id_t next_page_id = next_page_id_.fetch_add(static_cast<page_id_t>(num_instances_));
+  ValidatePageId(next_page_id);
+  return next_page_id;
+}
+
+void BufferPoolManagerInstance::ValidatePageId(const page_id_t page_id) const {
+  // allocated pages mod back to this BPI
+  BUSTUB_ASSERT(page_id % static_cast<page_id_t>(num_instances_) == static_cast<page_id_t>(instance_index_),
+                "page id does not belong to this BPI");
+}
+
+auto BufferPoolManagerInstance::GetStats() const -> BufferPoolStats {
+  BufferPoolStats stats;
+  stats.hits_ = stat_hits_.load();
+  stats.misses_ = stat_misses_.load();
+  stats.new_pages_ = stat_new_pages_.load();
+  stats.evictions_ = stat_evictions_.load();
+  stats.write_backs_ = stat_write_backs_.load();
+  stats.background_write_backs_ = stat_background_write_backs_.load();
+  stats.prefetches_ = stat_prefetches_.load();
+  stats.ring_reuses_ = stat_ring_reuses_.load();
+  stats.no_frame_ = stat_no_frame_.load();
+  stats.eviction_batches_ = stat_eviction_batches_.load();
+  stats.batch_writes_ = stat_batch_writes_.load();
+  stats.warm_up_pages_ = stat_warm_up_pages_.load();
+  stats.reused_pages_ = stat_reused_pages_.load();
+  stats.io_errors_ = stat_io_errors_.load();
+  return stats;
+}
 
 }  // namespace bustub
@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache.cpp
+//
+// Identification: src/buffer/compressed_page_cache.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/compressed_page_cache.h"
+
+#include <iterator>
+#include <utility>
+
+#include "common/util/lz_compressor.h"
+
+namespace bustub {
+
+CompressedPageCache::CompressedPageCache(size_t capacity_bytes) : capacity_bytes_(capacity_bytes) {}
+
+void CompressedPageCache::Insert(page_id_t page_id, const char *data) {
+  std::vector<char> compressed(MAX_COMPRESSED_SIZE);
+  size_t size = LZCompressor::Compress(data, BUSTUB_PAGE_SIZE, compressed.data(), compressed.size());
+  compressed.resize(size);
+  compressed.shrink_to_fit();
+
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto it = index_.find(page_id);
+  if (it != index_.end()) {
+    EraseLocked(it->second);
+  }
+  if (size == 0 || size > capacity_bytes_) {
+    stats_.rejects_++;
+    return;
+  }
+  while (stats_.bytes_ + size > capacity_bytes_) {
+    EraseLocked(std::prev(entries_.end()));
+    stats_.evictions_++;
+  }
+  entries_.emplace_front(page_id, std::move(compressed));
+  index_[page_id] = entries_.begin();
+  stats_.inserts_++;
+  stats_.uncompressed_bytes_ += BUSTUB_PAGE_SIZE;
+  stats_.compressed_bytes_ += size;
+  stats_.pages_++;
+  stats_.bytes_ += size;
+}
+
+auto CompressedPageCache::Lookup(page_id_t page_id, char *data) -> bool {
+  std::vector<char> compressed;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    auto it = index_.find(page_id);
+    if (it == index_.end()) {
+      stats_.misses_++;
+      return false;
+    }
+    stats_.hits_++;
+    compressed = EraseLocked(it->second);
+  }
+  // Should the data ever be damaged, the caller still finds the page on disk.
+  return LZCompressor::Decompress(compressed.data(), compressed.size(), data, BUSTUB_PAGE_SIZE) == BUSTUB_PAGE_SIZE;
+}
+
+void CompressedPageCache::Erase(page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto it = index_.find(page_id);
+  if (it != index_.end()) {
+    EraseLocked(it->second);
+  }
+}
+
+auto CompressedPageCache::GetStats() -> CompressedPageCacheStats {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return stats_;
+}
+
+auto CompressedPageCache::EraseLocked(EntryList::iterator it) -> std::vector<char> {
+  std::vector<char> compressed = std::move(it->second);
+  stats_.pages_--;
+  stats_.bytes_ -= compressed.size();
+  index_.erase(it->first);
+  entries_.erase(it);
+  return compressed;
+}
+
+}  // namespace bustub
@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.cpp
+//
+// Identification: src/buffer/frame_arena.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_arena.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <memory>
+#include <new>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+namespace {
+auto RoundUp(size_t size, size_t multiple) -> size_t { return (size + multiple - 1) / multiple * multiple; }
+}  // namespace
+
+FrameArena::FrameArena(size_t num_frames, bool use_huge_pages, size_t max_frames)
+    : num_frames_(num_frames), max_frames_(max_frames == 0 ? num_frames : max_frames) {
+  BUSTUB_ASSERT(num_frames_ <= max_frames_, "arena cannot hold more than max_frames frames");
+  size_t data_size = max_frames_ * BUSTUB_PAGE_SIZE;
+  if (data_size > 0) {
+    if (use_huge_pages && data_size >= HUGE_PAGE_SIZE) {
+      mapped_size_ = RoundUp(data_size, HUGE_PAGE_SIZE);
+#ifdef MAP_HUGETLB
+      // hugetlb pages are reserved for the whole mapping and not given back by Resize(), so only a pool that cannot
+      // grow gets them.
+      if (max_frames_ == num_frames_) {
+        void *addr =
+            mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (addr != MAP_FAILED) {
+          data_ = static_cast<char *>(addr);
+          backing_ = Backing::HUGETLB;
+        }
+      }
+#endif
+      // No huge pages reserved: ask for transparent huge pages, which only back huge-page-aligned ranges.
+      if (data_ == nullptr && MapAligned(mapped_size_, HUGE_PAGE_SIZE)) {
+#ifdef MADV_HUGEPAGE
+        if (madvise(data_, mapped_size_, MADV_HUGEPAGE) == 0) {
+          backing_ = Backing::TRANSPARENT_HUGE_PAGES;
+        }
+#endif
+      }
+    } else {
+      mapped_size_ = RoundUp(data_size, static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+      MapAligned(mapped_size_, 1);
+    }
+    if (data_ == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot map the buffer pool frames");
+    }
+  }
+
+  // The mapping is zeroed, so the pages need no ResetMemory() here and the region is only faulted in when used.
+  pages_ = std::allocator<Page>().allocate(max_frames_);
+  for (size_t i = 0; i < num_frames_; i++) {
+    new (&pages_[i]) Page(data_ + i * BUSTUB_PAGE_SIZE);
+  }
+}
+
+FrameArena::~FrameArena() {
+  std::destroy_n(pages_, num_frames_);
+  std::allocator<Page>().deallocate(pages_, max_frames_);
+  if (data_ != nullptr) {
+    munmap(data_, mapped_size_);
+  }
+}
+
+void FrameArena::Resize(size_t num_frames) {
+  BUSTUB_ASSERT(num_frames <= max_frames_, "arena cannot hold more than max_frames frames");
+  for (size_t i = num_frames_; i < num_frames; i++) {
+    new (&pages_[i]) Page(data_ + i * BUSTUB_PAGE_SIZE);
+  }
+  if (num_frames < num_frames_) {
+    std::destroy(pages_ + num_frames, pages_ + num_frames_);
+    // Hand the memory back. This only works on whole OS pages and fails on hugetlb pages; the frames are reset before
+    // they are used again anyway.
+    auto os_page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t begin = RoundUp(num_frames * BUSTUB_PAGE_SIZE, os_page_size);
+    size_t end = num_frames_ * BUSTUB_PAGE_SIZE;
+    if (backing_ != Backing::HUGETLB && begin < end) {
+      madvise(data_ + begin, end - begin, MADV_DONTNEED);
+    }
+  }
+  num_frames_ = num_frames;
+}
+
+auto FrameArena::BackingToString(Backing backing) -> const char * {
+  switch (backing) {
+    case Backing::REGULAR:
+      return "regular pages";
+    case Backing::TRANSPARENT_HUGE_PAGES:
+      return "transparent huge pages";
+    case Backing::HUGETLB:
+      return "hugetlb pages";
+  }
+  return "unknown";
+}
+
+auto FrameArena::MapAligned(size_t size, size_t alignment) -> bool {
+  // Over-map by the alignment and give back the unaligned head and the tail.
+  size_t extra = alignment > 1 ? alignment : 0;
+  void *addr = mmap(nullptr, size + extra, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (addr == MAP_FAILED) {
+    return false;
+  }
+  auto start = reinterpret_cast<uintptr_t>(addr);
+  auto aligned = extra > 0 ? RoundUp(start, alignment) : start;
+  if (aligned > start) {
+    munmap(addr, aligned - start);
+  }
+  if (start + extra > aligned) {
+    munmap(reinterpret_cast<void *>(aligned + size), start + extra - aligned);
+  }
+  data_ = reinterpret_cast<char *>(aligned);
+  return true;
+}
+
+}  // namespace bustub
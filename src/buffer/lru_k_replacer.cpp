@@ -12,108 +12,187 @@
 
 #include "buffer/lru_k_replacer.h"
 
+#include <algorithm>
+
 namespace bustub {
-FrameInfo::FrameInfo(size_t k, frame_id_t frame_id) : k_{k}, frame_id_{frame_id}, accesses_(0) {}
-auto FrameInfo::HasK() -> bool { return accesses_.size() == k_; }
-auto FrameInfo::IsEvictable() -> bool { return is_evictable_; }
-auto FrameInfo::SetEvictable(bool set_evictable) -> void { is_evictable_ = set_evictable; }
-auto FrameInfo::GetBack() -> size_t { return accesses_.back(); }
-auto FrameInfo::PopFront() -> void { accesses_.pop_front(); }
-auto FrameInfo::PushBack(size_t access) -> void { accesses_.push_back(access); }
-auto FrameInfo::GetSize() -> size_t { return accesses_.size(); }
-auto FrameInfo::GetId() -> frame_id_t { return frame_id_; }
-auto FrameInfo::GetFront() -> size_t { return accesses_.front(); }
-LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_{num_frames}, k_(k) {}
 
-auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
-  latch_.lock();
-  if (curr_size_ == 0) {
-    latch_.unlock();
-    return false;
-  }
-  auto k_it_evict = cache_.end();
-  auto none_k_it_evict = cache_.end();
-  auto it = cache_.begin();
-  while (it != cache_.end()) {
-    if (!it->second.IsEvictable()) {
-      it++;
-      continue;
-    }
-    if (it->second.HasK()) {
-      if (k_it_evict == cache_.end() || it->second.GetFront() < k_it_evict->second.GetFront()) {
-        k_it_evict = it;
-      }
-    } else {
-      if (none_k_it_evict == cache_.end() || it->second.GetFront() < none_k_it_evict->second.GetFront()) {
-        none_k_it_evict = it;
-      }
-    }
-    it++;
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k)
+    : replacer_size_{num_frames}, k_(k), frames_(num_frames), history_(num_frames * k) {
+  BUSTUB_ASSERT(k > 0, "k must be positive");
+}
+
+auto LRUKReplacer::GetKey(frame_id_t frame_id) const -> EvictKey {
+  const auto &frame = frames_[frame_id];
+  size_t oldest = frame.count_ < k_ ? 0 : frame.next_;
+  return {history_[frame_id * k_ + oldest], frame_id};
+}
+
+void LRUKReplacer::Link(frame_id_t frame_id) {
+  auto &list = frames_[frame_id].count_ < k_ ? history_list_ : cache_list_;
+  list.emplace(GetKey(frame_id));
+}
+
+void LRUKReplacer::Unlink(frame_id_t frame_id) {
+  auto &list = frames_[frame_id].count_ < k_ ? history_list_ : cache_list_;
+  list.erase(GetKey(frame_id));
+}
+
+void LRUKReplacer::Record(frame_id_t frame_id, bool pin) {
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  AccessBuffer::Event event{accesses_.NextTimestamp(), frame_id, pin};
+  if (accesses_.TryRecord(event)) {
+    return;
   }
-  if (none_k_it_evict != cache_.end()) {
-    *frame_id = none_k_it_evict->first;
-    cache_.erase(none_k_it_evict);
-    curr_size_--;
-    latch_.unlock();
-    return true;
+  std::scoped_lock<std::mutex> lock(latch_);
+  DrainAccesses(&event);
+}
+
+void LRUKReplacer::DrainAccesses(const AccessBuffer::Event *extra) {
+  drained_.clear();
+  accesses_.Drain(&drained_);
+  if (extra != nullptr) {
+    drained_.insert(std::upper_bound(drained_.begin(), drained_.end(), *extra,
+                                     [](const auto &a, const auto &b) { return a.timestamp_ < b.timestamp_; }),
+                    *extra);
   }
-  if (k_it_evict != cache_.end()) {
-    *frame_id = k_it_evict->first;
-    cache_.erase(k_it_evict);
-    curr_size_--;
-    latch_.unlock();
-    return true;
+  for (const auto &event : drained_) {
+    ApplyAccess(event);
   }
-  latch_.unlock();
-  return false;
 }
 
-void LRUKReplacer::RecordAccess(frame_id_t frame_id) {
-  latch_.lock();
-  BUSTUB_ASSERT(size_t(frame_id) <= replacer_size_, "invalid frame id");
-  if (cache_.find(frame_id) == cache_.end()) {
-    cache_[frame_id] = FrameInfo(k_, frame_id);
+void LRUKReplacer::ApplyAccess(const AccessBuffer::Event &event) {
+  frame_id_t frame_id = event.frame_id_;
+  auto &frame = frames_[frame_id];
+  if (frame.is_evictable_) {
+    Unlink(frame_id);
+  }
+  // An access that was recorded concurrently with a later one can show up in a later batch. Keep the history sorted
+  // by treating it as happening at the same time.
+  size_t timestamp = event.timestamp_;
+  if (frame.count_ > 0) {
+    timestamp = std::max(timestamp, history_[frame_id * k_ + (frame.next_ + k_ - 1) % k_]);
+  }
+  history_[frame_id * k_ + frame.next_] = timestamp;
+  frame.next_ = (frame.next_ + 1) % k_;
+  if (frame.count_ < k_) {
+    frame.count_++;
   }
-  auto &frame_info = cache_[frame_id];
-  frame_info.PushBack(current_timestamp_);
-  current_timestamp_++;
-  if (frame_info.GetSize() > k_) {
-    frame_info.PopFront();
+  if (frame.is_evictable_) {
+    Link(frame_id);
+  }
+  if (event.pin_) {
+    SetEvictableLocked(frame_id, false);
+  }
+}
+
+auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  DrainAccesses();
+  // Frames with +inf backward k-distance go first, in FIFO order.
+  auto &list = !history_list_.empty() ? history_list_ : cache_list_;
+  if (list.empty()) {
+    return false;
   }
-  latch_.unlock();
+  *frame_id = list.begin()->second;
+  list.erase(list.begin());
+  frames_[*frame_id] = FrameInfo{};
+  curr_size_--;
+  return true;
 }
 
+void LRUKReplacer::RecordAccess(frame_id_t frame_id) { Record(frame_id, false); }
+
+void LRUKReplacer::RecordAccessAndPin(frame_id_t frame_id, page_id_t page_id) { Record(frame_id, true); }
+
 void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
-  latch_.lock();
-  BUSTUB_ASSERT(size_t(frame_id) <= replacer_size_, "invalid frame id");
-  auto it = cache_.find(frame_id);
-  if (it == cache_.end()) {
-    latch_.unlock();
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  DrainAccesses();
+  SetEvictableLocked(frame_id, set_evictable);
+}
+
+void LRUKReplacer::SetEvictableLocked(frame_id_t frame_id, bool set_evictable) {
+  auto &frame = frames_[frame_id];
+  if (frame.count_ == 0 || frame.is_evictable_ == set_evictable) {
     return;
   }
-  bool before = it->second.IsEvictable();
-  if (!before && set_evictable) {
+  if (set_evictable) {
+    Link(frame_id);
     curr_size_++;
-  } else if (before && !set_evictable) {
+  } else {
+    Unlink(frame_id);
     curr_size_--;
   }
-  it->second.SetEvictable(set_evictable);
-  latch_.unlock();
+  frame.is_evictable_ = set_evictable;
 }
 
 void LRUKReplacer::Remove(frame_id_t frame_id) {
-  latch_.lock();
-  auto it = cache_.find(frame_id);
-  if (it != cache_.end()) {
-    BUSTUB_ASSERT(it->second.IsEvictable(), "Remove is called on a non-evictable frame");
-    cache_.erase(it);
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  DrainAccesses();
+  auto &frame = frames_[frame_id];
+  if (frame.count_ == 0) {
+    return;
+  }
+  BUSTUB_ASSERT(frame.is_evictable_, "Remove is called on a non-evictable frame");
+  if (frame.is_evictable_) {
+    Unlink(frame_id);
     curr_size_--;
   }
-  latch_.unlock();
+  frame = FrameInfo{};
+}
+
+auto LRUKReplacer::GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  DrainAccesses();
+  std::vector<frame_id_t> candidates;
+  for (const auto *list : {&history_list_, &cache_list_}) {
+    for (auto it = list->begin(); it != list->end() && candidates.size() < max_frames; it++) {
+      candidates.push_back(it->second);
+    }
+  }
+  return candidates;
+}
+
+auto LRUKReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  DrainAccesses();
+  return curr_size_;
+}
+
+auto LRUKReplacer::GetAccessHistory(frame_id_t frame_id) -> std::vector<uint64_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  DrainAccesses();
+  const auto &frame = frames_[frame_id];
+  std::vector<uint64_t> history;
+  size_t oldest = frame.count_ < k_ ? 0 : frame.next_;
+  for (size_t i = 0; i < frame.count_; i++) {
+    history.push_back(history_[frame_id * k_ + (oldest + i) % k_]);
+  }
+  return history;
 }
 
-auto LRUKReplacer::Size() -> size_t { return curr_size_; }
+void LRUKReplacer::RestoreAccessHistory(frame_id_t frame_id, page_id_t page_id, const std::vector<uint64_t> &history) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  DrainAccesses();
+  auto &frame = frames_[frame_id];
+  // Somebody used the page while it was being reloaded; what it did is newer than anything restored.
+  if (frame.count_ > 0) {
+    return;
+  }
+  if (history.empty()) {
+    ApplyAccess({accesses_.NextTimestamp(), frame_id, true});
+    return;
+  }
+  accesses_.AdvanceClock(history.back() + 1);
+  size_t first = history.size() > k_ ? history.size() - k_ : 0;
+  for (size_t i = first; i < history.size(); i++) {
+    history_[frame_id * k_ + frame.next_] = history[i];
+    frame.next_ = (frame.next_ + 1) % k_;
+    frame.count_++;
+  }
+}
 
-// auto Compare(FrameInfo *f1, FrameInfo *f2) -> bool { return f1->GetBack() < f2->GetBack(); }
-auto Compare::operator()(FrameInfo *f1, FrameInfo *f2) -> bool { return f1->GetFront() > f2->GetFront(); }
 }  // namespace bustub
@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.cpp
+//
+// Identification: src/buffer/page_table.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_table.h"
+
+#include <utility>
+
+namespace bustub {
+
+PageTable::PageTable(size_t expected_size) : stripes_(NUM_STRIPES) {
+  // Keep every stripe at most half full when the pages are spread evenly.
+  size_t slots_per_stripe = 4;
+  while (slots_per_stripe * NUM_STRIPES < expected_size * 2) {
+    slots_per_stripe *= 2;
+  }
+  for (auto &stripe : stripes_) {
+    stripe.slots_.resize(slots_per_stripe);
+  }
+}
+
+auto PageTable::Probe(const Stripe &stripe, page_id_t page_id, uint32_t hash) -> size_t {
+  size_t mask = stripe.slots_.size() - 1;
+  size_t idx = hash & mask;
+  while (stripe.slots_[idx].page_id_ != INVALID_PAGE_ID && stripe.slots_[idx].page_id_ != page_id) {
+    idx = (idx + 1) & mask;
+  }
+  return idx;
+}
+
+auto PageTable::Find(page_id_t page_id, frame_id_t &frame_id) -> bool {
+  auto hash = Hash(page_id);
+  auto &stripe = GetStripe(hash);
+  std::scoped_lock<std::mutex> lock(stripe.latch_);
+  const auto &slot = stripe.slots_[Probe(stripe, page_id, hash)];
+  if (slot.page_id_ == INVALID_PAGE_ID) {
+    return false;
+  }
+  frame_id = slot.frame_id_;
+  return true;
+}
+
+void PageTable::Insert(page_id_t page_id, frame_id_t frame_id) {
+  BUSTUB_ASSERT(page_id != INVALID_PAGE_ID, "cannot map the invalid page id");
+  auto hash = Hash(page_id);
+  auto &stripe = GetStripe(hash);
+  std::scoped_lock<std::mutex> lock(stripe.latch_);
+  if ((stripe.size_ + 1) * 2 > stripe.slots_.size()) {
+    Grow(&stripe);
+  }
+  auto &slot = stripe.slots_[Probe(stripe, page_id, hash)];
+  if (slot.page_id_ == INVALID_PAGE_ID) {
+    slot.page_id_ = page_id;
+    stripe.size_++;
+  }
+  slot.frame_id_ = frame_id;
+}
+
+auto PageTable::Remove(page_id_t page_id) -> bool {
+  auto hash = Hash(page_id);
+  auto &stripe = GetStripe(hash);
+  std::scoped_lock<std::mutex> lock(stripe.latch_);
+  auto &slots = stripe.slots_;
+  size_t mask = slots.size() - 1;
+  size_t hole = Probe(stripe, page_id, hash);
+  if (slots[hole].page_id_ == INVALID_PAGE_ID) {
+    return false;
+  }
+  // Backward shift deletion: move every entry of the run behind the hole whose home slot does not lie between the
+  // hole and the entry, so that no probe sequence is broken.
+  for (size_t idx = (hole + 1) & mask; slots[idx].page_id_ != INVALID_PAGE_ID; idx = (idx + 1) & mask) {
+    size_t home = Hash(slots[idx].page_id_) & mask;
+    bool stays = hole <= idx ? (hole < home && home <= idx) : (hole < home || home <= idx);
+    if (!stays) {
+      slots[hole] = slots[idx];
+      hole = idx;
+    }
+  }
+  slots[hole] = Slot{};
+  stripe.size_--;
+  return true;
+}
+
+auto PageTable::Size() -> size_t {
+  size_t size = 0;
+  for (auto &stripe : stripes_) {
+    std::scoped_lock<std::mutex> lock(stripe.latch_);
+    size += stripe.size_;
+  }
+  return size;
+}
+
+void PageTable::Grow(Stripe *stripe) {
+  std::vector<Slot> old_slots(stripe->slots_.size() * 2);
+  std::swap(old_slots, stripe->slots_);
+  for (const auto &slot : old_slots) {
+    if (slot.page_id_ != INVALID_PAGE_ID) {
+      stripe->slots_[Probe(*stripe, slot.page_id_, Hash(slot.page_id_))] = slot;
+    }
+  }
+}
+
+}  // namespace bustub
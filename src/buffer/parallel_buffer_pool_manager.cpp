@@ -0,0 +1,180 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.cpp
+//
+// Identification: src/buffer/parallel_buffer_pool_manager.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                                                     size_t replacer_k, LogManager *log_manager,
+                                                     size_t max_pool_size, ReplacerPolicy replacer_policy)
+    : disk_manager_(disk_manager) {
+  BUSTUB_ASSERT(num_instances > 0, "a parallel BPM needs at least one instance");
+  instances_.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; i++) {
+    instances_.emplace_back(std::make_unique<BufferPoolManagerInstance>(
+        pool_size, static_cast<uint32_t>(num_instances), static_cast<uint32_t>(i), disk_manager, replacer_k,
+        log_manager, max_pool_size, replacer_policy));
+  }
+}
+
+auto ParallelBufferPoolManager::GetPoolSize() -> size_t {
+  size_t pool_size = 0;
+  for (auto &instance : instances_) {
+    pool_size += instance->GetPoolSize();
+  }
+  return pool_size;
+}
+
+void ParallelBufferPoolManager::PrefetchPages(page_id_t first_page_id, size_t count,
+                                              std::shared_ptr<BufferAccessStrategy> strategy) {
+  for (size_t i = 0; i < count; i++) {
+    auto page_id = first_page_id + static_cast<page_id_t>(i);
+    GetBufferPoolManager(page_id)->PrefetchPages(page_id, 1, strategy);
+  }
+}
+
+auto ParallelBufferPoolManager::Resize(size_t new_size) -> bool {
+  auto num_instances = instances_.size();
+  auto share = [&](size_t i) { return new_size / num_instances + (i < new_size % num_instances ? 1 : 0); };
+  for (size_t i = 0; i < num_instances; i++) {
+    if (share(i) == 0 || share(i) > instances_[i]->GetMaxPoolSize()) {
+      return false;
+    }
+  }
+  bool resized = true;
+  for (size_t i = 0; i < num_instances; i++) {
+    resized = instances_[i]->Resize(share(i)) && resized;
+  }
+  return resized;
+}
+
+auto ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) -> BufferPoolManagerInstance * {
+  BUSTUB_ASSERT(page_id >= 0, "invalid page id");
+  return instances_[static_cast<size_t>(page_id) % instances_.size()].get();
+}
+
+auto ParallelBufferPoolManager::GetInstanceStats(size_t instance_index) const -> BufferPoolStats {
+  BUSTUB_ASSERT(instance_index < instances_.size(), "invalid instance index");
+  return instances_[instance_index]->GetStats();
+}
+
+auto ParallelBufferPoolManager::GetStats() const -> BufferPoolStats {
+  BufferPoolStats stats;
+  for (const auto &instance : instances_) {
+    stats += instance->GetStats();
+  }
+  return stats;
+}
+
+auto ParallelBufferPoolManager::FetchPgImp(page_id_t page_id) -> Page * {
+  return GetBufferPoolManager(page_id)->FetchPage(page_id);
+}
+
+auto ParallelBufferPoolManager::FetchPgImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * {
+  return GetBufferPoolManager(page_id)->FetchPageWithStrategy(page_id, strategy);
+}
+
+auto ParallelBufferPoolManager::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool {
+  return GetBufferPoolManager(page_id)->UnpinPage(page_id, is_dirty);
+}
+
+auto ParallelBufferPoolManager::FetchPgsImp(const std::vector<page_id_t> &page_ids, std::vector<Page *> *pages)
+    -> size_t {
+  pages->assign(page_ids.size(), nullptr);
+  size_t fetched = 0;
+  std::vector<page_id_t> instance_page_ids;
+  std::vector<Page *> instance_pages;
+  auto positions = GroupByInstance(page_ids);
+  for (size_t i = 0; i < instances_.size(); i++) {
+    if (positions[i].empty()) {
+      continue;
+    }
+    instance_page_ids.clear();
+    for (auto position : positions[i]) {
+      instance_page_ids.push_back(page_ids[position]);
+    }
+    fetched += instances_[i]->FetchPages(instance_page_ids, &instance_pages);
+    for (size_t j = 0; j < positions[i].size(); j++) {
+      (*pages)[positions[i][j]] = instance_pages[j];
+    }
+  }
+  return fetched;
+}
+
+auto ParallelBufferPoolManager::UnpinPgsImp(const std::vector<page_id_t> &page_ids, bool is_dirty) -> size_t {
+  size_t unpinned = 0;
+  std::vector<page_id_t> instance_page_ids;
+  auto positions = GroupByInstance(page_ids);
+  for (size_t i = 0; i < instances_.size(); i++) {
+    if (positions[i].empty()) {
+      continue;
+    }
+    instance_page_ids.clear();
+    for (auto position : positions[i]) {
+      instance_page_ids.push_back(page_ids[position]);
+    }
+    unpinned += instances_[i]->UnpinPages(instance_page_ids, is_dirty);
+  }
+  return unpinned;
+}
+
+auto ParallelBufferPoolManager::GroupByInstance(const std::vector<page_id_t> &page_ids) const
+    -> std::vector<std::vector<size_t>> {
+  std::vector<std::vector<size_t>> positions(instances_.size());
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    BUSTUB_ASSERT(page_ids[i] >= 0, "invalid page id");
+    positions[static_cast<size_t>(page_ids[i]) % instances_.size()].push_back(i);
+  }
+  return positions;
+}
+
+auto ParallelBufferPoolManager::FlushPgImp(page_id_t page_id) -> bool {
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  return GetBufferPoolManager(page_id)->FlushPage(page_id);
+}
+
+auto ParallelBufferPoolManager::NewPgImp(page_id_t *page_id) -> Page * { return NewPgImp(page_id, INVALID_PAGE_ID); }
+
+auto ParallelBufferPoolManager::NewPgImp(page_id_t *page_id, page_id_t hint) -> Page * {
+  // Each call starts from the next instance, so that allocation is spread evenly even when every call succeeds on
+  // the first try. We give up only after every instance has refused. With a hint, the instance that owns the free page
+  // closest to it goes first, since only it can reuse that page; without such a page, a table or index that keeps
+  // growing would otherwise fill up the instance of its first page.
+  const size_t num_instances = instances_.size();
+  page_id_t free_page_id = hint != INVALID_PAGE_ID ? disk_manager_->FindFreePage(hint) : INVALID_PAGE_ID;
+  const size_t start = free_page_id != INVALID_PAGE_ID ? static_cast<size_t>(free_page_id) % num_instances
+                                                       : next_instance_.fetch_add(1) % num_instances;
+  for (size_t i = 0; i < num_instances; i++) {
+    Page *page = instances_[(start + i) % num_instances]->NewPageNear(page_id, hint);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  return nullptr;
+}
+
+auto ParallelBufferPoolManager::DeletePgImp(page_id_t page_id) -> bool {
+  return GetBufferPoolManager(page_id)->DeletePage(page_id);
+}
+
+void ParallelBufferPoolManager::FlushAllPgsImp() {
+  for (auto &instance : instances_) {
+    instance->FlushAllPages();
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer.cpp
+//
+// Identification: src/buffer/replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/replacer.h"
+
+#include "buffer/arc_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/tiny_lfu_replacer.h"
+#include "buffer/two_q_replacer.h"
+
+namespace bustub {
+
+auto CreateReplacer(ReplacerPolicy policy, size_t num_frames, size_t k) -> BufferPoolReplacer * {
+  switch (policy) {
+    case ReplacerPolicy::LRU_K:
+      return new LRUKReplacer(num_frames, k);
+    case ReplacerPolicy::ARC:
+      return new ARCReplacer(num_frames);
+    case ReplacerPolicy::TWO_Q:
+      return new TwoQReplacer(num_frames);
+    case ReplacerPolicy::W_TINY_LFU:
+      return new TinyLFUReplacer(num_frames);
+  }
+  UNREACHABLE("unknown replacer policy");
+}
+
+auto ReplacerPolicyToString(ReplacerPolicy policy) -> const char * {
+  switch (policy) {
+    case ReplacerPolicy::LRU_K:
+      return "lru-k";
+    case ReplacerPolicy::ARC:
+      return "arc";
+    case ReplacerPolicy::TWO_Q:
+      return "2q";
+    case ReplacerPolicy::W_TINY_LFU:
+      return "w-tinylfu";
+  }
+  return "unknown";
+}
+
+auto ReplacerPolicyFromString(const std::string &name, ReplacerPolicy *policy) -> bool {
+  for (auto candidate :
+       {ReplacerPolicy::LRU_K, ReplacerPolicy::ARC, ReplacerPolicy::TWO_Q, ReplacerPolicy::W_TINY_LFU}) {
+    if (name == ReplacerPolicyToString(candidate)) {
+      *policy = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace bustub
@@ -0,0 +1,232 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tiny_lfu_replacer.cpp
+//
+// Identification: src/buffer/tiny_lfu_replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/tiny_lfu_replacer.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+namespace {
+constexpr uint64_t SKETCH_SEEDS[FrequencySketch::DEPTH] = {0x97cb3127ULL, 0xb3e5f5e9ULL, 0xd6e8feb8ULL, 0x5bd1e995ULL};
+}  // namespace
+
+FrequencySketch::FrequencySketch(size_t num_frames) : sample_size_(10 * std::max<size_t>(1, num_frames)) {
+  // Four counters per frame and row keep collisions between the pages of a full cache rare.
+  width_ = 16;
+  while (width_ < 4 * num_frames) {
+    width_ *= 2;
+  }
+  counters_.resize(DEPTH * width_);
+}
+
+auto FrequencySketch::Index(page_id_t page_id, size_t row) const -> size_t {
+  uint64_t hash = static_cast<uint32_t>(page_id) * 0x9e3779b97f4a7c15ULL + SKETCH_SEEDS[row];
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  return row * width_ + (hash & (width_ - 1));
+}
+
+void FrequencySketch::Increment(page_id_t page_id) {
+  bool added = false;
+  for (size_t row = 0; row < DEPTH; row++) {
+    auto &counter = counters_[Index(page_id, row)];
+    if (counter < MAX_COUNT) {
+      counter++;
+      added = true;
+    }
+  }
+  if (added && ++additions_ >= sample_size_) {
+    for (auto &counter : counters_) {
+      counter /= 2;
+    }
+    additions_ /= 2;
+  }
+}
+
+auto FrequencySketch::Frequency(page_id_t page_id) const -> uint32_t {
+  uint32_t frequency = MAX_COUNT;
+  for (size_t row = 0; row < DEPTH; row++) {
+    frequency = std::min<uint32_t>(frequency, counters_[Index(page_id, row)]);
+  }
+  return frequency;
+}
+
+TinyLFUReplacer::TinyLFUReplacer(size_t num_frames)
+    : replacer_size_(num_frames),
+      window_capacity_(std::max<size_t>(1, num_frames / 100)),
+      protected_capacity_((num_frames - std::min(num_frames, window_capacity_)) * 4 / 5),
+      frames_(num_frames),
+      sketch_(num_frames) {}
+
+auto TinyLFUReplacer::ListOf(Segment segment) -> std::set<EvictKey> & {
+  switch (segment) {
+    case Segment::WINDOW:
+      return window_;
+    case Segment::PROBATION:
+      return probation_;
+    case Segment::PROTECTED:
+      break;
+  }
+  return protected_;
+}
+
+auto TinyLFUReplacer::SizeOf(Segment segment) -> size_t & {
+  switch (segment) {
+    case Segment::WINDOW:
+      return window_size_;
+    case Segment::PROBATION:
+      return probation_size_;
+    case Segment::PROTECTED:
+      break;
+  }
+  return protected_size_;
+}
+
+void TinyLFUReplacer::MoveTo(frame_id_t frame_id, Segment segment) {
+  auto &frame = frames_[frame_id];
+  if (frame.is_evictable_) {
+    ListOf(frame.segment_).erase({frame.last_access_, frame_id});
+  }
+  SizeOf(frame.segment_)--;
+  frame.segment_ = segment;
+  frame.last_access_ = current_timestamp_++;
+  SizeOf(segment)++;
+  if (frame.is_evictable_) {
+    ListOf(segment).emplace(frame.last_access_, frame_id);
+  }
+}
+
+void TinyLFUReplacer::Drop(frame_id_t frame_id) {
+  auto &frame = frames_[frame_id];
+  if (frame.is_evictable_) {
+    ListOf(frame.segment_).erase({frame.last_access_, frame_id});
+    curr_size_--;
+  }
+  SizeOf(frame.segment_)--;
+  frame = FrameInfo{};
+}
+
+auto TinyLFUReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // The buffer pool evicts before it brings the next page into the window, so a full window already overflows.
+  // While the main region has room, pages leaving the window get in for free.
+  size_t main_capacity = replacer_size_ - std::min(replacer_size_, window_capacity_);
+  while (window_size_ >= window_capacity_ && probation_size_ + protected_size_ < main_capacity && !window_.empty()) {
+    MoveTo(window_.begin()->second, Segment::PROBATION);
+  }
+
+  if (window_size_ >= window_capacity_ && !window_.empty()) {
+    // Admission duel between the window's LRU page and the main region's LRU page.
+    frame_id_t candidate = window_.begin()->second;
+    auto &main = !probation_.empty() ? probation_ : protected_;
+    if (!main.empty()) {
+      frame_id_t victim = main.begin()->second;
+      if (sketch_.Frequency(frames_[candidate].page_id_) > sketch_.Frequency(frames_[victim].page_id_)) {
+        *frame_id = victim;
+        Drop(victim);
+        MoveTo(candidate, Segment::PROBATION);
+        return true;
+      }
+    }
+    *frame_id = candidate;
+    Drop(candidate);
+    return true;
+  }
+
+  for (auto *list : {&probation_, &protected_, &window_}) {
+    if (!list->empty()) {
+      *frame_id = list->begin()->second;
+      Drop(*frame_id);
+      return true;
+    }
+  }
+  return false;
+}
+
+void TinyLFUReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  sketch_.Increment(page_id);
+  auto &frame = frames_[frame_id];
+  if (frame.page_id_ != page_id) {
+    if (frame.page_id_ != INVALID_PAGE_ID) {
+      Drop(frame_id);
+    }
+    frame.page_id_ = page_id;
+    frame.segment_ = Segment::WINDOW;
+    frame.last_access_ = current_timestamp_++;
+    window_size_++;
+    return;
+  }
+
+  if (frame.segment_ == Segment::WINDOW) {
+    MoveTo(frame_id, Segment::WINDOW);
+    return;
+  }
+  MoveTo(frame_id, Segment::PROTECTED);
+  // Make room in the protected segment by demoting its LRU pages back to probation.
+  while (protected_size_ > protected_capacity_ && !protected_.empty()) {
+    MoveTo(protected_.begin()->second, Segment::PROBATION);
+  }
+}
+
+void TinyLFUReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  auto &frame = frames_[frame_id];
+  if (frame.page_id_ == INVALID_PAGE_ID || frame.is_evictable_ == set_evictable) {
+    return;
+  }
+  if (set_evictable) {
+    ListOf(frame.segment_).emplace(frame.last_access_, frame_id);
+    curr_size_++;
+  } else {
+    ListOf(frame.segment_).erase({frame.last_access_, frame_id});
+    curr_size_--;
+  }
+  frame.is_evictable_ = set_evictable;
+}
+
+void TinyLFUReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  if (frames_[frame_id].page_id_ == INVALID_PAGE_ID) {
+    return;
+  }
+  BUSTUB_ASSERT(frames_[frame_id].is_evictable_, "Remove is called on a non-evictable frame");
+  Drop(frame_id);
+}
+
+auto TinyLFUReplacer::GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // Approximates Evict(): the window overflow first, then the main region from probation to protected.
+  std::vector<frame_id_t> candidates;
+  size_t overflow = window_size_ >= window_capacity_ ? window_size_ - window_capacity_ + 1 : 0;
+  for (auto it = window_.begin(); it != window_.end() && candidates.size() < std::min(max_frames, overflow); it++) {
+    candidates.push_back(it->second);
+  }
+  for (const auto *list : {&probation_, &protected_}) {
+    for (auto it = list->begin(); it != list->end() && candidates.size() < max_frames; it++) {
+      candidates.push_back(it->second);
+    }
+  }
+  return candidates;
+}
+
+auto TinyLFUReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
+
+}  // namespace bustub
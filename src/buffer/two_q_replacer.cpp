@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_q_replacer.cpp
+//
+// Identification: src/buffer/two_q_replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/two_q_replacer.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+// The sizes recommended by the paper: Kin = 25% and Kout = 50% of the frames.
+TwoQReplacer::TwoQReplacer(size_t num_frames)
+    : replacer_size_(num_frames),
+      kin_(std::max<size_t>(1, num_frames / 4)),
+      kout_(std::max<size_t>(1, num_frames / 2)),
+      frames_(num_frames) {}
+
+auto TwoQReplacer::PreferA1in() const -> bool { return !a1in_.empty() && (a1in_size_ > kin_ || am_.empty()); }
+
+void TwoQReplacer::Drop(frame_id_t frame_id) {
+  auto &frame = frames_[frame_id];
+  if (frame.is_evictable_) {
+    ListOf(frame_id).erase({frame.timestamp_, frame_id});
+    curr_size_--;
+  }
+  (frame.in_am_ ? am_size_ : a1in_size_)--;
+  frame = FrameInfo{};
+}
+
+auto TwoQReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  bool from_a1in = PreferA1in();
+  auto &list = from_a1in ? a1in_ : am_;
+  if (list.empty()) {
+    return false;
+  }
+  *frame_id = list.begin()->second;
+  if (from_a1in) {
+    a1out_.PushFront(frames_[*frame_id].page_id_);
+    if (a1out_.Size() > kout_) {
+      a1out_.PopBack();
+    }
+  }
+  Drop(*frame_id);
+  return true;
+}
+
+void TwoQReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  auto &frame = frames_[frame_id];
+  if (frame.page_id_ == page_id) {
+    // Hits in A1in are correlated references and leave the page where it is.
+    if (frame.in_am_) {
+      if (frame.is_evictable_) {
+        am_.erase({frame.timestamp_, frame_id});
+      }
+      frame.timestamp_ = current_timestamp_++;
+      if (frame.is_evictable_) {
+        am_.emplace(frame.timestamp_, frame_id);
+      }
+    }
+    return;
+  }
+
+  if (frame.page_id_ != INVALID_PAGE_ID) {
+    Drop(frame_id);
+  }
+  frame.page_id_ = page_id;
+  frame.in_am_ = a1out_.Erase(page_id);
+  frame.timestamp_ = current_timestamp_++;
+  (frame.in_am_ ? am_size_ : a1in_size_)++;
+}
+
+void TwoQReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  auto &frame = frames_[frame_id];
+  if (frame.page_id_ == INVALID_PAGE_ID || frame.is_evictable_ == set_evictable) {
+    return;
+  }
+  if (set_evictable) {
+    ListOf(frame_id).emplace(frame.timestamp_, frame_id);
+    curr_size_++;
+  } else {
+    ListOf(frame_id).erase({frame.timestamp_, frame_id});
+    curr_size_--;
+  }
+  frame.is_evictable_ = set_evictable;
+}
+
+void TwoQReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  if (frames_[frame_id].page_id_ == INVALID_PAGE_ID) {
+    return;
+  }
+  BUSTUB_ASSERT(frames_[frame_id].is_evictable_, "Remove is called on a non-evictable frame");
+  Drop(frame_id);
+}
+
+auto TwoQReplacer::GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> candidates;
+  bool a1in_first = PreferA1in();
+  for (const auto *list : {a1in_first ? &a1in_ : &am_, a1in_first ? &am_ : &a1in_}) {
+    for (auto it = list->begin(); it != list->end() && candidates.size() < max_frames; it++) {
+      candidates.push_back(it->second);
+    }
+  }
+  return candidates;
+}
+
+auto TwoQReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
+
+}  // namespace bustub
@@ -41,19 +41,21 @@ auto BustubInstance::MakeExecutorContext(Transaction *txn) -> std::unique_ptr<Ex
   return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_);
 }
 
-BustubInstance::BustubInstance(const std::string &db_file_name) {
+BustubInstance::BustubInstance(const std::string &db_file_name, size_t buffer_pool_size, size_t max_buffer_pool_size) {
   enable_logging = false;
+  if (max_buffer_pool_size == 0) {
+    max_buffer_pool_size = buffer_pool_size;
+  }
 
   // Storage related.
   disk_manager_ = new DiskManager(db_file_name);
 
-  // Log related.
-  log_manager_ = new LogManager(disk_manager_);
+  // Log related. The log buffer is sized for the largest pool.
+  log_manager_ = new LogManager(disk_manager_, LogBufferSize(max_buffer_pool_size));
 
-  // We need more frames for GenerateTestTable to work. Therefore, we use 128 instead of the default
-  // buffer pool size specified in `config.h`.
   try {
-    buffer_pool_manager_ = new BufferPoolManagerInstance(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    buffer_pool_manager_ = new BufferPoolManagerInstance(buffer_pool_size, disk_manager_, LRUK_REPLACER_K, log_manager_,
+                                                         max_buffer_pool_size);
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
@@ -73,19 +75,21 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
 }
 
-BustubInstance::BustubInstance() {
+BustubInstance::BustubInstance(size_t buffer_pool_size, size_t max_buffer_pool_size) {
   enable_logging = false;
+  if (max_buffer_pool_size == 0) {
+    max_buffer_pool_size = buffer_pool_size;
+  }
 
   // Storage related.
   disk_manager_ = new DiskManagerUnlimitedMemory();
 
-  // Log related.
-  log_manager_ = new LogManager(disk_manager_);
+  // Log related. The log buffer is sized for the largest pool.
+  log_manager_ = new LogManager(disk_manager_, LogBufferSize(max_buffer_pool_size));
 
-  // We need more frames for GenerateTestTable to work. Therefore, we use 128 instead of the default
-  // buffer pool size specified in `config.h`.
   try {
-    buffer_pool_manager_ = new BufferPoolManagerInstance(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    buffer_pool_manager_ = new BufferPoolManagerInstance(buffer_pool_size, disk_manager_, LRUK_REPLACER_K, log_manager_,
+                                                         max_buffer_pool_size);
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
@@ -105,6 +109,10 @@ BustubInstance::BustubInstance() {
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
 }
 
+auto BustubInstance::ResizeBufferPool(size_t new_size) -> bool {
+  return buffer_pool_manager_ != nullptr && buffer_pool_manager_->Resize(new_size);
+}
+
 void BustubInstance::CmdDisplayTables(ResultWriter &writer) {
   auto table_names = catalog_->GetTableNames();
   writer.BeginTable(false);
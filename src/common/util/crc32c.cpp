@@ -0,0 +1,213 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// crc32c.cpp
+//
+// Identification: src/common/util/crc32c.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/util/crc32c.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define BUSTUB_CRC32C_SSE42 1
+#endif
+
+namespace bustub {
+
+namespace {
+/** The Castagnoli polynomial, bit-reversed. */
+constexpr uint32_t POLY = 0x82f63b78;
+
+using Table = std::array<std::array<uint32_t, 256>, 8>;
+
+/** table[k][b] is the CRC of byte b followed by k zero bytes; table[0] is the classic byte-at-a-time table. */
+constexpr auto MakeTable() -> Table {
+  Table table{};
+  for (uint32_t b = 0; b < 256; b++) {
+    uint32_t crc = b;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 1) != 0 ? (crc >> 1) ^ POLY : crc >> 1;
+    }
+    table[0][b] = crc;
+  }
+  for (uint32_t b = 0; b < 256; b++) {
+    for (size_t k = 1; k < 8; k++) {
+      table[k][b] = (table[k - 1][b] >> 8) ^ table[0][table[k - 1][b] & 0xff];
+    }
+  }
+  return table;
+}
+
+constexpr Table TABLE = MakeTable();
+
+auto Load64(const unsigned char *p) -> uint64_t {
+  uint64_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+#ifdef BUSTUB_CRC32C_SSE42
+/**
+ * Bytes per stream in a round of the three-stream loop, for long and for shorter buffers. Three short blocks take all
+ * but the tail of a 4 KB page less the checksum field, so that a page is summed in a single round.
+ */
+constexpr size_t LONG_BLOCK = 8192;
+constexpr size_t SHORT_BLOCK = 1360;
+
+/** Operator on the CRC register that appends n zero bytes, applied a byte of the register at a time. */
+using ShiftTable = std::array<std::array<uint32_t, 256>, 4>;
+
+/** @return the product of a 32x32 matrix over GF(2), one column per word, and a vector */
+auto Gf2Times(const std::array<uint32_t, 32> &mat, uint32_t vec) -> uint32_t {
+  uint32_t sum = 0;
+  for (size_t i = 0; vec != 0; i++, vec >>= 1) {
+    if ((vec & 1) != 0) {
+      sum ^= mat[i];
+    }
+  }
+  return sum;
+}
+
+auto Gf2Square(const std::array<uint32_t, 32> &mat) -> std::array<uint32_t, 32> {
+  std::array<uint32_t, 32> square;
+  for (size_t i = 0; i < 32; i++) {
+    square[i] = Gf2Times(mat, mat[i]);
+  }
+  return square;
+}
+
+/** @return the table that appends n zero bytes to a CRC register */
+auto MakeShiftTable(size_t n) -> ShiftTable {
+  // Appending one zero bit is a shift with the polynomial fed back; squaring doubles the number of bits.
+  std::array<uint32_t, 32> op;
+  op[0] = POLY;
+  for (size_t i = 1; i < 32; i++) {
+    op[i] = uint32_t{1} << (i - 1);
+  }
+  for (int i = 0; i < 3; i++) {
+    op = Gf2Square(op);
+  }
+  // op appends one zero byte now; multiply in the powers of two of n.
+  std::array<uint32_t, 32> result;
+  bool have_result = false;
+  for (; n != 0; n >>= 1, op = Gf2Square(op)) {
+    if ((n & 1) == 0) {
+      continue;
+    }
+    if (!have_result) {
+      result = op;
+      have_result = true;
+    } else {
+      for (auto &column : result) {
+        column = Gf2Times(op, column);
+      }
+    }
+  }
+  ShiftTable table;
+  for (uint32_t b = 0; b < 256; b++) {
+    for (size_t k = 0; k < 4; k++) {
+      table[k][b] = Gf2Times(result, b << (8 * k));
+    }
+  }
+  return table;
+}
+
+auto Shift(const ShiftTable &table, uint32_t crc) -> uint32_t {
+  return table[0][crc & 0xff] ^ table[1][(crc >> 8) & 0xff] ^ table[2][(crc >> 16) & 0xff] ^ table[3][crc >> 24];
+}
+
+const ShiftTable LONG_SHIFT = MakeShiftTable(LONG_BLOCK);
+const ShiftTable SHORT_SHIFT = MakeShiftTable(SHORT_BLOCK);
+
+/**
+ * Run three streams of block bytes each over the data at once. The crc32 instruction takes three cycles but can
+ * start every cycle, so three independent streams keep it busy. The CRCs of the later streams are then combined with
+ * the earlier ones by appending block zero bytes to those.
+ */
+__attribute__((target("sse4.2"))) auto ExtendHardwareBlocks(uint64_t crc0, const unsigned char **next, size_t *size,
+                                                           size_t block, const ShiftTable &shift) -> uint64_t {
+  while (*size >= 3 * block) {
+    uint64_t crc1 = 0;
+    uint64_t crc2 = 0;
+    const unsigned char *p = *next;
+    const unsigned char *end = p + block;
+    for (; p < end; p += 8) {
+      crc0 = _mm_crc32_u64(crc0, Load64(p));
+      crc1 = _mm_crc32_u64(crc1, Load64(p + block));
+      crc2 = _mm_crc32_u64(crc2, Load64(p + 2 * block));
+    }
+    crc0 = Shift(shift, static_cast<uint32_t>(crc0)) ^ crc1;
+    crc0 = Shift(shift, static_cast<uint32_t>(crc0)) ^ crc2;
+    *next += 3 * block;
+    *size -= 3 * block;
+  }
+  return crc0;
+}
+
+__attribute__((target("sse4.2"))) auto ExtendHardware(uint32_t crc, const char *data, size_t size) -> uint32_t {
+  auto next = reinterpret_cast<const unsigned char *>(data);
+  uint64_t crc0 = ~crc;
+  while (size > 0 && (reinterpret_cast<uintptr_t>(next) & 7) != 0) {
+    crc0 = _mm_crc32_u8(static_cast<uint32_t>(crc0), *next++);
+    size--;
+  }
+  crc0 = ExtendHardwareBlocks(crc0, &next, &size, LONG_BLOCK, LONG_SHIFT);
+  crc0 = ExtendHardwareBlocks(crc0, &next, &size, SHORT_BLOCK, SHORT_SHIFT);
+  for (; size >= 8; next += 8, size -= 8) {
+    crc0 = _mm_crc32_u64(crc0, Load64(next));
+  }
+  for (; size > 0; size--) {
+    crc0 = _mm_crc32_u8(static_cast<uint32_t>(crc0), *next++);
+  }
+  return ~static_cast<uint32_t>(crc0);
+}
+
+const bool HAS_SSE42 = [] {
+  // Static initializers may run before the one that fills in the CPU model.
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("sse4.2") != 0;
+}();
+#endif
+}  // namespace
+
+auto Crc32c::ExtendSoftware(uint32_t crc, const char *data, size_t size) -> uint32_t {
+  auto next = reinterpret_cast<const unsigned char *>(data);
+  uint32_t c = ~crc;
+  for (; size >= 8; next += 8, size -= 8) {
+    uint64_t word = Load64(next) ^ c;
+    c = TABLE[7][word & 0xff] ^ TABLE[6][(word >> 8) & 0xff] ^ TABLE[5][(word >> 16) & 0xff] ^
+        TABLE[4][(word >> 24) & 0xff] ^ TABLE[3][(word >> 32) & 0xff] ^ TABLE[2][(word >> 40) & 0xff] ^
+        TABLE[1][(word >> 48) & 0xff] ^ TABLE[0][word >> 56];
+  }
+  for (; size > 0; size--) {
+    c = (c >> 8) ^ TABLE[0][(c ^ *next++) & 0xff];
+  }
+  return ~c;
+}
+
+auto Crc32c::Extend(uint32_t crc, const char *data, size_t size) -> uint32_t {
+#ifdef BUSTUB_CRC32C_SSE42
+  if (HAS_SSE42) {
+    return ExtendHardware(crc, data, size);
+  }
+#endif
+  return ExtendSoftware(crc, data, size);
+}
+
+auto Crc32c::IsHardwareAccelerated() -> bool {
+#ifdef BUSTUB_CRC32C_SSE42
+  return HAS_SSE42;
+#else
+  return false;
+#endif
+}
+
+}  // namespace bustub
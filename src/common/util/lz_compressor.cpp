@@ -0,0 +1,159 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lz_compressor.cpp
+//
+// Identification: src/common/util/lz_compressor.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/util/lz_compressor.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace bustub {
+
+namespace {
+constexpr size_t HASH_BITS = 12;
+
+auto Read32(const uint8_t *p) -> uint32_t {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+auto Hash(uint32_t sequence) -> size_t { return (sequence * 2654435761U) >> (32 - HASH_BITS); }
+
+/** Write the continuation bytes of a length whose nibble was 15. */
+void WriteLength(size_t length, uint8_t *out, size_t *op) {
+  for (length -= 15; length >= 255; length -= 255) {
+    out[(*op)++] = 255;
+  }
+  out[(*op)++] = static_cast<uint8_t>(length);
+}
+
+/** Read a length whose nibble was 15; false if the input ends first. */
+auto ReadLength(const uint8_t *in, size_t size, size_t *ip, size_t *length) -> bool {
+  uint8_t byte;
+  do {
+    if (*ip >= size) {
+      return false;
+    }
+    byte = in[(*ip)++];
+    *length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+/** Append a sequence; a match_length of 0 ends the output. False if it does not fit. */
+auto WriteSequence(const uint8_t *literals, size_t num_literals, size_t offset, size_t match_length, uint8_t *out,
+                   size_t *op, size_t capacity) -> bool {
+  size_t match_code = match_length == 0 ? 0 : match_length - LZCompressor::MIN_MATCH;
+  size_t worst_case = 1 + num_literals / 255 + 1 + num_literals + 2 + match_code / 255 + 1;
+  if (*op + worst_case > capacity) {
+    // The exact size may still fit, which is not worth the trouble.
+    return false;
+  }
+  size_t token = *op;
+  (*op)++;
+  out[token] = static_cast<uint8_t>((num_literals < 15 ? num_literals : 15) << 4);
+  if (num_literals >= 15) {
+    WriteLength(num_literals, out, op);
+  }
+  memcpy(out + *op, literals, num_literals);
+  *op += num_literals;
+  if (match_length == 0) {
+    return true;
+  }
+  out[token] |= static_cast<uint8_t>(match_code < 15 ? match_code : 15);
+  out[(*op)++] = static_cast<uint8_t>(offset & 0xff);
+  out[(*op)++] = static_cast<uint8_t>(offset >> 8);
+  if (match_code >= 15) {
+    WriteLength(match_code, out, op);
+  }
+  return true;
+}
+}  // namespace
+
+auto LZCompressor::Compress(const char *src, size_t size, char *dst, size_t capacity) -> size_t {
+  const auto *in = reinterpret_cast<const uint8_t *>(src);
+  auto *out = reinterpret_cast<uint8_t *>(dst);
+  // Position + 1 of the last occurrence of every hashed 4-byte sequence; 0 means none.
+  std::array<uint32_t, 1 << HASH_BITS> table{};
+  size_t ip = 0;
+  size_t anchor = 0;
+  size_t op = 0;
+  while (ip + MIN_MATCH <= size) {
+    uint32_t sequence = Read32(in + ip);
+    uint32_t &entry = table[Hash(sequence)];
+    size_t candidate = entry;
+    entry = static_cast<uint32_t>(ip + 1);
+    if (candidate == 0 || ip + 1 - candidate > MAX_OFFSET || Read32(in + candidate - 1) != sequence) {
+      ip++;
+      continue;
+    }
+    size_t match = candidate - 1;
+    size_t match_length = MIN_MATCH;
+    while (ip + match_length < size && in[match + match_length] == in[ip + match_length]) {
+      match_length++;
+    }
+    if (!WriteSequence(in + anchor, ip - anchor, ip - match, match_length, out, &op, capacity)) {
+      return 0;
+    }
+    ip += match_length;
+    anchor = ip;
+  }
+  if (!WriteSequence(in + anchor, size - anchor, 0, 0, out, &op, capacity)) {
+    return 0;
+  }
+  return op;
+}
+
+auto LZCompressor::Decompress(const char *src, size_t size, char *dst, size_t capacity) -> size_t {
+  const auto *in = reinterpret_cast<const uint8_t *>(src);
+  auto *out = reinterpret_cast<uint8_t *>(dst);
+  size_t ip = 0;
+  size_t op = 0;
+  while (ip < size) {
+    uint8_t token = in[ip++];
+    size_t num_literals = token >> 4;
+    if (num_literals == 15 && !ReadLength(in, size, &ip, &num_literals)) {
+      return 0;
+    }
+    if (num_literals > size - ip || num_literals > capacity - op) {
+      return 0;
+    }
+    memcpy(out + op, in + ip, num_literals);
+    ip += num_literals;
+    op += num_literals;
+    if (ip == size) {
+      // The last sequence has no match.
+      break;
+    }
+    if (size - ip < 2) {
+      return 0;
+    }
+    size_t offset = in[ip] | static_cast<size_t>(in[ip + 1]) << 8;
+    ip += 2;
+    size_t match_length = token & 0xf;
+    if (match_length == 15 && !ReadLength(in, size, &ip, &match_length)) {
+      return 0;
+    }
+    match_length += MIN_MATCH;
+    if (offset == 0 || offset > op || match_length > capacity - op) {
+      return 0;
+    }
+    // Byte by byte: a match may overlap the bytes it produces.
+    for (size_t i = 0; i < match_length; i++, op++) {
+      out[op] = out[op - offset];
+    }
+  }
+  return op;
+}
+
+}  // namespace bustub
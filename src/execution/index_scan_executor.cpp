@@ -10,7 +10,9 @@
 //
 //===----------------------------------------------------------------------===//
 #include "execution/executors/index_scan_executor.h"
+#include <algorithm>
 #include <memory>
+#include "common/exception.h"
 #include "storage/index/b_plus_tree_index.h"
 
 namespace bustub {
@@ -22,17 +24,32 @@ void IndexScanExecutor::Init() {
   table_info_ = GetExecutorContext()->GetCatalog()->GetTable(index_info_->table_name_);
   tree_ = dynamic_cast<BPlusTreeIndexForOneIntegerColumn *>(index_info_->index_.get());
   index_iterator_ = std::make_unique<BPlusTreeIndexIteratorForOneIntegerColumn>(tree_->GetBeginIterator());
+  rids_.clear();
+  tuples_.clear();
+  next_ = 0;
 }
 
 auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  if (index_iterator_->IsEnd()) {
-    return false;
+  if (next_ == rids_.size()) {
+    // Resolve the next batch of RIDs with one FetchPages() call instead of a fetch per tuple. The batch pins a page
+    // per RID at worst, on top of the leaf; keep it to a quarter of the pool.
+    rids_.clear();
+    next_ = 0;
+    auto batch_size = std::max<size_t>(
+        std::min<size_t>(INDEX_SCAN_BATCH_SIZE, GetExecutorContext()->GetBufferPoolManager()->GetPoolSize() / 4), 1);
+    while (rids_.size() < batch_size && !index_iterator_->IsEnd()) {
+      rids_.push_back((**index_iterator_).second);
+      ++(*index_iterator_);
+    }
+    if (rids_.empty()) {
+      return false;
+    }
+    if (!table_info_->table_->GetTuples(rids_, &tuples_, GetExecutorContext()->GetTransaction())) {
+      throw ExecutionException("index scan: cannot fetch table pages");
+    }
   }
-  *rid = (**index_iterator_).second;
-
-  ++(*index_iterator_);
-  Tuple raw_tuple;
-  table_info_->table_->GetTuple(*rid, &raw_tuple, GetExecutorContext()->GetTransaction());
+  *rid = rids_[next_];
+  const Tuple &raw_tuple = tuples_[next_++];
 
   std::vector<Value> values{};
   values.reserve(GetOutputSchema().GetColumnCount());
@@ -12,6 +12,7 @@
 
 #include "execution/executors/seq_scan_executor.h"
 #include <memory>
+#include <utility>
 #include "common/config.h"
 #include "common/exception.h"
 #include "common/logger.h"
@@ -29,7 +30,9 @@ SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNod
 
 void SeqScanExecutor::Init() {
   table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid());
-  table_iterator_ = std::make_unique<TableIterator>(table_info_->table_->Begin(exec_ctx_->GetTransaction()));
+  auto strategy = exec_ctx_->GetScanAccessStrategy(table_info_->table_.get());
+  table_iterator_ =
+      std::make_unique<TableIterator>(table_info_->table_->Begin(exec_ctx_->GetTransaction(), std::move(strategy)));
   auto lock_mgr = GetExecutorContext()->GetLockManager();
   auto txn = GetExecutorContext()->GetTransaction();
   LOG_DEBUG("iso level:%s", LockManager::GetIsolationLevelString(txn->GetIsolationLevel()));
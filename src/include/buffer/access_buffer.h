@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// access_buffer.h
+//
+// Identification: src/include/buffer/access_buffer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * AccessBuffer collects frame accesses from many threads without a lock, so that a replacer can apply them in
+ * batches under its latch instead of taking the latch on every hit.
+ *
+ * Every access gets a timestamp from a shared clock and goes into one of NUM_STRIPES bounded ring buffers, picked by
+ * the recording thread, so threads rarely share a ring. The rings are multi-producer queues with a sequence number
+ * per slot. A full ring is not waited on: TryRecord() fails and the caller applies the access under the latch
+ * itself. Drain() hands out the events of all rings, ordered by timestamp.
+ */
+class AccessBuffer {
+ public:
+  /** A recorded access. pin_ means that the frame also became non-evictable. */
+  struct Event {
+    uint64_t timestamp_;
+    frame_id_t frame_id_;
+    bool pin_;
+  };
+
+  static constexpr size_t NUM_STRIPES = 16;
+  static constexpr size_t STRIPE_CAPACITY = 64;
+
+  AccessBuffer();
+
+  DISALLOW_COPY_AND_MOVE(AccessBuffer);
+
+  /** @return a new timestamp, larger than every timestamp handed out before */
+  auto NextTimestamp() -> uint64_t { return clock_.fetch_add(1, std::memory_order_relaxed); }
+
+  /** @brief Make sure that every timestamp handed out from now on is at least timestamp. */
+  void AdvanceClock(uint64_t timestamp) {
+    uint64_t current = clock_.load(std::memory_order_relaxed);
+    while (current < timestamp && !clock_.compare_exchange_weak(current, timestamp, std::memory_order_relaxed)) {
+    }
+  }
+
+  /**
+   * @brief Append an event to the ring of the calling thread. Safe to call from any number of threads.
+   * @return false if the ring is full
+   */
+  auto TryRecord(const Event &event) -> bool;
+
+  /**
+   * @brief Move the events of all rings to the end of events, sorted by timestamp. Only one thread may drain at a
+   * time. Events that are recorded while draining may be left for the next call.
+   */
+  void Drain(std::vector<Event> *events);
+
+ private:
+  struct Slot {
+    /** Slot i of a ring is free for position p when sequence_ == p, and holds the event of p when it is p + 1. */
+    std::atomic<uint64_t> sequence_;
+    Event event_;
+  };
+
+  struct Stripe {
+    /** Next position to write, shared by the producers. */
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    /** Next position to read, only used by the draining thread. */
+    alignas(64) uint64_t head_{0};
+    std::array<Slot, STRIPE_CAPACITY> slots_;
+  };
+
+  std::atomic<uint64_t> clock_{0};
+  std::array<Stripe, NUM_STRIPES> stripes_;
+};
+
+}  // namespace bustub
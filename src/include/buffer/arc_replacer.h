@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.h
+//
+// Identification: src/include/buffer/arc_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "buffer/ghost_list.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ARCReplacer implements the Adaptive Replacement Cache policy (Megiddo and Modha, FAST '03).
+ *
+ * Resident pages are split into T1, pages seen once since they were brought in, and T2, pages seen at least twice.
+ * The ids of pages evicted from T1 and T2 are remembered in the ghost lists B1 and B2. A miss on a page in B1 means
+ * that T1 was too small, and grows the target size p of T1; a miss on a page in B2 shrinks it. Eviction takes the
+ * least recently used evictable frame of T1 while T1 is larger than p, and of T2 otherwise, so the split between
+ * recency and frequency follows the workload. A sequential scan only ever fills T1 and cannot flush T2.
+ *
+ * The buffer pool evicts before it knows which page comes next, so the B2 tie-break of the original REPLACE is
+ * dropped. Pinned frames count towards the sizes of T1 and T2, but are skipped when looking for a victim.
+ */
+class ARCReplacer : public BufferPoolReplacer {
+ public:
+  /**
+   * @brief Create a new ARCReplacer.
+   * @param num_frames the maximum number of frames the replacer will be required to store, which is also the cache
+   * size c of the policy
+   */
+  explicit ARCReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(ARCReplacer);
+
+  ~ARCReplacer() override = default;
+
+  /** @brief Evict the least recently used evictable frame of T1 or T2 and remember its page in B1 or B2. */
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  /** @brief Record a hit on the page in the frame, or bring the page into the frame, adapting p on a ghost hit. */
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  /** @brief Forget the frame without remembering its page, e.g. because the page was deleted. */
+  void Remove(frame_id_t frame_id) override;
+
+  auto GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
+
+  auto Size() -> size_t override;
+
+  /** @return the current target size p of T1 */
+  auto GetTarget() -> size_t;
+
+ private:
+  struct FrameInfo {
+    page_id_t page_id_{INVALID_PAGE_ID};
+    bool in_t2_{false};
+    bool is_evictable_{false};
+    size_t last_access_{0};
+  };
+
+  /** (last access, frame id) */
+  using EvictKey = std::pair<size_t, frame_id_t>;
+
+  auto ListOf(frame_id_t frame_id) -> std::set<EvictKey> & { return frames_[frame_id].in_t2_ ? t2_ : t1_; }
+
+  /** @return whether Evict() would take the next victim from T1 */
+  auto PreferT1() const -> bool;
+
+  /** @brief Stop tracking the frame. */
+  void Drop(frame_id_t frame_id);
+
+  size_t current_timestamp_{0};
+  size_t curr_size_{0};
+  size_t replacer_size_;
+  /** Target size of T1. */
+  size_t p_{0};
+  /** Resident pages in T1 and T2, pinned or not. */
+  size_t t1_size_{0};
+  size_t t2_size_{0};
+  std::vector<FrameInfo> frames_;
+  /** Evictable frames of T1 and T2, least recently used first. */
+  std::set<EvictKey> t1_;
+  std::set<EvictKey> t2_;
+  GhostList b1_;
+  GhostList b2_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_access_strategy.h
+//
+// Identification: src/include/buffer/buffer_access_strategy.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * BufferAccessStrategy keeps a large scan from flooding the buffer pool.
+ *
+ * A query that reads many pages once passes the same strategy to every fetch. On a miss, the buffer pool manager
+ * first tries to recycle the frame it loaded ring_size misses ago for the same strategy, and only takes a frame from
+ * the free list or the replacer when that frame is gone or still in use. The scan therefore cycles through a small
+ * private ring of frames instead of evicting everybody else's pages. Hits are served as usual.
+ *
+ * Every buffer pool manager instance gets its own ring, identified by its instance index. A ring is only touched
+ * while the owning instance holds its latch; the strategy latch only protects the map of rings.
+ */
+class BufferAccessStrategy {
+ public:
+  /**
+   * @brief Create a strategy.
+   * @param ring_size number of frames a scan may recycle in each buffer pool manager instance
+   */
+  explicit BufferAccessStrategy(size_t ring_size) : ring_size_(ring_size) {
+    BUSTUB_ASSERT(ring_size > 0, "ring must hold at least one frame");
+  }
+
+  DISALLOW_COPY_AND_MOVE(BufferAccessStrategy);
+
+  /** @return the number of frames of each ring */
+  auto GetRingSize() const -> size_t { return ring_size_; }
+
+  /**
+   * @brief Look at the slot of the ring that the next miss will fill.
+   * @param instance_index index of the buffer pool manager instance
+   * @param[out] frame_id frame loaded by the miss ring_size misses ago
+   * @param[out] page_id page that miss loaded into the frame
+   * @return false if the slot is still empty
+   */
+  auto GetCurrent(uint32_t instance_index, frame_id_t *frame_id, page_id_t *page_id) -> bool {
+    auto &ring = GetRing(instance_index);
+    auto &slot = ring.slots_[ring.next_];
+    if (slot.second == INVALID_PAGE_ID) {
+      return false;
+    }
+    *frame_id = slot.first;
+    *page_id = slot.second;
+    return true;
+  }
+
+  /**
+   * @brief Remember the frame a miss loaded the page into, and move on to the next slot.
+   * @param instance_index index of the buffer pool manager instance
+   * @param frame_id the frame
+   * @param page_id the page now held by the frame
+   */
+  void Put(uint32_t instance_index, frame_id_t frame_id, page_id_t page_id) {
+    auto &ring = GetRing(instance_index);
+    ring.slots_[ring.next_] = {frame_id, page_id};
+    ring.next_ = (ring.next_ + 1) % ring_size_;
+  }
+
+ private:
+  struct Ring {
+    std::vector<std::pair<frame_id_t, page_id_t>> slots_;
+    size_t next_{0};
+  };
+
+  auto GetRing(uint32_t instance_index) -> Ring & {
+    std::scoped_lock<std::mutex> lock(latch_);
+    auto &ring = rings_[instance_index];
+    if (ring.slots_.empty()) {
+      ring.slots_.resize(ring_size_, {-1, INVALID_PAGE_ID});
+    }
+    // References to unordered_map elements stay valid when other rings are added.
+    return ring;
+  }
+
+  const size_t ring_size_;
+  std::mutex latch_;
+  std::unordered_map<uint32_t, Ring> rings_;
+};
+
+}  // namespace bustub
@@ -13,9 +13,12 @@
 #pragma once
 
 #include <list>
+#include <memory>
 #include <mutex>  // NOLINT
 #include <unordered_map>
+#include <vector>
 
+#include "buffer/buffer_access_strategy.h"
 #include "buffer/lru_replacer.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
@@ -84,9 +87,66 @@ class BufferPoolManager {
     GradingCallback(callback, CallbackType::AFTER, INVALID_PAGE_ID);
   }
 
+  /**
+   * Fetch the requested page on behalf of a query that uses a buffer access strategy. On a miss, the page is read
+   * into one of the frames recycled by the strategy where possible, see BufferAccessStrategy.
+   * @param page_id id of page to be fetched
+   * @param strategy the strategy of the query, nullptr behaves like FetchPage()
+   * @return the requested page
+   */
+  auto FetchPageWithStrategy(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * {
+    return FetchPgImp(page_id, strategy);
+  }
+
+  /**
+   * Create a new page, on a page id close to hint if a deallocated page can be reused there, so that pages that are
+   * used together, like the two halves of a split index node, stay close together on disk.
+   * @param[out] page_id id of created page
+   * @param hint id of a page the new page belongs with, INVALID_PAGE_ID behaves like NewPage()
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPageNear(page_id_t *page_id, page_id_t hint) -> Page * { return NewPgImp(page_id, hint); }
+
+  /**
+   * Fetch several pages at once. Every page that is returned is pinned once per occurrence in page_ids, as if it was
+   * fetched with FetchPage(), and must be unpinned with UnpinPage() or UnpinPages().
+   * @param page_ids ids of the pages to be fetched
+   * @param[out] pages the page for every entry of page_ids, nullptr for the pages that could not be fetched
+   * @return the number of pages that were fetched
+   */
+  auto FetchPages(const std::vector<page_id_t> &page_ids, std::vector<Page *> *pages) -> size_t {
+    return FetchPgsImp(page_ids, pages);
+  }
+
+  /**
+   * Unpin several pages at once, like UnpinPage() for every entry of page_ids.
+   * @param page_ids ids of the pages to be unpinned
+   * @param is_dirty true if the pages should be marked as dirty, false otherwise
+   * @return the number of pages that were unpinned
+   */
+  auto UnpinPages(const std::vector<page_id_t> &page_ids, bool is_dirty) -> size_t {
+    return UnpinPgsImp(page_ids, is_dirty);
+  }
+
   /** @return size of the buffer pool */
   virtual auto GetPoolSize() -> size_t = 0;
 
+  /**
+   * Hint that the pages [first_page_id, first_page_id + count) will be fetched soon. Implementations may start
+   * reading them in the background; the pages are not pinned and nothing is guaranteed to be resident afterwards.
+   * @param first_page_id id of the first page to prefetch
+   * @param count number of consecutive page ids to prefetch
+   * @param strategy buffer access strategy of the query the pages are read for, may be nullptr
+   */
+  virtual void PrefetchPages(page_id_t first_page_id, size_t count, std::shared_ptr<BufferAccessStrategy> strategy) {}
+
+  /**
+   * Change the number of frames of the buffer pool while it is in use.
+   * @param new_size the new number of frames
+   * @return false if the buffer pool cannot be resized to new_size
+   */
+  virtual auto Resize(size_t new_size) -> bool { return false; }
+
  protected:
   /**
    * Grading function. Do not modify!
@@ -108,6 +168,14 @@ class BufferPoolManager {
    */
   virtual auto FetchPgImp(page_id_t page_id) -> Page * = 0;
 
+  /**
+   * Fetch the requested page from the buffer pool, using the given buffer access strategy on a miss.
+   * @param page_id id of page to be fetched
+   * @param strategy the strategy of the query, may be nullptr
+   * @return the requested page
+   */
+  virtual auto FetchPgImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * { return FetchPgImp(page_id); }
+
   /**
    * Unpin the target page from the buffer pool.
    * @param page_id id of page to be unpinned
@@ -116,6 +184,36 @@ class BufferPoolManager {
    */
   virtual auto UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool = 0;
 
+  /**
+   * Fetch several pages, one at a time unless the buffer pool knows better.
+   * @param page_ids ids of the pages to be fetched
+   * @param[out] pages the page for every entry of page_ids, nullptr for the pages that could not be fetched
+   * @return the number of pages that were fetched
+   */
+  virtual auto FetchPgsImp(const std::vector<page_id_t> &page_ids, std::vector<Page *> *pages) -> size_t {
+    size_t fetched = 0;
+    pages->resize(page_ids.size());
+    for (size_t i = 0; i < page_ids.size(); i++) {
+      (*pages)[i] = FetchPgImp(page_ids[i]);
+      fetched += (*pages)[i] != nullptr ? 1 : 0;
+    }
+    return fetched;
+  }
+
+  /**
+   * Unpin several pages, one at a time unless the buffer pool knows better.
+   * @param page_ids ids of the pages to be unpinned
+   * @param is_dirty true if the pages should be marked as dirty, false otherwise
+   * @return the number of pages that were unpinned
+   */
+  virtual auto UnpinPgsImp(const std::vector<page_id_t> &page_ids, bool is_dirty) -> size_t {
+    size_t unpinned = 0;
+    for (auto page_id : page_ids) {
+      unpinned += UnpinPgImp(page_id, is_dirty) ? 1 : 0;
+    }
+    return unpinned;
+  }
+
   /**
    * Flushes the target page to disk.
    * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
@@ -130,6 +228,14 @@ class BufferPoolManager {
    */
   virtual auto NewPgImp(page_id_t *page_id) -> Page * = 0;
 
+  /**
+   * Creates a new page in the buffer pool, preferring a page id close to hint.
+   * @param[out] page_id id of created page
+   * @param hint id of a page the new page belongs with, may be INVALID_PAGE_ID
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  virtual auto NewPgImp(page_id_t *page_id, page_id_t hint) -> Page * { return NewPgImp(page_id); }
+
   /**
    * Deletes a page from the buffer pool.
    * @param page_id id of page to be deleted
@@ -12,20 +12,83 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
 #include <list>
+#include <memory>
 #include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "buffer/buffer_access_strategy.h"
 #include "buffer/buffer_pool_manager.h"
-#include "buffer/lru_k_replacer.h"
+#include "buffer/compressed_page_cache.h"
+#include "buffer/frame_arena.h"
+#include "buffer/page_table.h"
+#include "buffer/replacer.h"
 #include "common/config.h"
-#include "container/hash/extendible_hash_table.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/page.h"
 
 namespace bustub {
 
+/**
+ * BufferPoolStats is a point-in-time snapshot of the counters kept by a BufferPoolManagerInstance.
+ */
+struct BufferPoolStats {
+  /** Number of fetches served from a resident frame. */
+  uint64_t hits_{0};
+  /** Number of fetches that had to read the page from disk. */
+  uint64_t misses_{0};
+  /** Number of pages created through NewPage. */
+  uint64_t new_pages_{0};
+  /** Number of frames taken away from a resident page by the replacer. */
+  uint64_t evictions_{0};
+  /** Number of dirty victims written back synchronously on the eviction path. */
+  uint64_t write_backs_{0};
+  /** Number of dirty pages written back ahead of eviction by the page cleaner. */
+  uint64_t background_write_backs_{0};
+  /** Number of NewPage / FetchPage calls that failed because every frame was pinned. */
+  uint64_t no_frame_{0};
+  /** Number of pages read ahead of time through PrefetchPages. */
+  uint64_t prefetches_{0};
+  /** Number of misses that recycled a frame of their buffer access strategy's ring. */
+  uint64_t ring_reuses_{0};
+  /** Number of times a miss evicted a whole batch of victims, see EnableBatchEviction(). */
+  uint64_t eviction_batches_{0};
+  /** Number of write requests issued for the dirty victims of batches; a run of consecutive pages is one request. */
+  uint64_t batch_writes_{0};
+  /** Number of pages reloaded by WarmUp(). */
+  uint64_t warm_up_pages_{0};
+  /** Number of pages created through NewPage on the id of a deleted page. */
+  uint64_t reused_pages_{0};
+  /** Number of asynchronous page reads and writes of the pool that failed, retries included. */
+  uint64_t io_errors_{0};
+
+  auto operator+=(const BufferPoolStats &other) -> BufferPoolStats & {
+    hits_ += other.hits_;
+    misses_ += other.misses_;
+    new_pages_ += other.new_pages_;
+    evictions_ += other.evictions_;
+    write_backs_ += other.write_backs_;
+    background_write_backs_ += other.background_write_backs_;
+    no_frame_ += other.no_frame_;
+    prefetches_ += other.prefetches_;
+    ring_reuses_ += other.ring_reuses_;
+    eviction_batches_ += other.eviction_batches_;
+    batch_writes_ += other.batch_writes_;
+    warm_up_pages_ += other.warm_up_pages_;
+    reused_pages_ += other.reused_pages_;
+    io_errors_ += other.io_errors_;
+    return *this;
+  }
+};
+
 /**
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
  */
@@ -37,9 +100,28 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @param disk_manager the disk manager
    * @param replacer_k the lookback constant k for the LRU-K replacer
    * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param max_pool_size largest size Resize() may grow the pool to, 0 for pool_size
+   * @param replacer_policy the replacement policy
    */
   BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
-                            LogManager *log_manager = nullptr);
+                            LogManager *log_manager = nullptr, size_t max_pool_size = 0,
+                            ReplacerPolicy replacer_policy = ReplacerPolicy::LRU_K);
+
+  /**
+   * @brief Creates a new BufferPoolManagerInstance that is one shard of a ParallelBufferPoolManager.
+   * @param pool_size the size of the buffer pool
+   * @param num_instances total number of BPIs in the parallel BPM
+   * @param instance_index index of this BPI in the parallel BPM
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param max_pool_size largest size Resize() may grow the pool to, 0 for pool_size
+   * @param replacer_policy the replacement policy
+   */
+  BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                            DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
+                            LogManager *log_manager = nullptr, size_t max_pool_size = 0,
+                            ReplacerPolicy replacer_policy = ReplacerPolicy::LRU_K);
 
   /**
    * @brief Destroy an existing BufferPoolManagerInstance.
@@ -49,9 +131,120 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /** @brief Return the size (number of frames) of the buffer pool. */
   auto GetPoolSize() -> size_t override { return pool_size_; }
 
+  /** @brief Return the largest size the buffer pool can be resized to. */
+  auto GetMaxPoolSize() const -> size_t { return max_pool_size_; }
+
+  /**
+   * @brief Change the number of frames while the buffer pool is in use.
+   *
+   * Growing makes new frames of the arena available right away. Shrinking stops handing out the frames at or above
+   * new_size, then evicts the pages in them, writing back dirty ones, as soon as their last pin is gone. It blocks
+   * until all of them are drained, while hits on those pages are still served meanwhile.
+   *
+   * @param new_size the new number of frames, between 1 and GetMaxPoolSize()
+   * @return false if new_size is out of range or another resize is in progress
+   */
+  auto Resize(size_t new_size) -> bool override;
+
   /** @brief Return the pointer to all the pages in the buffer pool. */
   auto GetPages() -> Page * { return pages_; }
 
+  /** @return the frame arena holding the pages */
+  auto GetFrameArena() -> FrameArena * { return arena_; }
+
+  /** @brief Return a snapshot of the hit / miss / eviction counters of this instance. */
+  auto GetStats() const -> BufferPoolStats;
+
+  /**
+   * @brief Queue pages to be read in by a background thread. The first call starts the thread.
+   *
+   * Prefetched pages are loaded into free or evictable frames and left unpinned. Pages that are already resident,
+   * that were never allocated, or that do not belong to this instance are skipped, and nothing is loaded if every
+   * frame is pinned.
+   */
+  void PrefetchPages(page_id_t first_page_id, size_t count, std::shared_ptr<BufferAccessStrategy> strategy) override;
+
+  /** @brief Stop and join the prefetch thread, if it is running. Queued requests are dropped. */
+  void StopPrefetcher();
+
+  /**
+   * @brief Start a background thread that writes dirty pages back before they are chosen as victims, so that most
+   * evictions find a clean frame.
+   *
+   * The cleaner wakes up every page_cleaner_interval, or when an eviction had to write a dirty page itself. It counts
+   * the frames that can be reused without a write: free frames plus clean frames among the next high_watermark
+   * victims of the replacer. If that number is below low_watermark, it writes out the dirty ones among those victims
+   * in page-id order and clears their dirty flags.
+   *
+   * @param low_watermark start cleaning when fewer than this many frames are ready for reuse
+   * @param high_watermark how many upcoming victims to look at and clean
+   */
+  void RunPageCleaner(size_t low_watermark, size_t high_watermark);
+
+  /** @brief Stop and join the page cleaner thread, if it is running. */
+  void StopPageCleaner();
+
+  /**
+   * @brief Evict victims in batches instead of one per miss.
+   *
+   * When a miss or a new page finds fewer than low_watermark free frames, it takes up to batch_size victims from the
+   * replacer at once. The dirty ones are sorted by page id and written back with one request per run of consecutive
+   * pages, then all of them go to the free list. Bulk loads and large updates that keep evicting dirty pages this way
+   * write mostly sequentially.
+   *
+   * @param low_watermark evict a batch when fewer than this many frames are free, 0 to turn batching off
+   * @param batch_size how many victims to evict at once
+   */
+  void EnableBatchEviction(size_t low_watermark, size_t batch_size);
+
+  /**
+   * @brief Keep evicted pages in a CompressedPageCache, and look misses up there before going to disk.
+   *
+   * Clean victims are handed to the cache as they are evicted, dirty ones after their write-back, both without
+   * holding the latch. Not thread-safe: call before the buffer pool is used. The cache cannot be turned off again.
+   *
+   * @param capacity_bytes most compressed bytes the cache keeps
+   */
+  void EnableVictimCache(size_t capacity_bytes);
+
+  /** @return the counters of the victim cache, all zero if there is none */
+  auto GetVictimCacheStats() -> CompressedPageCacheStats;
+
+  /**
+   * @brief Save the ids of the resident pages and their access history, so that WarmUp() can reload them after a
+   * restart. The file is written next to path and renamed over it.
+   * @param path the file to write
+   * @return false if the file could not be written
+   */
+  auto SaveHotSet(const std::string &path) -> bool;
+
+  /**
+   * @brief Start a background thread that calls SaveHotSet(path) every hot_set_dump_interval, and once more when it
+   * is stopped.
+   */
+  void RunHotSetDumper(const std::string &path);
+
+  /** @brief Save the hot set one last time, then stop and join the dumper thread, if it is running. */
+  void StopHotSetDumper();
+
+  /**
+   * @brief Reload the pages saved by SaveHotSet().
+   *
+   * Pages only go into free frames; if they do not all fit, the most recently used ones are taken. They are read in
+   * page-id order, WARM_UP_CHUNK_PAGES at a time with one request per run of consecutive pages, and the replacer
+   * gets their saved access history back. Page ids below the allocation watermark of the saved pool count as
+   * allocated from now on.
+   *
+   * @param path file written by SaveHotSet() of the same instance on the same database file
+   * @param background return right away and load the pages in a background thread while queries run, see
+   * WaitForWarmUp()
+   * @return the number of pages loaded, or to be loaded in the background; 0 if the file cannot be used
+   */
+  auto WarmUp(const std::string &path, bool background) -> size_t;
+
+  /** @brief Wait until a background WarmUp() is done. */
+  void WaitForWarmUp();
+
  protected:
   /**
    * TODO(P1): Add implementation
@@ -72,6 +265,15 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    */
   auto NewPgImp(page_id_t *page_id) -> Page * override;
 
+  /**
+   * @brief Create a new page like NewPgImp(page_id), on the deleted page of this instance closest to hint if there is
+   * one. A reused page starts out dirty, so that the zeroed page replaces the old data on disk.
+   * @param[out] page_id id of created page
+   * @param hint id of a page the new page belongs with, may be INVALID_PAGE_ID
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPgImp(page_id_t *page_id, page_id_t hint) -> Page * override;
+
   /**
    * TODO(P1): Add implementation
    *
@@ -85,11 +287,20 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    *
    * In addition, remember to disable eviction and record the access history of the frame like you did for NewPgImp().
    *
+   * A hit is served without the latch: the frame is pinned and then checked to still hold the page. The latch is only
+   * taken on a miss, or to wait for a read of the page that is still in progress.
+   *
    * @param page_id id of page to be fetched
-   * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
+   * @return nullptr if page_id cannot be fetched or was deleted, otherwise pointer to the requested page
    */
   auto FetchPgImp(page_id_t page_id) -> Page * override;
 
+  /**
+   * @brief Fetch a page like FetchPgImp(page_id), but on a miss recycle the oldest frame of the strategy's ring
+   * if it still holds the page the strategy put there and nobody uses it.
+   */
+  auto FetchPgImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * override;
+
   /**
    * TODO(P1): Add implementation
    *
@@ -105,6 +316,27 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    */
   auto UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool override;
 
+  /**
+   * @brief Fetch several pages with one latch acquisition.
+   *
+   * Hits are pinned right away. Misses get their frames under the same latch acquisition and are then read together
+   * with asynchronous requests, see LoadFrames(). Pages that are being written back by somebody else are fetched one
+   * by one at the end.
+   *
+   * @param page_ids ids of the pages to be fetched
+   * @param[out] pages the page for every entry of page_ids, nullptr for the pages that could not be fetched
+   * @return the number of pages that were fetched
+   */
+  auto FetchPgsImp(const std::vector<page_id_t> &page_ids, std::vector<Page *> *pages) -> size_t override;
+
+  /**
+   * @brief Unpin several pages with one latch acquisition.
+   * @param page_ids ids of the pages to be unpinned
+   * @param is_dirty true if the pages should be marked as dirty, false otherwise
+   * @return the number of pages that were unpinned
+   */
+  auto UnpinPgsImp(const std::vector<page_id_t> &page_ids, bool is_dirty) -> size_t override;
+
   /**
    * TODO(P1): Add implementation
    *
@@ -121,7 +353,7 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /**
    * TODO(P1): Add implementation
    *
-   * @brief Flush all the pages in the buffer pool to disk.
+   * @brief Flush all the pages in the buffer pool to disk, and sync the disk manager so that they are durable.
    */
   void FlushAllPgsImp() override;
 
@@ -133,48 +365,315 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    *
    * After deleting the page from the page table, stop tracking the frame in the replacer and add the frame
    * back to the free list. Also, reset the page's memory and metadata. Finally, you should call DeallocatePage() to
-   * imitate freeing the page on the disk.
+   * free the page on the disk, so that its id can be reused.
    *
    * @param page_id id of page to be deleted
    * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
    */
   auto DeletePgImp(page_id_t page_id) -> bool override;
 
-  /** Number of pages in the buffer pool. */
-  const size_t pool_size_;
+  /** Number of pages in the buffer pool. Frames at or above it are being drained by Resize(). */
+  std::atomic<size_t> pool_size_;
+  /** Largest number of pages the buffer pool can be resized to. */
+  const size_t max_pool_size_;
+  /** How many instances are in the parallel BPM (if present, otherwise just 1 BPI) */
+  const uint32_t num_instances_ = 1;
+  /** Index of this BPI in the parallel BPM (if present, otherwise just 0) */
+  const uint32_t instance_index_ = 0;
   /** The next page id to be allocated  */
   std::atomic<page_id_t> next_page_id_ = 0;
-  /** Bucket size for the extendible hash table */
-  const size_t bucket_size_ = 4;
 
-  /** Array of buffer pool pages. */
+  /** Frames of the buffer pool; their data lives in one aligned region. */
+  FrameArena *arena_;
+  /** Array of buffer pool pages, owned by arena_. */
   Page *pages_;
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
   /** Pointer to the log manager. Please ignore this for P1. */
   LogManager *log_manager_ __attribute__((__unused__));
   /** Page table for keeping track of buffer pool pages. */
-  ExtendibleHashTable<page_id_t, frame_id_t> *page_table_;
+  PageTable *page_table_;
   /** Replacer to find unpinned pages for replacement. */
-  LRUKReplacer *replacer_;
+  BufferPoolReplacer *replacer_;
   /** List of free frames that don't have any pages on them. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /**
+   * This latch protects the page table, the replacer, the free list, the frame metadata and the I/O state below.
+   * It is never held across a disk read or write. Hits in FetchPgImp() do not take it: they only pin the frame, see
+   * DetachPage().
+   */
   std::mutex latch_;
 
+  /** I/O state of a frame. While in_progress_ is set, the frame's data must not be used by anyone but the thread
+   * doing the I/O; the frame is pinned by that thread. It is set before the page enters the page table and written
+   * under latch_, but hits read it without. Waiters block on cv_ with latch_. */
+  struct FrameIO {
+    std::atomic<bool> in_progress_{false};
+    /** Whether the victim handed off by WriteBack() is dirty; a clean one only goes to the victim cache. */
+    bool write_back_{false};
+    std::condition_variable cv_;
+  };
+  /** One entry per frame. */
+  std::vector<FrameIO> frame_io_;
+  /** Set while Resize() drains frames. Protected by latch_. */
+  bool resizing_{false};
+  /** Wakes up Resize() when the last pin of a frame it drains is gone. Used with latch_. */
+  std::condition_variable resize_cv_;
+  /** Evicted pages whose write-back or hand-off to the victim cache is still in progress, mapped to the frame doing
+   * it. */
+  std::unordered_map<page_id_t, frame_id_t> writing_back_;
+
+  /** Prefetch thread, nullptr if not started yet. */
+  std::thread *prefetch_thread_{nullptr};
+  /** Set to false to ask the prefetch thread to exit. Protected by latch_. */
+  bool prefetch_running_{false};
+  /** Pages waiting to be prefetched. Protected by latch_. */
+  std::deque<std::pair<page_id_t, std::shared_ptr<BufferAccessStrategy>>> prefetch_queue_;
+  /** Wakes up the prefetch thread. Used with latch_. */
+  std::condition_variable prefetch_cv_;
+
+  /** Page cleaner thread, nullptr if not running. */
+  std::thread *page_cleaner_thread_{nullptr};
+  /** Set to false to ask the page cleaner to exit. Protected by latch_. */
+  bool page_cleaner_running_{false};
+  /** Page cleaner watermarks, see RunPageCleaner(). */
+  size_t cleaner_low_watermark_{0};
+  size_t cleaner_high_watermark_{0};
+  /** Wakes up the page cleaner. Used with latch_. */
+  std::condition_variable page_cleaner_cv_;
+
+  /** Hot set dumper thread, nullptr if not running. */
+  std::thread *hot_set_dumper_thread_{nullptr};
+  /** Set to false to ask the dumper to exit. Protected by latch_. */
+  bool hot_set_dumper_running_{false};
+  /** File the dumper writes to. */
+  std::string hot_set_path_;
+  /** Wakes up the dumper. Used with latch_. */
+  std::condition_variable hot_set_dumper_cv_;
+  /** Background WarmUp() thread, nullptr if none was started or it was joined. */
+  std::thread *warm_up_thread_{nullptr};
+
+  /** Batch eviction settings, see EnableBatchEviction(). Protected by latch_. */
+  size_t batch_low_watermark_{0};
+  size_t batch_size_{0};
+
+  /** Second-tier cache of evicted pages, nullptr if not enabled, see EnableVictimCache(). */
+  std::unique_ptr<CompressedPageCache> victim_cache_;
+  /** Set while a batch is being written back; others evict one frame at a time meanwhile. Protected by latch_. */
+  bool evicting_batch_{false};
+
+  /** Counters reported through GetStats(). */
+  std::atomic<uint64_t> stat_hits_{0};
+  std::atomic<uint64_t> stat_misses_{0};
+  std::atomic<uint64_t> stat_new_pages_{0};
+  std::atomic<uint64_t> stat_evictions_{0};
+  std::atomic<uint64_t> stat_write_backs_{0};
+  std::atomic<uint64_t> stat_background_write_backs_{0};
+  std::atomic<uint64_t> stat_prefetches_{0};
+  std::atomic<uint64_t> stat_ring_reuses_{0};
+  std::atomic<uint64_t> stat_no_frame_{0};
+  std::atomic<uint64_t> stat_eviction_batches_{0};
+  std::atomic<uint64_t> stat_batch_writes_{0};
+  std::atomic<uint64_t> stat_warm_up_pages_{0};
+  std::atomic<uint64_t> stat_reused_pages_{0};
+  std::atomic<uint64_t> stat_io_errors_{0};
+
   /**
-   * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Allocate a page on disk, reusing the deallocated page of this instance closest to hint if there is one.
+   * Caller should acquire the latch before calling this function.
+   * @param hint id of a page the new page belongs with, may be INVALID_PAGE_ID
+   * @param[out] reused set to true if the page was deallocated before
    * @return the id of the allocated page
    */
-  auto AllocatePage() -> page_id_t;
+  auto AllocatePage(page_id_t hint, bool *reused) -> page_id_t;
+
+  /**
+   * @brief Take a frame from the free list, or evict one through the replacer. Caller must hold the latch.
+   *
+   * If the victim is dirty, or there is a victim cache, it is registered in writing_back_ and its page id is returned
+   * in victim_page_id; the caller must then hand it off with WriteBack() and call FinishIO() before the frame can be
+   * reused by anyone else.
+   *
+   * With a strategy, the frame at the current slot of the strategy's ring is recycled instead if it still holds the
+   * page the strategy loaded and is unpinned. The caller must record the new page with BufferAccessStrategy::Put().
+   *
+   * @param[out] frame_id the frame that was acquired
+   * @param[out] victim_page_id the page that still occupies the frame and must be handed off, untouched otherwise
+   * @param strategy buffer access strategy of the caller, may be nullptr
+   * @return false if every frame is pinned
+   */
+  auto AcquireFrame(frame_id_t *frame_id, page_id_t *victim_page_id, BufferAccessStrategy *strategy = nullptr)
+      -> bool;
+
+  /**
+   * @param strategy buffer access strategy of the caller
+   * @param[out] frame_id frame at the current slot of the strategy's ring
+   * @return true if AcquireFrame() would recycle that frame
+   */
+  auto CanRecycleRingFrame(BufferAccessStrategy *strategy, frame_id_t *frame_id) -> bool;
+
+  /**
+   * @brief Drop the page held by a frame that was just taken out of the replacer, see AcquireFrame().
+   * @param frame_id the frame
+   * @param[out] victim_page_id the page that still occupies the frame and must be handed off, untouched otherwise
+   * @return false if a hit pinned the frame meanwhile, see DetachPage()
+   */
+  auto EvictFrame(frame_id_t frame_id, page_id_t *victim_page_id) -> bool;
 
   /**
-   * @brief Deallocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Take the page of an unpinned frame out of the page table. A hit may have found the page just before and
+   * pinned the frame without the latch; the page is put back then, and the frame is made non-evictable again.
+   * @param frame_id the frame
+   * @return true if the page is gone from the page table and nobody can pin it anymore
+   */
+  auto DetachPage(frame_id_t frame_id) -> bool;
+
+  /**
+   * @brief Install page_id in a frame returned by AcquireFrame(), pinned once and with its I/O in progress. Caller
+   * must hold the latch.
+   */
+  void InstallPage(page_id_t page_id, frame_id_t frame_id);
+
+  /**
+   * @brief Install page_id in a frame returned by AcquireFrame() and read it from disk, pinned once. The latch is
+   * dropped for the duration of the I/O.
+   * @param lock the held latch
+   * @param page_id page to read
+   * @param frame_id frame returned by AcquireFrame()
+   * @param victim_page_id victim returned by AcquireFrame()
+   */
+  void ReadIntoFrame(std::unique_lock<std::mutex> *lock, page_id_t page_id, frame_id_t frame_id,
+                     page_id_t victim_page_id);
+
+  /** A frame handed out by AcquireFrame() and InstallPage() whose page still has to be read. */
+  struct FrameLoad {
+    page_id_t page_id_;
+    frame_id_t frame_id_;
+    /** Victim returned by AcquireFrame(), INVALID_PAGE_ID if the frame was free. */
+    page_id_t victim_page_id_;
+  };
+
+  /**
+   * @brief Hand off the victims of several frames and read their new pages, with all writes and then all reads in
+   * flight at once through the disk manager's asynchronous requests. A single miss goes through ReadIntoFrame()
+   * instead, for which the hand-off to the I/O engine would only add latency. Must be called without holding the
+   * latch; the caller calls FinishIO() for every frame afterwards. A victim whose write fails is written once more,
+   * synchronously, before its frame is read over.
+   * @param loads the frames, in the order to issue the reads in
+   */
+  void LoadFrames(const std::vector<FrameLoad> &loads);
+
+  /** @brief Unpin a page, see UnpinPgImp(). Caller must hold the latch. */
+  auto UnpinLocked(page_id_t page_id, bool is_dirty) -> bool;
+
+  /**
+   * @brief Write the victim held by the frame to disk if it is dirty, and give it to the victim cache if there is
+   * one. Must be called without holding the latch.
+   */
+  void WriteBack(page_id_t victim_page_id, frame_id_t frame_id);
+
+  /** @brief Read a page that is not resident, from the victim cache or from disk. */
+  void ReadPageData(page_id_t page_id, char *data);
+
+  /** @brief Wait until the write-back of an evicted page in writing_back_ is done. Caller must hold the latch. */
+  void WaitForWriteBack(std::unique_lock<std::mutex> *lock, page_id_t page_id);
+
+  /** @brief Mark the I/O of a frame as done and wake up its waiters. Caller must hold the latch. */
+  void FinishIO(page_id_t victim_page_id, frame_id_t frame_id);
+
+  /**
+   * @brief Write a resident frame to disk, dropping the latch for the duration of the write.
+   * @param lock the held latch, released and re-acquired around the write
+   * @param frame_id frame to be flushed
+   */
+  void FlushFrame(std::unique_lock<std::mutex> *lock, frame_id_t frame_id);
+
+  /**
+   * @brief Write several resident frames to disk with all writes in flight at once, dropping the latch for the
+   * duration of the writes. A frame whose write fails is marked dirty again.
+   * @param lock the held latch, released and re-acquired around the writes
+   * @param frame_ids frames to be flushed, in the order to issue the writes in
+   */
+  void FlushFrames(std::unique_lock<std::mutex> *lock, const std::vector<frame_id_t> &frame_ids);
+
+  /**
+   * @brief Called when the pin count of a frame drops to zero: make the frame evictable, or wake up Resize() if it is
+   * draining the frame. Caller must hold the latch.
+   */
+  void ReleaseFrame(frame_id_t frame_id);
+
+  /**
+   * @brief Evict the pages in frames [new_size, old_size) as they become unpinned, until all of those frames are
+   * empty. Caller must hold the latch, which is released while waiting and while writing dirty pages back.
+   */
+  void DrainFrames(std::unique_lock<std::mutex> *lock, size_t new_size, size_t old_size);
+
+  /** @return true if the free list ran low and a batch of victims should be evicted. Caller must hold the latch. */
+  auto NeedsBatchEviction() -> bool;
+
+  /**
+   * @brief Evict a batch of victims into the free list, writing the dirty ones back in page-id order with runs of
+   * consecutive pages coalesced, see EnableBatchEviction().
+   * @param lock the held latch, released and re-acquired around the writes
+   */
+  void EvictBatch(std::unique_lock<std::mutex> *lock);
+
+  /** A page saved by SaveHotSet(), with the access history the replacer had for it. */
+  struct HotPage {
+    page_id_t page_id_;
+    std::vector<uint64_t> history_;
+  };
+
+  /** @brief Body of the hot set dumper thread. */
+  void HotSetDumperLoop();
+
+  /**
+   * @brief Load saved pages into free frames, see WarmUp().
+   * @param hot_pages the pages to load, sorted by page id
+   * @return the number of pages loaded
+   */
+  auto LoadHotSet(const std::vector<HotPage> &hot_pages) -> size_t;
+
+  /** @brief Body of the prefetch thread. */
+  void PrefetchLoop();
+
+  /**
+   * @brief Hand out a frame for a page to be prefetched, see PrefetchPages(). The caller reads the page with
+   * LoadFrames(), and leaves the frame unpinned after FinishIO().
+   * @param lock the held latch, which a batch eviction may release and re-acquire
+   * @param page_id page to prefetch
+   * @param strategy buffer access strategy the page is read for, may be nullptr
+   * @param[out] loads receives the frame, unless the page is resident, unallocated or no frame is available
+   *
+   * A prefetch for a strategy only takes a free frame or a frame of the ring. Evicting from the replacer would pick
+   * the pages prefetched before, which have a single access and are the first LRU-K victims, and the scan would read
+   * them twice.
+   */
+  void StartPrefetch(std::unique_lock<std::mutex> *lock, page_id_t page_id, BufferAccessStrategy *strategy,
+                     std::vector<FrameLoad> *loads);
+
+  /** @brief Body of the page cleaner thread. */
+  void PageCleanerLoop();
+
+  /**
+   * @brief One round of the page cleaner, see RunPageCleaner().
+   * @param lock the held latch, released and re-acquired around the writes
+   */
+  void CleanFrames(std::unique_lock<std::mutex> *lock);
+
+  /**
+   * @brief Validate that the page_id being used is accessible to this BPI. This is only meaningful when the BPI is
+   * one shard of a ParallelBufferPoolManager.
+   * @param page_id page id to validate
+   */
+  void ValidatePageId(page_id_t page_id) const;
+
+  /**
+   * @brief Deallocate a page on disk. Caller should acquire the latch before calling this function, so that the page
+   * cannot be prefetched between leaving the page table and entering the free page map.
    * @param page_id id of the page to deallocate
    */
-  void DeallocatePage(__attribute__((unused)) page_id_t page_id) {
-    // This is a no-nop right now without a more complex data structure to track deallocated pages
-  }
+  void DeallocatePage(page_id_t page_id) { disk_manager_->DeallocatePage(page_id); }
 
   // TODO(student): You may add additional private members and helper functions
 };
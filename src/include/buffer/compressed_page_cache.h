@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache.h
+//
+// Identification: src/include/buffer/compressed_page_cache.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/** Counters of a CompressedPageCache. */
+struct CompressedPageCacheStats {
+  /** Lookups that found the page. */
+  uint64_t hits_{0};
+  /** Lookups that did not. */
+  uint64_t misses_{0};
+  /** Pages stored. */
+  uint64_t inserts_{0};
+  /** Pages not stored because they did not compress to MAX_COMPRESSED_SIZE. */
+  uint64_t rejects_{0};
+  /** Pages dropped to make room. */
+  uint64_t evictions_{0};
+  /** Size of the stored pages, before and after compression. */
+  uint64_t uncompressed_bytes_{0};
+  uint64_t compressed_bytes_{0};
+  /** Pages and compressed bytes held right now. */
+  uint64_t pages_{0};
+  uint64_t bytes_{0};
+
+  /** @return the average compression ratio of the stored pages */
+  auto CompressionRatio() const -> double {
+    return compressed_bytes_ == 0 ? 0 : uncompressed_bytes_ / static_cast<double>(compressed_bytes_);
+  }
+};
+
+/**
+ * CompressedPageCache is a second-tier page cache between a buffer pool and its disk manager. It keeps pages evicted
+ * from the pool LZ-compressed in memory, so that a pool of a given size keeps several times as many pages away from
+ * the disk.
+ *
+ * The cache is exclusive: a page that is found is handed back to the pool and removed from the cache, and comes back
+ * when it is evicted again. The buffer pool only inserts pages whose on-disk copy is current, and replaces or erases
+ * the entry of every page it evicts or deletes, so an entry is never older than the disk. When the cache is full the
+ * least recently inserted pages are dropped; they are on disk already.
+ *
+ * All methods are thread-safe. Pages are compressed and decompressed outside of the latch.
+ */
+class CompressedPageCache {
+ public:
+  /** Pages that do not compress at least this well are not worth keeping. */
+  static constexpr size_t MAX_COMPRESSED_SIZE = BUSTUB_PAGE_SIZE * 3 / 4;
+
+  /**
+   * @brief Create an empty cache.
+   * @param capacity_bytes most compressed bytes to keep
+   */
+  explicit CompressedPageCache(size_t capacity_bytes);
+
+  DISALLOW_COPY_AND_MOVE(CompressedPageCache);
+
+  /**
+   * @brief Store a page, replacing the entry of the page if there is one. A page that does not compress well enough
+   * only removes the old entry.
+   * @param page_id the page
+   * @param data BUSTUB_PAGE_SIZE bytes of page data, identical to the page on disk
+   */
+  void Insert(page_id_t page_id, const char *data);
+
+  /**
+   * @brief Take a page out of the cache.
+   * @param page_id the page to look up
+   * @param[out] data receives BUSTUB_PAGE_SIZE bytes of page data on a hit
+   * @return true on a hit
+   */
+  auto Lookup(page_id_t page_id, char *data) -> bool;
+
+  /** @brief Drop the entry of a page, if there is one. */
+  void Erase(page_id_t page_id);
+
+  /** @return the counters of the cache */
+  auto GetStats() -> CompressedPageCacheStats;
+
+ private:
+  using EntryList = std::list<std::pair<page_id_t, std::vector<char>>>;
+
+  /**
+   * @brief Remove an entry. Caller holds latch_.
+   * @return the compressed page of the entry
+   */
+  auto EraseLocked(EntryList::iterator it) -> std::vector<char>;
+
+  std::mutex latch_;
+  const size_t capacity_bytes_;
+  /** Compressed pages, most recently inserted first. */
+  EntryList entries_;
+  std::unordered_map<page_id_t, EntryList::iterator> index_;
+  CompressedPageCacheStats stats_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.h
+//
+// Identification: src/include/buffer/frame_arena.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * FrameArena holds the frames of a buffer pool manager instance.
+ *
+ * Frame data and frame book-keeping are kept apart. The data of all frames is one anonymous mapping, so every frame
+ * starts on an OS page boundary, frame i starts i * BUSTUB_PAGE_SIZE bytes into the region, and the region can be
+ * used for direct I/O. The Page objects holding pin counts, dirty flags and latches sit in a separate, densely packed
+ * array and point into the region.
+ *
+ * Regions of at least one huge page are backed by huge pages to cut TLB misses at large pool sizes: first explicit
+ * huge pages (MAP_HUGETLB), which need pages reserved by the administrator, then transparent huge pages on a region
+ * aligned to the huge page size, and regular pages if neither is available. Explicit huge pages are reserved for the
+ * whole region and cannot be handed back, so an arena that may grow beyond its initial size never uses them.
+ *
+ * The arena can be resized between zero and max_frames frames. The region is mapped for max_frames up front, so the
+ * frames never move, but memory is only committed for frames that are used; Resize() gives the memory of frames it
+ * drops back to the OS.
+ */
+class FrameArena {
+ public:
+  /** How the data region is backed. */
+  enum class Backing { REGULAR, TRANSPARENT_HUGE_PAGES, HUGETLB };
+
+  /** Huge page size assumed for alignment and rounding. */
+  static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+  /**
+   * @brief Map the data region and create the pages.
+   * @param num_frames number of frames
+   * @param use_huge_pages whether to try huge pages at all
+   * @param max_frames largest number of frames Resize() may grow the arena to, 0 for num_frames
+   * @throws Exception if the region cannot be mapped
+   */
+  explicit FrameArena(size_t num_frames, bool use_huge_pages = true, size_t max_frames = 0);
+
+  ~FrameArena();
+
+  DISALLOW_COPY_AND_MOVE(FrameArena);
+
+  /** @return the array of num_frames pages */
+  auto GetPages() -> Page * { return pages_; }
+
+  /** @return the start of the data region */
+  auto GetData() -> char * { return data_; }
+
+  /** @return the number of frames */
+  auto GetNumFrames() const -> size_t { return num_frames_; }
+
+  /** @return the largest number of frames the arena can hold */
+  auto GetMaxFrames() const -> size_t { return max_frames_; }
+
+  /**
+   * @brief Create the pages of new frames, or destroy the pages of the last frames and release their memory. The
+   * caller must make sure that nobody uses the frames that are dropped.
+   * @param num_frames new number of frames, at most GetMaxFrames()
+   */
+  void Resize(size_t num_frames);
+
+  /** @return the number of bytes mapped for max_frames frames, rounded up to the page size backing the region */
+  auto GetMappedSize() const -> size_t { return mapped_size_; }
+
+  /** @return how the data region is backed */
+  auto GetBacking() const -> Backing { return backing_; }
+
+  /** @return a printable name of a backing */
+  static auto BackingToString(Backing backing) -> const char *;
+
+ private:
+  /** @brief Map size bytes, aligned to alignment, into data_. Returns false if the mapping failed. */
+  auto MapAligned(size_t size, size_t alignment) -> bool;
+
+  size_t num_frames_;
+  const size_t max_frames_;
+  char *data_{nullptr};
+  size_t mapped_size_{0};
+  Backing backing_{Backing::REGULAR};
+  Page *pages_{nullptr};
+};
+
+}  // namespace bustub
@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// ghost_list.h
+//
+// Identification: src/include/buffer/ghost_list.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <unordered_map>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * GhostList remembers the ids of pages that were evicted recently, most recent first, without their data. ARC and 2Q
+ * use it to recognize pages that come back soon after they were evicted.
+ */
+class GhostList {
+ public:
+  /** @return whether the page is remembered */
+  auto Contains(page_id_t page_id) const -> bool { return index_.count(page_id) != 0; }
+
+  /** @brief Remember a page as the most recently evicted one. */
+  void PushFront(page_id_t page_id) {
+    Erase(page_id);
+    pages_.push_front(page_id);
+    index_[page_id] = pages_.begin();
+  }
+
+  /** @brief Forget the page that was evicted longest ago. */
+  void PopBack() {
+    index_.erase(pages_.back());
+    pages_.pop_back();
+  }
+
+  /** @return whether the page was remembered */
+  auto Erase(page_id_t page_id) -> bool {
+    auto it = index_.find(page_id);
+    if (it == index_.end()) {
+      return false;
+    }
+    pages_.erase(it->second);
+    index_.erase(it);
+    return true;
+  }
+
+  /** @return the number of remembered pages */
+  auto Size() const -> size_t { return pages_.size(); }
+
+ private:
+  std::list<page_id_t> pages_;
+  std::unordered_map<page_id_t, std::list<page_id_t>::iterator> index_;
+};
+
+}  // namespace bustub
@@ -12,17 +12,17 @@
 
 #pragma once
 
-#include <algorithm>
 #include <limits>
-#include <list>
 #include <mutex>  // NOLINT
-#include <queue>
-#include <unordered_map>
+#include <set>
+#include <utility>
 #include <vector>
+
+#include "buffer/access_buffer.h"
+#include "buffer/replacer.h"
 #include "common/config.h"
 #include "common/logger.h"
 #include "common/macros.h"
-#include "common/rwlatch.h"
 namespace bustub {
 
 /**
@@ -35,32 +35,18 @@ namespace bustub {
  * A frame with less than k historical references is given
  * +inf as its backward k-distance. When multiple frames have +inf backward k-distance,
  * classical LRU algorithm is used to choose victim.
+ *
+ * Evictable frames are kept in two ordered sets, so that no operation has to look at every frame:
+ * - history_list_ holds frames with less than k accesses, ordered by their earliest access (FIFO);
+ * - cache_list_ holds frames with k accesses, ordered by their kth most recent access.
+ * The access history of every frame is a fixed-size ring buffer of k timestamps.
+ *
+ * Accesses do not take the latch. They are timestamped and queued in an AccessBuffer, and applied in timestamp order
+ * by the next call that needs an up-to-date picture (Evict, SetEvictable, Remove, ...), so every eviction decision
+ * sees all accesses recorded before it. Only when a thread's ring buffer is full does an access drain the buffer
+ * under the latch itself.
  */
-class FrameInfo {
- private:
-  size_t k_;
-  frame_id_t frame_id_;
-  std::list<std::size_t> accesses_;
-  bool is_evictable_ = false;
-
- public:
-  explicit FrameInfo(size_t k = 2, frame_id_t frame_id = 0);
-  auto HasK() -> bool;
-  auto IsEvictable() -> bool;
-  auto SetEvictable(bool set_evictable) -> void;
-  auto PushBack(size_t access) -> void;
-  auto GetFront() -> size_t;
-  auto PopFront() -> void;
-  auto GetBack() -> size_t;
-  auto GetSize() -> size_t;
-  auto GetId() -> frame_id_t;
-};
-// auto Compare(FrameInfo *f1, FrameInfo *f2) -> bool;
-class Compare {
- public:
-  auto operator()(FrameInfo *f1, FrameInfo *f2) -> bool;
-};
-class LRUKReplacer {
+class LRUKReplacer : public BufferPoolReplacer {
  public:
   /**
    *
@@ -78,7 +64,7 @@ class LRUKReplacer {
    *
    * @brief Destroys the LRUReplacer.
    */
-  ~LRUKReplacer() = default;
+  ~LRUKReplacer() override = default;
 
   /**
    * TODO(P1): Add implementation
@@ -96,7 +82,7 @@ class LRUKReplacer {
    * @param[out] frame_id id of frame that is evicted.
    * @return true if a frame is evicted successfully, false if no frames can be evicted.
    */
-  auto Evict(frame_id_t *frame_id) -> bool;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
   /**
    * TODO(P1): Add implementation
@@ -111,6 +97,12 @@ class LRUKReplacer {
    */
   void RecordAccess(frame_id_t frame_id);
 
+  /** @brief LRU-K only looks at frames, the page id is ignored. */
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id) override { RecordAccess(frame_id); }
+
+  /** @brief Record an access and a pin in one event, without taking the latch. */
+  void RecordAccessAndPin(frame_id_t frame_id, page_id_t page_id) override;
+
   /**
    * TODO(P1): Add implementation
    *
@@ -128,7 +120,7 @@ class LRUKReplacer {
    * @param frame_id id of frame whose 'evictable' status will be modified
    * @param set_evictable whether the given frame is evictable or not
    */
-  void SetEvictable(frame_id_t frame_id, bool set_evictable);
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
 
   /**
    * TODO(P1): Add implementation
@@ -147,7 +139,16 @@ class LRUKReplacer {
    *
    * @param frame_id id of frame to be removed
    */
-  void Remove(frame_id_t frame_id);
+  void Remove(frame_id_t frame_id) override;
+
+  /**
+   * @brief Return up to max_frames evictable frames in the order Evict() would pick them, without evicting anything.
+   * Used by the buffer pool page cleaner to find the dirty pages that are about to be replaced.
+   *
+   * @param max_frames maximum number of frames to return
+   * @return the next victims, first victim first
+   */
+  auto GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
 
   /**
    * TODO(P1): Add implementation
@@ -156,18 +157,60 @@ class LRUKReplacer {
    *
    * @return size_t
    */
-  auto Size() -> size_t;
+  auto Size() -> size_t override;
+
+  auto GetAccessHistory(frame_id_t frame_id) -> std::vector<uint64_t> override;
+
+  void RestoreAccessHistory(frame_id_t frame_id, page_id_t page_id, const std::vector<uint64_t> &history) override;
 
  private:
-  // TODO(student): implement me! You can replace these member variables as you like.
-  // Remove maybe_unused if you start using them.
-  [[maybe_unused]] size_t current_timestamp_{0};
-  [[maybe_unused]] size_t curr_size_{0};
-  [[maybe_unused]] size_t replacer_size_;
-  [[maybe_unused]] size_t k_;
-  std::unordered_map<frame_id_t, FrameInfo> cache_;
+  /** Bookkeeping for a single frame. The timestamps themselves live in history_. */
+  struct FrameInfo {
+    /** Number of recorded accesses, saturates at k. */
+    size_t count_{0};
+    /** Ring buffer slot that receives the next access. */
+    size_t next_{0};
+    bool is_evictable_{false};
+  };
+
+  /** (timestamp, frame id); the timestamp is the eviction key of the frame. */
+  using EvictKey = std::pair<size_t, frame_id_t>;
+
+  /** @return the eviction key of the frame: its earliest access if it has less than k accesses, its kth most recent
+   * access otherwise. In both cases this is the oldest timestamp still held in the ring buffer. */
+  auto GetKey(frame_id_t frame_id) const -> EvictKey;
+
+  /** Insert / erase an evictable frame into / from the ordered set it currently belongs to. */
+  void Link(frame_id_t frame_id);
+  void Unlink(frame_id_t frame_id);
+
+  /** @brief Queue an access, or apply it right away if the buffer is full. */
+  void Record(frame_id_t frame_id, bool pin);
+
+  /** @brief Apply the buffered accesses, and then extra if given. Requires latch_. */
+  void DrainAccesses(const AccessBuffer::Event *extra = nullptr);
+
+  /** @brief Apply a single access. Requires latch_. */
+  void ApplyAccess(const AccessBuffer::Event &event);
+
+  /** @brief SetEvictable() without the latch. */
+  void SetEvictableLocked(frame_id_t frame_id, bool set_evictable);
+
+  size_t curr_size_{0};
+  size_t replacer_size_;
+  size_t k_;
+  std::vector<FrameInfo> frames_;
+  /** replacer_size_ ring buffers of k timestamps each, laid out back to back. */
+  std::vector<size_t> history_;
+  /** Evictable frames with less than k accesses. */
+  std::set<EvictKey> history_list_;
+  /** Evictable frames with k accesses. */
+  std::set<EvictKey> cache_list_;
+  /** Accesses that are not applied yet; they carry the timestamps used in history_. */
+  AccessBuffer accesses_;
+  /** Scratch space for DrainAccesses(). */
+  std::vector<AccessBuffer::Event> drained_;
   std::mutex latch_;
-  ReaderWriterLatch rw_latch_;
 };
 
 }  // namespace bustub
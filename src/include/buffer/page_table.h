@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.h
+//
+// Identification: src/include/buffer/page_table.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * PageTable maps the pages resident in a buffer pool to their frames.
+ *
+ * The table is split into NUM_STRIPES stripes by the hash of the page id. Every stripe is a flat open-addressing
+ * array with linear probing and its own latch, so a lookup takes one uncontended latch and touches one or two cache
+ * lines, and lookups of different pages rarely share a latch. Removal shifts the following entries back instead of
+ * leaving tombstones, so the probe sequences stay short no matter how often pages come and go. A stripe doubles its
+ * array when it becomes half full.
+ */
+class PageTable {
+ public:
+  /**
+   * @brief Create a page table.
+   * @param expected_size number of pages the table is expected to hold at once, usually the pool size
+   */
+  explicit PageTable(size_t expected_size);
+
+  DISALLOW_COPY_AND_MOVE(PageTable);
+
+  /**
+   * @brief Find the frame holding a page.
+   * @param page_id the page to look up
+   * @param[out] frame_id the frame holding the page
+   * @return true if the page is in the table
+   */
+  auto Find(page_id_t page_id, frame_id_t &frame_id) -> bool;
+
+  /**
+   * @brief Map a page to a frame, replacing the existing mapping of the page if there is one.
+   * @param page_id the page
+   * @param frame_id the frame holding the page
+   */
+  void Insert(page_id_t page_id, frame_id_t frame_id);
+
+  /**
+   * @brief Remove the mapping of a page.
+   * @param page_id the page
+   * @return true if the page was in the table
+   */
+  auto Remove(page_id_t page_id) -> bool;
+
+  /** @return the number of pages in the table */
+  auto Size() -> size_t;
+
+ private:
+  static constexpr size_t NUM_STRIPES = 16;
+  static constexpr int STRIPE_BITS = 4;
+
+  struct Slot {
+    page_id_t page_id_{INVALID_PAGE_ID};
+    frame_id_t frame_id_{-1};
+  };
+
+  struct alignas(64) Stripe {
+    std::mutex latch_;
+    std::vector<Slot> slots_;
+    size_t size_{0};
+  };
+
+  /**
+   * @brief The finalizer of murmur3; the high bits pick the stripe, the low bits the home slot within the stripe. Every
+   * bit of the page id reaches both, the pages of one instance of a parallel buffer pool share their low bits.
+   */
+  static auto Hash(page_id_t page_id) -> uint32_t {
+    auto hash = static_cast<uint32_t>(page_id);
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6BU;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35U;
+    hash ^= hash >> 16;
+    return hash;
+  }
+
+  auto GetStripe(uint32_t hash) -> Stripe & { return stripes_[hash >> (32 - STRIPE_BITS)]; }
+
+  /** @return index of the slot holding page_id, or of the empty slot ending its probe sequence */
+  static auto Probe(const Stripe &stripe, page_id_t page_id, uint32_t hash) -> size_t;
+
+  /** @brief Double the slots of a stripe and re-insert its pages. Caller holds the stripe latch. */
+  static void Grow(Stripe *stripe);
+
+  std::vector<Stripe> stripes_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,170 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.h
+//
+// Identification: src/include/buffer/parallel_buffer_pool_manager.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/config.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * ParallelBufferPoolManager shards pages across several BufferPoolManagerInstances so that threads working on
+ * different pages do not contend on a single latch. A page always lives in the instance `page_id % num_instances`,
+ * and NewPage allocation is spread across the instances in a round-robin fashion.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * @brief Creates a new ParallelBufferPoolManager.
+   * @param num_instances the number of individual BufferPoolManagerInstances to store
+   * @param pool_size the pool size of each BufferPoolManagerInstance
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer of every instance
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param max_pool_size largest size each BufferPoolManagerInstance may be resized to, 0 for pool_size
+   * @param replacer_policy the replacement policy of every instance
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            size_t replacer_k = LRUK_REPLACER_K, LogManager *log_manager = nullptr,
+                            size_t max_pool_size = 0, ReplacerPolicy replacer_policy = ReplacerPolicy::LRU_K);
+
+  /**
+   * @brief Destroy an existing ParallelBufferPoolManager.
+   */
+  ~ParallelBufferPoolManager() override = default;
+
+  /** @brief Return the total number of frames across all instances. */
+  auto GetPoolSize() -> size_t override;
+
+  /** @brief Forward every page of the range to the instance that owns it. */
+  void PrefetchPages(page_id_t first_page_id, size_t count, std::shared_ptr<BufferAccessStrategy> strategy) override;
+
+  /**
+   * @brief Resize every instance to an equal share of new_size; the first instances get one frame more if new_size
+   * does not divide evenly. Nothing is resized if a share is out of range for its instance.
+   */
+  auto Resize(size_t new_size) -> bool override;
+
+  /** @brief Return the number of BufferPoolManagerInstances. */
+  auto GetNumInstances() const -> size_t { return instances_.size(); }
+
+  /**
+   * @brief Return the instance responsible for the given page id.
+   * @param page_id id of page
+   * @return pointer to the BufferPoolManagerInstance that is responsible for handling the given page id
+   */
+  auto GetBufferPoolManager(page_id_t page_id) -> BufferPoolManagerInstance *;
+
+  /**
+   * @brief Return the counters of a single shard.
+   * @param instance_index index of the shard, must be smaller than GetNumInstances()
+   */
+  auto GetInstanceStats(size_t instance_index) const -> BufferPoolStats;
+
+  /** @brief Return the counters summed over all shards. */
+  auto GetStats() const -> BufferPoolStats;
+
+ protected:
+  /**
+   * @brief Fetch the requested page from the instance that owns it.
+   * @param page_id id of page to be fetched
+   * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
+   */
+  auto FetchPgImp(page_id_t page_id) -> Page * override;
+
+  /**
+   * @brief Fetch a page from the responsible instance, which uses its own ring of the strategy.
+   */
+  auto FetchPgImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * override;
+
+  /**
+   * @brief Unpin the target page through the instance that owns it.
+   * @param page_id id of page to be unpinned
+   * @param is_dirty true if the page should be marked as dirty, false otherwise
+   * @return false if the page pin count is <= 0 before this call, true otherwise
+   */
+  auto UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool override;
+
+  /**
+   * @brief Fetch several pages, handing every instance its share of page_ids in one call.
+   * @param page_ids ids of the pages to be fetched
+   * @param[out] pages the page for every entry of page_ids, nullptr for the pages that could not be fetched
+   * @return the number of pages that were fetched
+   */
+  auto FetchPgsImp(const std::vector<page_id_t> &page_ids, std::vector<Page *> *pages) -> size_t override;
+
+  /**
+   * @brief Unpin several pages, handing every instance its share of page_ids in one call.
+   * @param page_ids ids of the pages to be unpinned
+   * @param is_dirty true if the pages should be marked as dirty, false otherwise
+   * @return the number of pages that were unpinned
+   */
+  auto UnpinPgsImp(const std::vector<page_id_t> &page_ids, bool is_dirty) -> size_t override;
+
+  /**
+   * @brief Flush the target page through the instance that owns it.
+   * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
+   * @return false if the page could not be found in the page table, true otherwise
+   */
+  auto FlushPgImp(page_id_t page_id) -> bool override;
+
+  /**
+   * @brief Create a new page. Instances are tried in round-robin order, starting from a different instance on every
+   * call, until one of them has a free or evictable frame.
+   * @param[out] page_id id of created page
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPgImp(page_id_t *page_id) -> Page * override;
+
+  /**
+   * @brief Create a new page close to hint. The instance that owns the free page closest to hint goes first; without
+   * a free page, instances are tried in round-robin order like NewPgImp(page_id).
+   * @param[out] page_id id of created page
+   * @param hint id of a page the new page belongs with, may be INVALID_PAGE_ID
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPgImp(page_id_t *page_id, page_id_t hint) -> Page * override;
+
+  /**
+   * @brief Delete the target page through the instance that owns it.
+   * @param page_id id of page to be deleted
+   * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
+   */
+  auto DeletePgImp(page_id_t page_id) -> bool override;
+
+  /**
+   * @brief Flush all the pages of every instance to disk.
+   */
+  void FlushAllPgsImp() override;
+
+ private:
+  /** The shards. The instance at index i only ever owns page ids with page_id % num_instances == i. */
+  std::vector<std::unique_ptr<BufferPoolManagerInstance>> instances_;
+  /** The disk manager the instances share, for the free pages a hint may reuse. */
+  DiskManager *disk_manager_;
+  /** Instance to start the next NewPage search from. */
+  std::atomic<size_t> next_instance_{0};
+
+  /** @return for every instance, the positions in page_ids of the pages it owns */
+  auto GroupByInstance(const std::vector<page_id_t> &page_ids) const -> std::vector<std::vector<size_t>>;
+};
+
+}  // namespace bustub
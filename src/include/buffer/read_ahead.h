@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// read_ahead.h
+//
+// Identification: src/include/buffer/read_ahead.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * ReadAhead issues BufferPoolManager::PrefetchPages() hints for a scan that walks a chain of pages.
+ *
+ * The window starts at one page and doubles every time the scan moves to the page right after the current one, up to
+ * READ_AHEAD_MAX_PAGES or a quarter of the buffer pool, whichever is smaller. Any other jump resets it. Pages that were
+ * already requested are not requested again. A scan with a buffer access strategy reads ahead into its ring, so the
+ * window is also kept to half the ring; otherwise prefetched pages would recycle each other before they are read.
+ */
+class ReadAhead {
+ public:
+  ReadAhead() = default;
+
+  explicit ReadAhead(BufferPoolManager *bpm, std::shared_ptr<BufferAccessStrategy> strategy = nullptr)
+      : bpm_(bpm),
+        strategy_(std::move(strategy)),
+        max_window_(bpm == nullptr ? 0 : std::min<size_t>(READ_AHEAD_MAX_PAGES, bpm->GetPoolSize() / 4)) {
+    if (strategy_ != nullptr) {
+      max_window_ = std::min(max_window_, strategy_->GetRingSize() / 2);
+    }
+  }
+
+  /**
+   * @brief Tell the read-ahead that the scan moves from one page to another.
+   * @param cur_page_id page the scan is leaving, INVALID_PAGE_ID when the scan starts
+   * @param next_page_id page the scan is about to read
+   */
+  void Advance(page_id_t cur_page_id, page_id_t next_page_id) {
+    if (bpm_ == nullptr || max_window_ == 0 || next_page_id == INVALID_PAGE_ID) {
+      return;
+    }
+    if (cur_page_id != INVALID_PAGE_ID && next_page_id == cur_page_id + 1) {
+      window_ = std::min(window_ * 2, max_window_);
+    } else {
+      window_ = 1;
+      prefetched_until_ = next_page_id + 1;
+    }
+    // The page right after next_page_id is the first one the scan does not read yet.
+    page_id_t first = std::max(prefetched_until_, next_page_id + 1);
+    page_id_t last = next_page_id + 1 + static_cast<page_id_t>(window_);
+    if (first < last) {
+      bpm_->PrefetchPages(first, static_cast<size_t>(last - first), strategy_);
+      prefetched_until_ = last;
+    }
+  }
+
+ private:
+  BufferPoolManager *bpm_{nullptr};
+  std::shared_ptr<BufferAccessStrategy> strategy_;
+  size_t max_window_{0};
+  size_t window_{1};
+  page_id_t prefetched_until_{INVALID_PAGE_ID};
+};
+
+}  // namespace bustub
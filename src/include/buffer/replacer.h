@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "common/config.h"
 
 namespace bustub {
@@ -47,4 +50,84 @@ class Replacer {
   virtual auto Size() -> size_t = 0;
 };
 
+/** Replacement policies a BufferPoolManagerInstance can be created with. */
+enum class ReplacerPolicy { LRU_K, ARC, TWO_Q, W_TINY_LFU };
+
+/**
+ * BufferPoolReplacer is the interface through which a buffer pool manager instance picks the frames it evicts.
+ *
+ * The buffer pool reports every access to a frame along with the page in it, marks frames evictable while they are
+ * unpinned, and asks for a victim among the evictable frames when it runs out of free frames. A frame holds a
+ * different page after every eviction, so policies that remember pages which are no longer resident (ARC, 2Q,
+ * W-TinyLFU) key that history by page id.
+ */
+class BufferPoolReplacer {
+ public:
+  BufferPoolReplacer() = default;
+  virtual ~BufferPoolReplacer() = default;
+
+  /**
+   * @brief Pick an evictable frame according to the policy and stop tracking it.
+   * @param[out] frame_id id of the evicted frame
+   * @return true if a frame was evicted, false if no frame is evictable
+   */
+  virtual auto Evict(frame_id_t *frame_id) -> bool = 0;
+
+  /**
+   * @brief Record an access to the page held by the frame. If the frame held no page or another page before, the
+   * page has just been brought into the frame.
+   */
+  virtual void RecordAccess(frame_id_t frame_id, page_id_t page_id) = 0;
+
+  /** @brief Toggle whether a frame may be evicted. Size() counts the evictable frames. */
+  virtual void SetEvictable(frame_id_t frame_id, bool set_evictable) = 0;
+
+  /**
+   * @brief Record an access and make the frame non-evictable, which is what the buffer pool does on every pin.
+   * Replacers that buffer accesses can do both without taking their latch.
+   */
+  virtual void RecordAccessAndPin(frame_id_t frame_id, page_id_t page_id) {
+    RecordAccess(frame_id, page_id);
+    SetEvictable(frame_id, false);
+  }
+
+  /** @brief Stop tracking an evictable frame without evicting it, e.g. because its page was deleted. */
+  virtual void Remove(frame_id_t frame_id) = 0;
+
+  /** @return up to max_frames evictable frames, in about the order Evict() would pick them */
+  virtual auto GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> = 0;
+
+  /** @return the number of evictable frames */
+  virtual auto Size() -> size_t = 0;
+
+  /**
+   * @brief Return the timestamps of the last accesses to a frame, oldest first, so that they can be saved across a
+   * restart. Policies that keep no per-frame timestamps return nothing.
+   */
+  virtual auto GetAccessHistory(frame_id_t frame_id) -> std::vector<uint64_t> { return {}; }
+
+  /**
+   * @brief Start tracking a frame whose page was reloaded after a restart, with the history GetAccessHistory()
+   * returned before. Later accesses count as newer than the restored ones. The frame is left non-evictable; the
+   * default records a single access.
+   */
+  virtual void RestoreAccessHistory(frame_id_t frame_id, page_id_t page_id, const std::vector<uint64_t> &history) {
+    RecordAccessAndPin(frame_id, page_id);
+  }
+};
+
+/**
+ * @brief Create a replacer for a buffer pool. The caller owns the replacer.
+ * @param policy the replacement policy
+ * @param num_frames the maximum number of frames the replacer will be required to store
+ * @param k the lookback constant k, only used by LRU-K
+ */
+auto CreateReplacer(ReplacerPolicy policy, size_t num_frames, size_t k) -> BufferPoolReplacer *;
+
+/** @return the name of a policy as accepted by ReplacerPolicyFromString() */
+auto ReplacerPolicyToString(ReplacerPolicy policy) -> const char *;
+
+/** @return false if name is not one of "lru-k", "arc", "2q" and "w-tinylfu" */
+auto ReplacerPolicyFromString(const std::string &name, ReplacerPolicy *policy) -> bool;
+
 }  // namespace bustub
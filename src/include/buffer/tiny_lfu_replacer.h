@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tiny_lfu_replacer.h
+//
+// Identification: src/include/buffer/tiny_lfu_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * FrequencySketch estimates how often pages were accessed recently, in 16 bytes per frame.
+ *
+ * It is a count-min sketch of DEPTH rows of counters that saturate at MAX_COUNT; the estimate of a page is the
+ * smallest of its counters. After a sample of ten accesses per frame, all counters are halved, so that old
+ * popularity fades out.
+ */
+class FrequencySketch {
+ public:
+  static constexpr size_t DEPTH = 4;
+  static constexpr uint8_t MAX_COUNT = 15;
+
+  /** @param num_frames number of frames of the cache the sketch serves */
+  explicit FrequencySketch(size_t num_frames);
+
+  /** @brief Count an access to the page. */
+  void Increment(page_id_t page_id);
+
+  /** @return the estimated number of recent accesses to the page, at most MAX_COUNT */
+  auto Frequency(page_id_t page_id) const -> uint32_t;
+
+ private:
+  auto Index(page_id_t page_id, size_t row) const -> size_t;
+
+  /** width_ counters per row, the rows laid out back to back. */
+  std::vector<uint8_t> counters_;
+  size_t width_;
+  size_t sample_size_;
+  size_t additions_{0};
+};
+
+/**
+ * TinyLFUReplacer implements W-TinyLFU (Einziger, Friedman and Manes, ACM ToS 2017).
+ *
+ * New pages enter a small LRU admission window of about 1% of the frames. The rest of the frames form the main
+ * region, a segmented LRU: pages enter its probation segment and move to its protected segment, of up to 80% of the
+ * main region, on their next hit. When the window overflows, its least recently used page only gets into the main
+ * region if the frequency sketch estimates it to be more popular than the page the main region would evict; the
+ * loser is evicted. Pages that are touched once, such as those of a scan, lose against everything with a history
+ * and leave through the window.
+ *
+ * Pinned frames count towards the size of their segment, but are skipped when looking for a victim.
+ */
+class TinyLFUReplacer : public BufferPoolReplacer {
+ public:
+  /**
+   * @brief Create a new TinyLFUReplacer.
+   * @param num_frames the maximum number of frames the replacer will be required to store
+   */
+  explicit TinyLFUReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(TinyLFUReplacer);
+
+  ~TinyLFUReplacer() override = default;
+
+  /** @brief Evict the loser of the admission duel if the window overflows, or the main region's LRU frame. */
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
+
+  auto Size() -> size_t override;
+
+ private:
+  enum class Segment : uint8_t { WINDOW, PROBATION, PROTECTED };
+
+  struct FrameInfo {
+    page_id_t page_id_{INVALID_PAGE_ID};
+    Segment segment_{Segment::WINDOW};
+    bool is_evictable_{false};
+    size_t last_access_{0};
+  };
+
+  /** (last access, frame id) */
+  using EvictKey = std::pair<size_t, frame_id_t>;
+
+  auto ListOf(Segment segment) -> std::set<EvictKey> &;
+  auto SizeOf(Segment segment) -> size_t &;
+
+  /** @brief Move a resident frame to the most recently used end of a segment. */
+  void MoveTo(frame_id_t frame_id, Segment segment);
+
+  /** @brief Stop tracking the frame. */
+  void Drop(frame_id_t frame_id);
+
+  size_t current_timestamp_{0};
+  size_t curr_size_{0};
+  size_t replacer_size_;
+  size_t window_capacity_;
+  size_t protected_capacity_;
+  /** Resident pages per segment, pinned or not. */
+  size_t window_size_{0};
+  size_t probation_size_{0};
+  size_t protected_size_{0};
+  std::vector<FrameInfo> frames_;
+  /** Evictable frames per segment, least recently used first. */
+  std::set<EvictKey> window_;
+  std::set<EvictKey> probation_;
+  std::set<EvictKey> protected_;
+  FrequencySketch sketch_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_q_replacer.h
+//
+// Identification: src/include/buffer/two_q_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "buffer/ghost_list.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * TwoQReplacer implements the full version of the 2Q replacement policy (Johnson and Shasha, VLDB '94).
+ *
+ * A page brought in for the first time enters A1in, a FIFO queue of about a quarter of the frames. Hits in A1in are
+ * taken as correlated references and ignored. Pages evicted from A1in are remembered in the ghost queue A1out, of
+ * about half as many entries as there are frames; a page that comes back while it is still in A1out has proven
+ * itself and enters Am, which is managed as LRU. Eviction takes from A1in while it holds more than its share, and
+ * from Am otherwise, so pages touched once, e.g. by a scan, never push the hot pages in Am out.
+ *
+ * Pinned frames count towards the size of their queue, but are skipped when looking for a victim.
+ */
+class TwoQReplacer : public BufferPoolReplacer {
+ public:
+  /**
+   * @brief Create a new TwoQReplacer.
+   * @param num_frames the maximum number of frames the replacer will be required to store
+   */
+  explicit TwoQReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(TwoQReplacer);
+
+  ~TwoQReplacer() override = default;
+
+  /** @brief Evict the oldest evictable frame of A1in, or the least recently used one of Am. */
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  /** @brief Forget the frame without remembering its page in A1out. */
+  void Remove(frame_id_t frame_id) override;
+
+  auto GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
+
+  auto Size() -> size_t override;
+
+ private:
+  struct FrameInfo {
+    page_id_t page_id_{INVALID_PAGE_ID};
+    bool in_am_{false};
+    bool is_evictable_{false};
+    /** Time the page entered A1in, or its last access in Am. */
+    size_t timestamp_{0};
+  };
+
+  /** (timestamp, frame id) */
+  using EvictKey = std::pair<size_t, frame_id_t>;
+
+  auto ListOf(frame_id_t frame_id) -> std::set<EvictKey> & { return frames_[frame_id].in_am_ ? am_ : a1in_; }
+
+  /** @return whether Evict() would take the next victim from A1in */
+  auto PreferA1in() const -> bool;
+
+  /** @brief Stop tracking the frame. */
+  void Drop(frame_id_t frame_id);
+
+  size_t current_timestamp_{0};
+  size_t curr_size_{0};
+  size_t replacer_size_;
+  /** Share of the frames A1in may hold before it is evicted from first. */
+  size_t kin_;
+  /** Number of pages A1out remembers. */
+  size_t kout_;
+  /** Resident pages in A1in and Am, pinned or not. */
+  size_t a1in_size_{0};
+  size_t am_size_{0};
+  std::vector<FrameInfo> frames_;
+  /** Evictable frames of A1in in FIFO order, and of Am in LRU order. */
+  std::set<EvictKey> a1in_;
+  std::set<EvictKey> am_;
+  GhostList a1out_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -211,12 +211,32 @@ class BustubInstance {
   auto MakeExecutorContext(Transaction *txn) -> std::unique_ptr<ExecutorContext>;
 
  public:
-  explicit BustubInstance(const std::string &db_file_name);
+  /** Buffer pool size unless configured otherwise; GenerateTestTable() needs more frames than BUFFER_POOL_SIZE. */
+  static constexpr size_t DEFAULT_BUFFER_POOL_SIZE = 128;
 
-  BustubInstance();
+  /**
+   * Create an instance on a database file.
+   * @param buffer_pool_size number of frames of the buffer pool
+   * @param max_buffer_pool_size largest size ResizeBufferPool() may grow the pool to, 0 for buffer_pool_size
+   */
+  explicit BustubInstance(const std::string &db_file_name, size_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE,
+                          size_t max_buffer_pool_size = 0);
+
+  /**
+   * Create an instance on an in-memory disk.
+   * @param buffer_pool_size number of frames of the buffer pool
+   * @param max_buffer_pool_size largest size ResizeBufferPool() may grow the pool to, 0 for buffer_pool_size
+   */
+  explicit BustubInstance(size_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE, size_t max_buffer_pool_size = 0);
 
   ~BustubInstance();
 
+  /**
+   * Grow or shrink the buffer pool while queries keep running. Shrinking waits until the dropped frames are unpinned.
+   * @return false if new_size is 0 or larger than the maximum buffer pool size
+   */
+  auto ResizeBufferPool(size_t new_size) -> bool;
+
   /**
    * Execute a SQL query in the BusTub instance.
    */
@@ -14,10 +14,20 @@
 
 #include <atomic>
 #include <chrono>  // NOLINT
+#include <cstddef>
 #include <cstdint>
 
+/** The page size is chosen with the BUSTUB_PAGE_SIZE build option. */
+#ifndef BUSTUB_PAGE_SIZE_BYTES
+#define BUSTUB_PAGE_SIZE_BYTES 4096
+#endif
+
 namespace bustub {
 
+static_assert(BUSTUB_PAGE_SIZE_BYTES == 4096 || BUSTUB_PAGE_SIZE_BYTES == 8192 || BUSTUB_PAGE_SIZE_BYTES == 16384 ||
+                  BUSTUB_PAGE_SIZE_BYTES == 32768,
+              "the page size must be 4, 8, 16 or 32 KB");
+
 /** Cycle detection is performed every CYCLE_DETECTION_INTERVAL milliseconds. */
 extern std::chrono::milliseconds cycle_detection_interval;
 
@@ -27,15 +37,30 @@ extern std::atomic<bool> enable_logging;
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/** A running buffer pool page cleaner looks at the upcoming victims at least every PAGE_CLEANER_INTERVAL. */
+extern std::chrono::milliseconds page_cleaner_interval;
+
+/** A running hot set dumper saves the resident pages of its buffer pool every HOT_SET_DUMP_INTERVAL. */
+extern std::chrono::milliseconds hot_set_dump_interval;
+
 static constexpr int INVALID_PAGE_ID = -1;                                           // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                            // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                               // invalid log sequence number
 static constexpr int HEADER_PAGE_ID = 0;                                             // the header page id
-static constexpr int BUSTUB_PAGE_SIZE = 4096;                                        // size of a data page in byte
-static constexpr int BUFFER_POOL_SIZE = 10;                                          // size of buffer pool
-static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
+static constexpr int BUSTUB_PAGE_SIZE = BUSTUB_PAGE_SIZE_BYTES;                      // size of a data page in byte
+static constexpr int BUFFER_POOL_SIZE = 10;                                          // default size of buffer pool
+static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // log buffer of the default pool
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr int READ_AHEAD_MAX_PAGES = 32;  // upper bound of the sequential read-ahead window
+static constexpr int SCAN_RING_SIZE = 16;        // frames recycled by a large sequential scan
+static constexpr int OPTIMISTIC_READ_RETRIES = 4;  // optimistic page reads before falling back to the read latch
+static constexpr int ASYNC_IO_QUEUE_DEPTH = 128;   // asynchronous page requests a disk manager keeps in flight
+static constexpr int ASYNC_IO_WORKERS = 8;         // threads of the fallback asynchronous I/O engine
+static constexpr int DIRECT_IO_ALIGNMENT = 4096;   // alignment of the buffers of O_DIRECT I/O
+static constexpr size_t DB_SEGMENT_PAGES = (size_t{1} << 30) / BUSTUB_PAGE_SIZE;  // pages per 1 GB db segment file
+static constexpr int INDEX_SCAN_BATCH_SIZE = 64;   // RIDs an index scan resolves per FetchPages() call
+static constexpr int WARM_UP_CHUNK_PAGES = 256;    // pages a buffer pool warm-up reads per round
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -44,6 +69,9 @@ using lsn_t = int32_t;         // log sequence number type
 using slot_offset_t = size_t;  // slot offset type
 using oid_t = uint16_t;
 
+/** @return the size of a log buffer in byte for a buffer pool of buffer_pool_size frames, see LOG_BUFFER_SIZE */
+constexpr auto LogBufferSize(size_t buffer_pool_size) -> size_t { return (buffer_pool_size + 1) * BUSTUB_PAGE_SIZE; }
+
 static constexpr int VARCHAR_DEFAULT_LENGTH = 128;  // default length for varchar when constructing the column
 
 }  // namespace bustub
@@ -0,0 +1,49 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// crc32c.h
+//
+// Identification: src/include/common/util/crc32c.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bustub {
+
+/**
+ * Crc32c computes the CRC-32C (Castagnoli) checksum of a buffer, the one of iSCSI, ext4 and SSE4.2.
+ *
+ * On x86-64 CPUs with SSE4.2 the crc32 instruction is used on three interleaved streams, whose CRCs are combined with
+ * precomputed tables, so that its latency is hidden; elsewhere a table-driven version that consumes 8 bytes per step
+ * is used. Both give the same results.
+ */
+class Crc32c {
+ public:
+  /**
+   * @brief Extend the CRC of some data with more data, e.g. Extend(Extend(0, a, n), b, m) is the CRC of a followed by
+   * b.
+   * @param crc CRC of the data so far, 0 for no data
+   * @param data the data to add
+   * @param size number of bytes in data
+   * @return the CRC of the data so far followed by data
+   */
+  static auto Extend(uint32_t crc, const char *data, size_t size) -> uint32_t;
+
+  /** @return the CRC of a buffer */
+  static auto Compute(const char *data, size_t size) -> uint32_t { return Extend(0, data, size); }
+
+  /** Extend() without the crc32 instruction, for tests and benchmarks. */
+  static auto ExtendSoftware(uint32_t crc, const char *data, size_t size) -> uint32_t;
+
+  /** @return true if Extend() uses the crc32 instruction of the CPU */
+  static auto IsHardwareAccelerated() -> bool;
+};
+
+}  // namespace bustub
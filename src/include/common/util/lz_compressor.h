@@ -0,0 +1,56 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lz_compressor.h
+//
+// Identification: src/include/common/util/lz_compressor.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+namespace bustub {
+
+/**
+ * LZCompressor is a fast byte-oriented LZ77 codec in the spirit of LZ4, meant for whole pages.
+ *
+ * The output is a series of sequences. A sequence starts with a token byte whose high nibble is the number of
+ * literals and whose low nibble is the match length minus MIN_MATCH; a nibble of 15 is continued by bytes that are
+ * added to it until one is below 255. The literals follow, then the match offset as two little-endian bytes. The last
+ * sequence has literals only. Matches are found with a single hash table probe per position, which trades some ratio
+ * for speed.
+ */
+class LZCompressor {
+ public:
+  /** Shortest match worth encoding. */
+  static constexpr size_t MIN_MATCH = 4;
+  /** Largest distance a match can reach back. */
+  static constexpr size_t MAX_OFFSET = 65535;
+
+  /**
+   * @brief Compress a buffer.
+   * @param src data to compress
+   * @param size number of bytes in src
+   * @param[out] dst the compressed data
+   * @param capacity size of dst
+   * @return the size of the compressed data, or 0 if it does not fit into capacity bytes
+   */
+  static auto Compress(const char *src, size_t size, char *dst, size_t capacity) -> size_t;
+
+  /**
+   * @brief Decompress a buffer written by Compress().
+   * @param src compressed data
+   * @param size number of bytes in src
+   * @param[out] dst the decompressed data
+   * @param capacity size of dst
+   * @return the size of the decompressed data, or 0 if src is corrupt or does not fit into capacity bytes
+   */
+  static auto Decompress(const char *src, size_t size, char *dst, size_t capacity) -> size_t;
+};
+
+}  // namespace bustub
@@ -12,10 +12,13 @@
 
 #pragma once
 
+#include <algorithm>
+#include <memory>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "buffer/buffer_access_strategy.h"
 #include "catalog/catalog.h"
 #include "concurrency/transaction.h"
 #include "storage/page/tmp_tuple_page.h"
@@ -60,6 +63,21 @@ class ExecutorContext {
   /** @return the transaction manager */
   auto GetTransactionManager() -> TransactionManager * { return txn_mgr_; }
 
+  /**
+   * Choose how a sequential scan over the table uses the buffer pool. Tables larger than a quarter of the pool are
+   * read through a private ring of SCAN_RING_SIZE frames, so that the scan does not evict the pages other
+   * transactions work on. So are tables whose size is not known yet.
+   * @param table the table to be scanned
+   * @return a new strategy for the scan, or nullptr if the scan may use the whole buffer pool
+   */
+  auto GetScanAccessStrategy(const TableHeap *table) -> std::shared_ptr<BufferAccessStrategy> {
+    if (bpm_ == nullptr || table->GetNumPages() <= bpm_->GetPoolSize() / 4) {
+      return nullptr;
+    }
+    auto ring_size = std::max<size_t>(std::min<size_t>(SCAN_RING_SIZE, bpm_->GetPoolSize() / 4), 1);
+    return std::make_shared<BufferAccessStrategy>(ring_size);
+  }
+
  private:
   /** The transaction context associated with this executor context */
   Transaction *transaction_;
@@ -53,5 +53,10 @@ class IndexScanExecutor : public AbstractExecutor {
   TableInfo *table_info_;
   IndexInfo *index_info_;
   std::unique_ptr<BPlusTreeIndexIteratorForOneIntegerColumn> index_iterator_;
+  /** RIDs read from the index ahead of time, and their tuples. Up to INDEX_SCAN_BATCH_SIZE are fetched at once. */
+  std::vector<RID> rids_;
+  std::vector<Tuple> tuples_;
+  /** Position of the next tuple to emit in rids_ / tuples_. */
+  size_t next_{0};
 };
 }  // namespace bustub
@@ -12,38 +12,81 @@
 
 #pragma once
 
+#include <sys/types.h>
 #include <atomic>
 #include <fstream>
+#include <functional>
 #include <future>  // NOLINT
-#include <mutex>   // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <set>
+#include <shared_mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
+#include "storage/disk/io_engine.h"
 
 namespace bustub {
 
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
+ *
+ * The database is split into segment files of segment_pages pages each: the file named db_file holds segment 0, and
+ * segment n > 0 lives in db_file.n. Segments are opened when first used and created by the first write to them, so
+ * the database can grow to the whole page id range; the part of the database that was never written reads as zeros.
+ *
+ * Pages are read and written with pread()/pwrite() at 64-bit offsets, so there is no shared file position and any
+ * number of threads can do page I/O at once. Writes go to the operating system right away but are only durable after
+ * the next Sync().
+ *
+ * ReadPageAsync() and WritePageAsync() let one thread keep many requests in flight. They go through an IOEngine: an
+ * io_uring on the database file when the kernel allows it, otherwise a pool of threads that call ReadPage() and
+ * WritePage(), which also serves the in-memory disk managers.
+ *
+ * With direct I/O the database file is opened with O_DIRECT, so pages are not cached a second time by the kernel and
+ * the memory can go to the buffer pool instead. Buffers aligned to DIRECT_IO_ALIGNMENT, such as buffer pool frames,
+ * are transferred in place; other buffers are copied through an aligned one. If the file system refuses O_DIRECT,
+ * the disk manager falls back to buffered I/O.
+ *
+ * Deallocated pages are kept in a free page map, so that their ids can be handed out again, and the disk space behind
+ * them is given back to the file system: a hole is punched for each free page, and segments that become entirely free
+ * are truncated. The map is saved next to the database in db_file.free by Sync().
+ *
+ * Every page carries a CRC-32C of its page id and contents in the checksum field of its header, see Page. Writes fill
+ * it in, in a copy of the caller's buffer, and reads verify it, so that pages the device corrupted, tore or wrote to
+ * the wrong place are noticed instead of being handed to the buffer pool as if they were fine. A mismatch is counted,
+ * logged and reported to the checksum failure handler; the page is left as it was read. Pages that were never written
+ * read as zeros, which is a valid page.
  */
 class DiskManager {
  public:
   /**
    * Creates a new disk manager that writes to the specified database file.
    * @param db_file the file name of the database file to write to
+   * @param direct_io whether to bypass the kernel page cache, see IsDirectIO()
+   * @param segment_pages pages per segment file; must be the same every time the database is opened
    */
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, bool direct_io = false, size_t segment_pages = DB_SEGMENT_PAGES);
 
   /** FOR TEST / LEADERBOARD ONLY, used by DiskManagerMemory */
   DiskManager() = default;
 
-  virtual ~DiskManager() = default;
+  virtual ~DiskManager();
 
   /**
-   * Shut down the disk manager and close all the file resources.
+   * Shut down the disk manager and close all the file resources. The database file is synced first.
    */
   void ShutDown();
 
+  /**
+   * Make every page written so far durable, and save the free page map. Called by the buffer pool when it flushes all
+   * pages, and by ShutDown().
+   */
+  virtual void Sync();
+
   /**
    * Write a page to the database file.
    * @param page_id id of the page
@@ -51,6 +94,15 @@ class DiskManager {
    */
   virtual void WritePage(page_id_t page_id, const char *page_data);
 
+  /**
+   * Write a run of consecutive pages to the database file with a single request. The pages do not have to be
+   * contiguous in memory.
+   * @param first_page_id id of the first page of the run
+   * @param pages raw page data of pages first_page_id, first_page_id + 1, ...
+   * @param num_pages length of the run
+   */
+  virtual void WritePages(page_id_t first_page_id, const char *const *pages, size_t num_pages);
+
   /**
    * Read a page from the database file.
    * @param page_id id of the page
@@ -58,6 +110,120 @@ class DiskManager {
    */
   virtual void ReadPage(page_id_t page_id, char *page_data);
 
+  /**
+   * Read a run of consecutive pages from the database file with a single request. The pages do not have to be
+   * contiguous in memory; the part of the run past the end of the file reads as zeros.
+   * @param first_page_id id of the first page of the run
+   * @param[out] pages output buffers of pages first_page_id, first_page_id + 1, ...
+   * @param num_pages length of the run
+   */
+  virtual void ReadPages(page_id_t first_page_id, char *const *pages, size_t num_pages);
+
+  /**
+   * Take a deallocated page for reuse.
+   * @param hint the free page closest to hint is taken; INVALID_PAGE_ID takes the lowest one
+   * @param stride only pages with page_id % stride == residue are taken, so that every instance of a parallel buffer
+   * pool gets back its own pages
+   * @param residue see stride
+   * @return the page, or INVALID_PAGE_ID if no page is free
+   */
+  auto ReusePage(page_id_t hint, size_t stride = 1, size_t residue = 0) -> page_id_t;
+
+  /** @return the page ReusePage() would take with the same arguments, which stays free */
+  auto FindFreePage(page_id_t hint, size_t stride = 1, size_t residue = 0) -> page_id_t;
+
+  /**
+   * Add a page to the free page map. Its disk space is released by the next Sync(), once a saved map lists the page as
+   * free. The page must no longer be read or written until ReusePage() hands it out again; it then reads as zeros if
+   * its space was released, and its old contents otherwise.
+   * @param page_id id of the page
+   */
+  void DeallocatePage(page_id_t page_id);
+
+  /** @return true if the page is in the free page map */
+  auto IsFreePage(page_id_t page_id) -> bool;
+
+  /** @return the number of pages in the free page map */
+  auto GetNumFreePages() -> size_t;
+
+  /**
+   * Start reading a page and return right away.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer, must stay valid until the read completes
+   * @return the completion of the read, true if it succeeded
+   */
+  auto ReadPageAsync(page_id_t page_id, char *page_data) -> std::future<bool>;
+
+  /**
+   * Start writing a page and return right away.
+   * @param page_id id of the page
+   * @param page_data raw page data, must stay unchanged until the write completes
+   * @return the completion of the write, true if it succeeded
+   */
+  auto WritePageAsync(page_id_t page_id, const char *page_data) -> std::future<bool>;
+
+  /**
+   * Replace the engine of the asynchronous requests. Only to be called before the first of them.
+   * @param engine the new engine
+   */
+  void SetIOEngine(std::unique_ptr<IOEngine> engine) { io_engine_ = std::move(engine); }
+
+  /** @return the engine of the asynchronous requests, created on first use */
+  auto GetIOEngine() -> IOEngine *;
+
+  /** @return true if the database file is read and written with O_DIRECT */
+  auto IsDirectIO() const -> bool { return direct_io_; }
+
+  /**
+   * Allocate the disk space of every segment file created from now on in full when it is created, so that it is laid
+   * out in one piece and writes to it cannot run out of space.
+   * @param preallocate whether to preallocate new segments
+   */
+  void SetPreallocateSegments(bool preallocate) { preallocate_segments_ = preallocate; }
+
+  /**
+   * Stamp checksums into the pages written from now on and verify them on reads. On by default; a database that was
+   * written without checksums can only be read with them turned off.
+   * @param checksums whether to stamp and verify checksums
+   */
+  void SetChecksums(bool checksums) { checksums_ = checksums; }
+
+  /** @return true if pages are stamped with checksums and verified */
+  auto HasChecksums() const -> bool { return checksums_; }
+
+  /** @return the number of page reads that found the page corrupt, e.g. with a checksum that did not match */
+  auto GetNumChecksumFailures() const -> uint64_t { return num_checksum_failures_; }
+
+  /**
+   * @return the number of page reads and writes of the calling thread that failed with an I/O error, in any disk
+   * manager. ReadPage() and WritePage() do not return their errors; compare this before and after the call instead.
+   */
+  static auto GetThreadIOErrors() -> uint64_t;
+
+  /**
+   * Have mismatching pages reported to a handler, e.g. to fail the query or fetch the page from a replica. The handler
+   * is called by the thread that reads the page, or that waits for the asynchronous read of it. Only to be set before
+   * the first read.
+   * @param handler called with the id of every page read corrupt
+   */
+  void SetChecksumFailureHandler(std::function<void(page_id_t)> handler) {
+    checksum_failure_handler_ = std::move(handler);
+  }
+
+  /**
+   * @brief Fill in the checksum field of a page, see Page::OFFSET_CHECKSUM.
+   * @param page_id id the page is written as; a page written to another place does not match
+   * @param page_data raw page data
+   */
+  static void StampChecksum(page_id_t page_id, char *page_data);
+
+  /**
+   * @param page_id id the page was read as
+   * @param page_data raw page data
+   * @return true if the checksum field of the page matches its contents, or the page is all zeros
+   */
+  static auto VerifyChecksum(page_id_t page_id, const char *page_data) -> bool;
+
   /**
    * Flush the entire log buffer into disk.
    * @param log_data raw log data
@@ -72,7 +238,7 @@ class DiskManager {
    * @param offset offset of the log entry in the file
    * @return true if the read was successful, false otherwise
    */
-  auto ReadLog(char *log_data, int size, int offset) -> bool;
+  auto ReadLog(char *log_data, int size, int64_t offset) -> bool;
 
   /** @return the number of disk flushes */
   auto GetNumFlushes() const -> int;
@@ -93,19 +259,95 @@ class DiskManager {
   inline auto HasFlushLogFuture() -> bool { return flush_log_f_ != nullptr; }
 
  protected:
-  auto GetFileSize(const std::string &file_name) -> int;
+  auto GetFileSize(const std::string &file_name) -> int64_t;
+
+  /**
+   * Replace a file with new contents so that a crash leaves either the old or the new file: the contents go to a
+   * temporary file that is synced, renamed over the old one, and the rename is made durable by syncing the directory.
+   * @return true once the new file is durable
+   */
+  static auto ReplaceFileDurably(const std::string &path, const std::string &contents) -> bool;
+
+  /**
+   * Read or write a run of consecutive pages, with one request per segment it touches. Reads past the end of a
+   * segment read as zeros. With direct I/O, runs with unaligned buffers go through an aligned bounce buffer page by
+   * page.
+   * @return false on an I/O error or a negative first_page_id
+   */
+  auto TransferRun(bool write, page_id_t first_page_id, char *const *pages, size_t num_pages) -> bool;
+
+  /**
+   * Find a page in the segment files.
+   * @param page_id the page
+   * @param create whether to create the segment of the page if it does not exist
+   * @param[out] offset offset of the page in its segment file
+   * @return the descriptor of the segment file, -1 if it does not exist and create is false or page_id is negative
+   */
+  auto LocatePage(page_id_t page_id, bool create, off_t *offset) -> int;
+
+  /** @return the descriptor of a segment file, opened on first use; -1 if it does not exist and create is false */
+  auto SegmentFd(size_t segment, bool create) -> int;
+
+  void CloseSegments();
+
+  /** Sync the data of the segment files that are open. */
+  void SyncSegments();
+
+  /** Switch the database file to buffered I/O after the file system refused O_DIRECT. */
+  void DisableDirectIO();
+
+  /** Give the disk space of a free page, or of its whole segment once all of it is free, back to the file system. */
+  virtual void ReleaseSpace(page_id_t page_id);
+
+  /** @return the free page ReusePage() takes, or INVALID_PAGE_ID; free_pages_latch_ must be held */
+  auto ClosestFreePage(page_id_t hint, size_t stride, size_t residue) -> page_id_t;
+
+  /** Read the free page map of the database file. A map left behind by an earlier database of that name is dropped. */
+  void LoadFreePages();
+
+  /**
+   * Write the free page map if it changed, to a new file that durably replaces the old one, and release the space of
+   * the pages freed since the last map.
+   */
+  void SaveFreePages();
+
+  /** Verify the checksum of a page that was read, and report a mismatch. */
+  void CheckPage(page_id_t page_id, const char *page_data);
+
+  /** Count, log and hand to the failure handler a page that was read corrupt. */
+  void ReportCorruptPage(page_id_t page_id);
+
+  /** Count for the calling thread, see GetThreadIOErrors(), and log a page read or write that failed. */
+  static void ReportIOError(const char *message);
+
   // stream to write log file
   std::fstream log_io_;
   std::string log_name_;
-  // stream to write db file
-  std::fstream db_io_;
+  std::atomic<bool> direct_io_{false};
   std::string file_name_;
+  size_t segment_pages_{DB_SEGMENT_PAGES};
+  bool preallocate_segments_{false};
+  // descriptors of the segment files by segment number, -1 for the ones not open yet
+  std::vector<int> segment_fds_;
+  std::shared_mutex segments_latch_;
+  // the free page map, the number of free pages in each segment, and whether the map changed since it was saved
+  std::mutex free_pages_latch_;
+  std::set<page_id_t> free_pages_;
+  std::vector<size_t> free_in_segment_;
+  bool free_pages_dirty_{false};
+  // pages freed since the map was last taken, their space is released once a map listing them is saved
+  std::set<page_id_t> pending_release_;
+  std::mutex save_free_pages_latch_;
+
+  bool checksums_{true};
+  std::atomic<uint64_t> num_checksum_failures_{0};
+  std::function<void(page_id_t)> checksum_failure_handler_;
   int num_flushes_{0};
-  int num_writes_{0};
+  std::atomic<int> num_writes_{0};
   bool flush_log_{false};
   std::future<void> *flush_log_f_{nullptr};
-  // With multiple buffer pool instances, need to protect file access
-  std::mutex db_io_latch_;
+  std::unique_ptr<IOEngine> io_engine_;
+  std::once_flag io_engine_once_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_compressed.h
+//
+// Identification: src/include/storage/disk/disk_manager_compressed.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * DiskManagerCompressed stores pages compressed with LZCompressor, for databases of cold, repetitive data such as
+ * append-mostly tables. The buffer pool still reads and writes plain pages; only the file is compressed.
+ *
+ * The database file is a heap of extents, each a whole number of SLOT_SIZE slots, and every page that was written has
+ * one. An extent starts with an ExtentHeader followed by the compressed page, or by the page as it is if it does not
+ * compress by at least a slot. The extent map from page id to extent lives in memory and is saved in db_file.extents
+ * by Sync(), next to the free page map.
+ *
+ * A page that still fits into its extent is rewritten in place, otherwise it moves to a new extent: a free one of the
+ * right size, a larger one that is split, or one at the end of the file. Pages written in one run get consecutive
+ * extents, so a run that is read back together is read with one request. An extent that was left, by a page that
+ * moved or was deallocated, stays reserved until the next Sync() has saved a map that no longer points to it, so that
+ * a crash finds the pages of the last saved map where the map says. The space of deallocated pages is then given
+ * back to the file system.
+ *
+ * Checksums are stamped into the plain page before it is compressed and verified after it is decompressed; an extent
+ * that does not decompress is reported like a checksum mismatch. Asynchronous requests go through a thread pool. The
+ * file is always opened with buffered I/O.
+ */
+class DiskManagerCompressed : public DiskManager {
+ public:
+  /** Granularity of extents in bytes. */
+  static constexpr size_t SLOT_SIZE = 256;
+
+  /** The start of every extent. */
+  struct ExtentHeader {
+    /** The page the extent holds, to catch a map that points to the wrong extent. */
+    page_id_t page_id_;
+    /** Bytes of page data that follow; BUSTUB_PAGE_SIZE if the page is stored uncompressed. */
+    uint32_t size_;
+  };
+
+  /** Largest extent, that of a page that is stored uncompressed. */
+  static constexpr size_t MAX_EXTENT_SLOTS = (sizeof(ExtentHeader) + BUSTUB_PAGE_SIZE + SLOT_SIZE - 1) / SLOT_SIZE;
+
+  /**
+   * Creates a disk manager for a compressed database file. The file must be empty or have been written by a
+   * DiskManagerCompressed.
+   * @param db_file the file name of the database file to write to
+   */
+  explicit DiskManagerCompressed(const std::string &db_file);
+
+  ~DiskManagerCompressed() override;
+
+  /**
+   * Save the extent map as it was when the pages it points to were made durable, then free the extents that were left
+   * before that.
+   */
+  void Sync() override;
+
+  void WritePage(page_id_t page_id, const char *page_data) override { WritePages(page_id, &page_data, 1); }
+
+  /** Compress the pages and write those whose extents follow each other with a single request. */
+  void WritePages(page_id_t first_page_id, const char *const *pages, size_t num_pages) override;
+
+  void ReadPage(page_id_t page_id, char *page_data) override { ReadPages(page_id, &page_data, 1); }
+
+  /** Read the pages whose extents follow each other with a single request, and decompress them. */
+  void ReadPages(page_id_t first_page_id, char *const *pages, size_t num_pages) override;
+
+  /** @return the number of pages that have an extent */
+  auto GetNumStoredPages() -> size_t;
+
+  /** @return the bytes of the extents of all pages, which is what their plain pages take compressed */
+  auto GetStoredBytes() -> uint64_t;
+
+ protected:
+  void ReleaseSpace(page_id_t page_id) override;
+
+ private:
+  struct Extent {
+    uint64_t offset_;
+    uint32_t slots_;
+  };
+
+  /** @return an extent of slots slots, taken from the free extents or from the end of the file */
+  auto AllocateExtent(uint32_t slots) -> Extent;
+
+  /** Add a free extent to the free lists, in pieces of at most MAX_EXTENT_SLOTS slots. */
+  void AddFreeExtent(Extent extent);
+
+  /** Read the extent map and rebuild the free extents from the gaps between the extents it has. */
+  void LoadExtents();
+
+  /**
+   * Write an extent map to a new file that durably replaces the old one, see ReplaceFileDurably().
+   * @param extents the map, extents_ or a copy of it
+   * @return false if the map could not be written and made durable
+   */
+  auto SaveExtents(const std::unordered_map<page_id_t, Extent> &extents) -> bool;
+
+  /** Decompress one extent into a page and verify it, or report the page corrupt. */
+  void DecodeExtent(page_id_t page_id, const char *extent, size_t extent_size, char *page_data);
+
+  /** Held shared by writes, and exclusively by Sync() while it takes the extent map. Taken before extents_latch_. */
+  std::shared_mutex writes_latch_;
+  std::mutex extents_latch_;
+  std::unordered_map<page_id_t, Extent> extents_;
+  /** free_extents_[n] holds the offsets of the free extents of n slots. */
+  std::vector<std::vector<uint64_t>> free_extents_;
+  /** Extents that were left since the last Sync(), by pages that moved and by pages that were deallocated. */
+  std::vector<Extent> moved_extents_;
+  std::vector<Extent> deallocated_extents_;
+  uint64_t end_offset_{0};
+  uint64_t stored_bytes_{0};
+  bool extents_dirty_{false};
+};
+
+}  // namespace bustub
@@ -9,6 +9,9 @@
 // Copyright (c) 2015-2020, Carnegie Mellon University Database Group
 //
 //===----------------------------------------------------------------------===//
+
+#pragma once
+
 #include <array>
 #include <cstring>
 #include <fstream>
@@ -30,7 +33,7 @@ namespace bustub {
 
 /**
  * DiskManagerMemory replicates the utility of DiskManager on memory. It is primarily used for
- * data structure performance testing.
+ * data structure performance testing. Pages are checksummed like on disk, see SetChecksums().
  */
 class DiskManagerMemory : public DiskManager {
  public:
@@ -45,6 +48,14 @@ class DiskManagerMemory : public DiskManager {
    */
   void WritePage(page_id_t page_id, const char *page_data) override;
 
+  /**
+   * Write a run of consecutive pages.
+   * @param first_page_id id of the first page of the run
+   * @param pages raw page data
+   * @param num_pages length of the run
+   */
+  void WritePages(page_id_t first_page_id, const char *const *pages, size_t num_pages) override;
+
   /**
    * Read a page from the database file.
    * @param page_id id of the page
@@ -52,13 +63,21 @@ class DiskManagerMemory : public DiskManager {
    */
   void ReadPage(page_id_t page_id, char *page_data) override;
 
+  /**
+   * Read a run of consecutive pages.
+   * @param first_page_id id of the first page of the run
+   * @param[out] pages output buffers
+   * @param num_pages length of the run
+   */
+  void ReadPages(page_id_t first_page_id, char *const *pages, size_t num_pages) override;
+
  private:
   char *memory_;
 };
 
 /**
  * DiskManagerMemory replicates the utility of DiskManager on memory. It is primarily used for
- * data structure performance testing.
+ * data structure performance testing. The stored pages carry checksums like on disk, see SetChecksums().
  */
 class DiskManagerUnlimitedMemory : public DiskManager {
  public:
@@ -82,6 +101,21 @@ class DiskManagerUnlimitedMemory : public DiskManager {
     l.unlock();
 
     memcpy(ptr->first.data(), page_data, BUSTUB_PAGE_SIZE);
+    if (checksums_) {
+      StampChecksum(page_id, ptr->first.data());
+    }
+  }
+
+  /**
+   * Write a run of consecutive pages, one page at a time.
+   * @param first_page_id id of the first page of the run
+   * @param pages raw page data
+   * @param num_pages length of the run
+   */
+  void WritePages(page_id_t first_page_id, const char *const *pages, size_t num_pages) override {
+    for (size_t i = 0; i < num_pages; i++) {
+      WritePage(first_page_id + static_cast<page_id_t>(i), pages[i]);
+    }
   }
 
   /**
@@ -100,10 +134,26 @@ class DiskManagerUnlimitedMemory : public DiskManager {
       return;
     }
     std::shared_ptr<ProtectedPage> ptr = data_[page_id];
-    std::shared_lock<std::shared_mutex> l_page(ptr->second);
-    l.unlock();
+    {
+      std::shared_lock<std::shared_mutex> l_page(ptr->second);
+      l.unlock();
+      memcpy(page_data, ptr->first.data(), BUSTUB_PAGE_SIZE);
+    }
+    if (checksums_) {
+      CheckPage(page_id, page_data);
+    }
+  }
 
-    memcpy(page_data, ptr->first.data(), BUSTUB_PAGE_SIZE);
+  /**
+   * Read a run of consecutive pages, one page at a time.
+   * @param first_page_id id of the first page of the run
+   * @param[out] pages output buffers
+   * @param num_pages length of the run
+   */
+  void ReadPages(page_id_t first_page_id, char *const *pages, size_t num_pages) override {
+    for (size_t i = 0; i < num_pages; i++) {
+      ReadPage(first_page_id + static_cast<page_id_t>(i), pages[i]);
+    }
   }
 
  private:
@@ -0,0 +1,136 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_simulated.h
+//
+// Identification: src/include/storage/disk/disk_manager_simulated.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+/** The device a DiskManagerSimulated models. */
+struct SimulatedDiskConfig {
+  /** Time until a request at a random position starts to transfer. */
+  std::chrono::microseconds random_latency_{100};
+  /** Time until a request that starts where the previous one ended starts to transfer. */
+  std::chrono::microseconds sequential_latency_{10};
+  /** Transfer rate in MB/s, shared by all requests; 0 transfers instantly. */
+  double bandwidth_mb_s_{1000};
+  /** Requests the device works on at once. Further requests wait for one of them to finish. */
+  size_t queue_depth_{32};
+  /** Every latency is scaled by a factor drawn uniformly from [1 - jitter, 1 + jitter]. */
+  double jitter_{0.1};
+  /** Seed of the jitter. */
+  uint64_t seed_{15445};
+};
+
+/** Counters of a DiskManagerSimulated. */
+struct SimulatedDiskStats {
+  /** Latency histograms have one bucket per power of two microseconds: bucket i counts latencies below 2^i us. */
+  static constexpr size_t HISTOGRAM_BUCKETS = 32;
+
+  /** Requests and the pages they transferred. A run of pages is one request. */
+  uint64_t reads_{0};
+  uint64_t writes_{0};
+  uint64_t pages_read_{0};
+  uint64_t pages_written_{0};
+  /** Requests that started where the previous one ended. */
+  uint64_t sequential_requests_{0};
+  /** Requests that had to wait for a free slot of the queue. */
+  uint64_t queued_requests_{0};
+  /** Time from submission to completion of every read and write request. */
+  std::array<uint64_t, HISTOGRAM_BUCKETS> read_latency_{};
+  std::array<uint64_t, HISTOGRAM_BUCKETS> write_latency_{};
+
+  /**
+   * @param histogram read_latency_ or write_latency_
+   * @param percentile between 0 and 100
+   * @return an upper bound in microseconds of the given percentile of the histogram, 0 if it is empty
+   */
+  static auto Percentile(const std::array<uint64_t, HISTOGRAM_BUCKETS> &histogram, double percentile) -> uint64_t;
+};
+
+/**
+ * DiskManagerSimulated keeps pages in memory like DiskManagerUnlimitedMemory, but makes every request take as long as
+ * it would on a modelled device, so that benchmarks can show what prefetching, asynchronous I/O and write batching
+ * buy without depending on the disk of the machine.
+ *
+ * The device has queue_depth_ slots. A request takes the slot that frees up first, spends the random or sequential
+ * latency in it, and then transfers its pages over a bus that all slots share, at bandwidth_mb_s_. The calling thread
+ * waits until the request is done. The jitter of the n-th request only depends on seed_ and n, so a single-threaded
+ * run sees the same service times every time.
+ *
+ * Requests the caller does not want to pay for, such as loading a table before a benchmark starts, can go to the
+ * DiskManagerUnlimitedMemory methods directly.
+ */
+class DiskManagerSimulated : public DiskManagerUnlimitedMemory {
+ public:
+  explicit DiskManagerSimulated(const SimulatedDiskConfig &config);
+
+  DISALLOW_COPY_AND_MOVE(DiskManagerSimulated);
+
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /** A run of consecutive pages is one request. */
+  void WritePages(page_id_t first_page_id, const char *const *pages, size_t num_pages) override;
+
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /** A run of consecutive pages is one request. */
+  void ReadPages(page_id_t first_page_id, char *const *pages, size_t num_pages) override;
+
+  /** @return the counters and latency histograms of the requests so far */
+  auto GetStats() -> SimulatedDiskStats;
+
+  /** Reset the counters and histograms, e.g. after loading the data of a benchmark. */
+  void ResetStats();
+
+  auto GetConfig() const -> const SimulatedDiskConfig & { return config_; }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * @brief Schedule a request on the device and wait until it is done.
+   * @param is_write whether the request writes
+   * @param first_page_id first page of the request
+   * @param num_pages length of the request
+   */
+  void Simulate(bool is_write, page_id_t first_page_id, size_t num_pages);
+
+  /** @return the jitter factor of the n-th request */
+  auto Jitter(uint64_t n) const -> double;
+
+  const SimulatedDiskConfig config_;
+  /** Transfer time of one page. */
+  const Clock::duration page_transfer_time_;
+
+  /** Protects everything below. Never held while waiting. */
+  std::mutex latch_;
+  /** When each slot of the queue frees up. */
+  std::vector<Clock::time_point> slot_free_at_;
+  /** When the bus frees up. */
+  Clock::time_point bus_free_at_;
+  /** Page after the end of the last request, where the next one is sequential. */
+  page_id_t next_sequential_page_{INVALID_PAGE_ID};
+  uint64_t num_requests_{0};
+  SimulatedDiskStats stats_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,212 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// io_engine.h
+//
+// Identification: src/include/storage/disk/io_engine.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sys/types.h>
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <future>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <unordered_set>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+class DiskManager;
+
+/** Frees a buffer that was taken from aligned_alloc(). */
+struct AlignedFree {
+  void operator()(char *data) const { free(data); }  // NOLINT
+};
+
+/** A page buffer aligned to DIRECT_IO_ALIGNMENT. */
+using AlignedPage = std::unique_ptr<char, AlignedFree>;
+
+/** @return a new page buffer aligned to DIRECT_IO_ALIGNMENT */
+inline auto AllocateAlignedPage() -> AlignedPage {
+  return AlignedPage(static_cast<char *>(aligned_alloc(DIRECT_IO_ALIGNMENT, BUSTUB_PAGE_SIZE)));  // NOLINT
+}
+
+/** A page read or write handed to an IOEngine. */
+struct IORequest {
+  bool is_write_;
+  page_id_t page_id_;
+  /** BUSTUB_PAGE_SIZE bytes to write from or read into; must stay valid until the request completes. */
+  char *data_;
+  /** File and offset of the page, for engines that address files themselves. */
+  int fd_;
+  off_t offset_;
+  /** Set to true when the request succeeded, false on an I/O error. */
+  std::promise<bool> done_;
+  /** The buffer data_ points to, if the request owns it. */
+  AlignedPage owned_;
+};
+
+/**
+ * Finds a page in the files of a disk manager, see DiskManager::LocatePage(): returns the descriptor of its file, -1
+ * if the file does not exist and create is false, and stores the offset of the page in the file in offset.
+ */
+using PageLocator = std::function<int(page_id_t page_id, bool create, off_t *offset)>;
+
+/**
+ * IOEngine carries out page requests asynchronously for a DiskManager, so that one thread can keep many requests in
+ * flight. Submit() may be called from any number of threads; requests complete in no particular order.
+ */
+class IOEngine {
+ public:
+  virtual ~IOEngine() = default;
+
+  /**
+   * @brief Start a request.
+   * @return the completion of the request
+   */
+  virtual auto Submit(bool is_write, page_id_t page_id, char *data) -> std::future<bool> = 0;
+
+  /**
+   * @brief Start a write of a page buffer that the request owns and frees once it completes, such as a copy of a page
+   * that the caller may change meanwhile.
+   * @return the completion of the request
+   */
+  virtual auto SubmitWrite(page_id_t page_id, AlignedPage page) -> std::future<bool> = 0;
+
+  /** @return a short name of the engine, for statistics and benchmarks */
+  virtual auto GetName() const -> const char * = 0;
+};
+
+/**
+ * IOEngine on a Linux io_uring. Requests are read and written straight from the page buffers with a single syscall to
+ * submit each; a reaper thread waits for completions. At most queue_depth requests are in flight, Submit() blocks
+ * while the ring is full. Requests the ring refuses are carried out with plain pread()/pwrite() instead, and so are
+ * all requests once the ring stops reporting completions.
+ */
+class UringIOEngine : public IOEngine {
+ public:
+  /**
+   * @brief Set up a ring.
+   * @param locate finds the file and offset of a page; a write creates the file, a read of a missing file reads zeros
+   * @param queue_depth most requests in flight
+   * @return the engine, or nullptr if the kernel does not support io_uring or does not allow it
+   */
+  static auto Create(PageLocator locate, size_t queue_depth) -> std::unique_ptr<UringIOEngine>;
+
+  DISALLOW_COPY_AND_MOVE(UringIOEngine);
+
+  /** Waits for the requests in flight. */
+  ~UringIOEngine() override;
+
+  auto Submit(bool is_write, page_id_t page_id, char *data) -> std::future<bool> override;
+
+  auto SubmitWrite(page_id_t page_id, AlignedPage page) -> std::future<bool> override;
+
+  auto GetName() const -> const char * override { return "io_uring"; }
+
+ private:
+  UringIOEngine() = default;
+
+  /** @brief Hand a request to the ring, or carry it out right away if the ring refuses it. */
+  auto SubmitRequest(IORequest *request) -> std::future<bool>;
+
+  /**
+   * @brief Queue the entry of a request and submit it, retrying while the ring is busy. Caller holds latch_.
+   * @return false if the kernel did not take the entry, which is then taken off the queue again
+   */
+  auto SubmitLocked(IORequest *request) -> bool;
+
+  /** @brief Complete requests as the ring reports them, until stopping_ is set and nothing is in flight. */
+  void ReapLoop();
+
+  /** @brief Give up on a ring that keeps failing: carry out the requests in flight here, and bypass it from now on. */
+  void AbandonRing();
+
+  /** @brief Finish a request whose transfer stopped short or failed, with plain pread()/pwrite(). */
+  void CompleteSynchronously(IORequest *request, int32_t transferred);
+
+  PageLocator locate_;
+  int ring_fd_{-1};
+  size_t queue_depth_{0};
+  void *sq_ring_{nullptr};
+  size_t sq_ring_size_{0};
+  void *cq_ring_{nullptr};
+  size_t cq_ring_size_{0};
+  void *sqes_{nullptr};
+  size_t sqes_size_{0};
+
+  /** Fields of the shared rings. */
+  uint32_t *sq_head_{nullptr};
+  uint32_t *sq_tail_{nullptr};
+  uint32_t sq_mask_{0};
+  uint32_t *sq_array_{nullptr};
+  uint32_t *cq_head_{nullptr};
+  uint32_t *cq_tail_{nullptr};
+  uint32_t cq_mask_{0};
+  void *cqes_{nullptr};
+
+  /** Protects the submission queue, in_flight_, stopping_ and broken_. */
+  std::mutex latch_;
+  /** Signalled when requests leave the ring. */
+  std::condition_variable space_cv_;
+  /** Signalled when requests enter the ring, and on shutdown. */
+  std::condition_variable reaper_cv_;
+  /** The requests submitted to the ring and not reaped yet. */
+  std::unordered_set<IORequest *> in_flight_;
+  bool stopping_{false};
+  bool broken_{false};
+  std::thread reaper_;
+};
+
+/**
+ * IOEngine that hands requests to a pool of threads doing blocking ReadPage()/WritePage() calls on a disk manager.
+ * Works with every disk manager and kernel; the queue depth is the number of workers.
+ */
+class ThreadPoolIOEngine : public IOEngine {
+ public:
+  /**
+   * @brief Start the workers.
+   * @param disk_manager serves the requests; must outlive the engine
+   * @param num_workers number of threads, and thereby requests in flight
+   */
+  ThreadPoolIOEngine(DiskManager *disk_manager, size_t num_workers);
+
+  DISALLOW_COPY_AND_MOVE(ThreadPoolIOEngine);
+
+  /** Finishes the queued requests and stops the workers. */
+  ~ThreadPoolIOEngine() override;
+
+  auto Submit(bool is_write, page_id_t page_id, char *data) -> std::future<bool> override;
+
+  auto SubmitWrite(page_id_t page_id, AlignedPage page) -> std::future<bool> override;
+
+  auto GetName() const -> const char * override { return "threadpool"; }
+
+ private:
+  auto SubmitRequest(IORequest request) -> std::future<bool>;
+
+  void WorkerLoop();
+
+  DiskManager *disk_manager_;
+  std::mutex latch_;
+  std::condition_variable cv_;
+  std::deque<IORequest> queue_;
+  bool running_{true};
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace bustub
@@ -10,6 +10,7 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <atomic>
 #include <queue>
 #include <string>
 #include <vector>
@@ -105,6 +106,15 @@ class BPlusTree {
  private:
   void UpdateRootPageId(int insert_record = 0);
 
+  /**
+   * Point lookup with optimistic reads only: every page on the path is pinned and validated against its version
+   * instead of being read latched. The parent is validated again after the child's version has been taken, so the
+   * child cannot have been split or merged away in between.
+   * @param[out] found whether the key exists, only set on success
+   * @return false if the lookup conflicted with a writer and has to be retried
+   */
+  auto GetValueOptimistic(const KeyType &key, std::vector<ValueType> *result, bool *found) -> bool;
+
   /* Debug Routines for FREE!! */
   void ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstream &out) const;
 
@@ -112,7 +122,8 @@ class BPlusTree {
 
   // member variable
   std::string index_name_;
-  page_id_t root_page_id_;
+  /** Atomic because GetValueOptimistic() reads it without the root latch. */
+  std::atomic<page_id_t> root_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
   int leaf_max_size_;
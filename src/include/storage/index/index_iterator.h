@@ -13,6 +13,7 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include "buffer/read_ahead.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
@@ -46,7 +47,12 @@ class IndexIterator {
   int index_;
   page_id_t page_id_;
   BufferPoolManager *buffer_pool_manager_;
+  Page *page_ptr_{nullptr};
   B_PLUS_TREE_LEAF_PAGE_TYPE *leaf_page_ptr_;
+  // copy of the current entry, read optimistically from the leaf
+  MappingType item_;
+  // prefetches the leaves following the current one while the leaf chain is laid out sequentially
+  ReadAhead read_ahead_;
 };
 
 }  // namespace bustub
@@ -139,6 +139,8 @@ class HashTableBlockPage {
   void PrintBucket();
 
  private:
+  // The common page header, see Page::SIZE_PAGE_HEADER.
+  __attribute__((unused)) char page_header_[Page::SIZE_PAGE_HEADER];
   std::atomic_char occupied_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
 
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
@@ -25,11 +25,12 @@ namespace bustub {
  * non-unique keys.
  *
  * Bucket page format (keys are stored in order):
- *  ----------------------------------------------------------------
- * | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
- *  ----------------------------------------------------------------
+ *  -------------------------------------------------------------------------
+ * | HEADER | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
+ *  -------------------------------------------------------------------------
  *
  *  Here '+' means concatenation.
+ *  HEADER is the common page header, see Page::SIZE_PAGE_HEADER.
  *  The above format omits the space required for the occupied_ and
  *  readable_ arrays. More information is in storage/page/hash_table_page_defs.h.
  *
@@ -138,6 +139,8 @@ class HashTableBucketPage {
   void PrintBucket();
 
  private:
+  // The common page header, see Page::SIZE_PAGE_HEADER.
+  __attribute__((unused)) char page_header_[Page::SIZE_PAGE_HEADER];
   //  For more on BUCKET_ARRAY_SIZE see storage/page/hash_table_page_defs.h
   char occupied_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
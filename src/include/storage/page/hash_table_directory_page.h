@@ -27,9 +27,9 @@ namespace bustub {
  * Directory Page for extendible hash table.
  *
  * Directory format (size in byte):
- * --------------------------------------------------------------------------------------------
- * | LSN (4) | PageId(4) | GlobalDepth(4) | LocalDepths(512) | BucketPageIds(2048) | Free(1524)
- * --------------------------------------------------------------------------------------------
+ * -----------------------------------------------------------------------------------------------------------
+ * | PageId(4) | LSN (4) | Checksum(4) | GlobalDepth(4) | LocalDepths(512) | BucketPageIds(2048) | Free(1520)
+ * -----------------------------------------------------------------------------------------------------------
  */
 class HashTableDirectoryPage {
  public:
@@ -189,6 +189,8 @@ class HashTableDirectoryPage {
  private:
   page_id_t page_id_;
   lsn_t lsn_;
+  // filled in by the disk manager, see Page::OFFSET_CHECKSUM
+  __attribute__((unused)) uint32_t checksum_;
   uint32_t global_depth_{0};
   uint8_t local_depths_[DIRECTORY_ARRAY_SIZE];
   page_id_t bucket_page_ids_[DIRECTORY_ARRAY_SIZE];
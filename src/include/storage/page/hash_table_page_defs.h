@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include "storage/page/page.h"
+
 #define MappingType std::pair<KeyType, ValueType>
 
 /**
@@ -24,9 +26,9 @@
  * approximate calculation based on the size of MappingType (which is a std::pair of KeyType and ValueType). For each
  * key/value pair, we need two additional bits for occupied_ and readable_. 4 * BUSTUB_PAGE_SIZE / (4 * sizeof
  * (MappingType) + 1) = BUSTUB_PAGE_SIZE/(sizeof (MappingType) + 0.25) because 0.25 bytes = 2 bits is the space required
- * to maintain the occupied and readable flags for a key value pair.
+ * to maintain the occupied and readable flags for a key value pair. The common page header, see Page, comes first.
  */
-#define BLOCK_ARRAY_SIZE (4 * BUSTUB_PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+#define BLOCK_ARRAY_SIZE (4 * (BUSTUB_PAGE_SIZE - Page::SIZE_PAGE_HEADER) / (4 * sizeof(MappingType) + 1))
 
 /**
  * Extendible Hashing Definitions
@@ -38,12 +40,12 @@
  * The computation is the same as the above BLOCK_ARRAY_SIZE, but blocks and buckets have different implementations
  * of search, insertion, removal, and helper methods.
  */
-#define BUCKET_ARRAY_SIZE (4 * BUSTUB_PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+#define BUCKET_ARRAY_SIZE (4 * (BUSTUB_PAGE_SIZE - Page::SIZE_PAGE_HEADER) / (4 * sizeof(MappingType) + 1))
 
 /**
  * DIRECTORY_ARRAY_SIZE is the number of page_ids that can fit in the directory page of an extendible hash index.
  * This is 512 because the directory array must grow in powers of 2, and 1024 page_ids leaves zero room for
- * storage of the other member variables: page_id_, lsn_, global_depth_, and the array local_depths_.
+ * storage of the other member variables: page_id_, lsn_, checksum_, global_depth_, and the array local_depths_.
  * Extending the directory implementation to span multiple pages would be a meaningful improvement to the
  * implementation.
  */
@@ -22,9 +22,9 @@ namespace bustub {
  * 32 bytes) and their corresponding root_id
  *
  * Format (size in byte):
- *  -----------------------------------------------------------------
- * | RecordCount (4) | Entry_1 name (32) | Entry_1 root_id (4) | ... |
- *  -----------------------------------------------------------------
+ *  --------------------------------------------------------------------------------------------
+ * | RecordCount (4) | LSN (4) | Checksum (4) | Entry_1 name (32) | Entry_1 root_id (4) | ... |
+ *  --------------------------------------------------------------------------------------------
  */
 class HeaderPage : public Page {
  public:
@@ -47,5 +47,7 @@ class HeaderPage : public Page {
   auto FindRecord(const std::string &name) -> int;
 
   void SetRecordCount(int record_count);
+
+  static constexpr size_t OFFSET_RECORDS = SIZE_PAGE_HEADER;
 };
 }  // namespace bustub
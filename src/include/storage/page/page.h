@@ -12,8 +12,10 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstring>
 #include <iostream>
+#include <memory>
 
 #include "common/config.h"
 #include "common/rwlatch.h"
@@ -24,14 +26,23 @@ namespace bustub {
  * Page is the basic unit of storage within the database system. Page provides a wrapper for actual data pages being
  * held in main memory. Page also contains book-keeping information that is used by the buffer pool manager, e.g.
  * pin count, dirty flag, page id, etc.
+ *
+ * The data does not live inside the Page object. Pages of a buffer pool point into the page-aligned data region of
+ * its FrameArena, so that the book-keeping of all frames stays packed together and the data stays aligned.
  */
 class Page {
   // There is book-keeping information inside the page that should only be relevant to the buffer pool manager.
   friend class BufferPoolManagerInstance;
 
  public:
-  /** Constructor. Zeros out the page data. */
-  Page() { ResetMemory(); }
+  /** Constructor for a page outside of a buffer pool. Allocates page data of its own and zeros it out. */
+  Page() : owned_data_(new char[BUSTUB_PAGE_SIZE]), data_(owned_data_.get()) { ResetMemory(); }
+
+  /**
+   * Constructor for a buffer pool frame.
+   * @param data BUSTUB_PAGE_SIZE bytes that outlive the page; the buffer pool resets them before every use
+   */
+  explicit Page(char *data) : data_(data) {}
 
   /** Default destructor. */
   ~Page() = default;
@@ -48,11 +59,18 @@ class Page {
   /** @return true if the page in memory has been modified from the page on disk, false otherwise */
   inline auto IsDirty() -> bool { return is_dirty_; }
 
-  /** Acquire the page write latch. */
-  inline void WLatch() { rwlatch_.WLock(); }
+  /** Acquire the page write latch. Makes the version odd until WUnlatch(). */
+  inline void WLatch() {
+    rwlatch_.WLock();
+    version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
 
   /** Release the page write latch. */
-  inline void WUnlatch() { rwlatch_.WUnlock(); }
+  inline void WUnlatch() {
+    version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    rwlatch_.WUnlock();
+  }
 
   /** Acquire the page read latch. */
   inline void RLatch() { rwlatch_.RLock(); }
@@ -60,34 +78,84 @@ class Page {
   /** Release the page read latch. */
   inline void RUnlatch() { rwlatch_.RUnlock(); }
 
+  /**
+   * Start an optimistic read, which does not write to the page at all. Everything read from the page until
+   * ValidateOptimisticRead() succeeds may be torn and must not be trusted, e.g. as an array index or a page id.
+   * The page must stay pinned during the read.
+   * @param[out] version the version to validate the read against
+   * @return false if a writer holds the latch right now
+   */
+  inline auto TryOptimisticRead(uint64_t *version) -> bool {
+    *version = version_.load(std::memory_order_acquire);
+    return (*version & 1) == 0;
+  }
+
+  /** @return true if no writer latched the page since TryOptimisticRead() returned version */
+  inline auto ValidateOptimisticRead(uint64_t version) -> bool {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return version_.load(std::memory_order_relaxed) == version;
+  }
+
+  /**
+   * Run read() as an optimistic read, retrying up to OPTIMISTIC_READ_RETRIES times, and under the read latch if it
+   * keeps conflicting with writers. read() may run several times and must only copy out of the page.
+   */
+  template <typename ReadFunc>
+  inline void ReadOptimistically(ReadFunc &&read) {
+    for (int i = 0; i < OPTIMISTIC_READ_RETRIES; i++) {
+      uint64_t version;
+      if (TryOptimisticRead(&version)) {
+        read();
+        if (ValidateOptimisticRead(version)) {
+          return;
+        }
+      }
+    }
+    RLatch();
+    read();
+    RUnlatch();
+  }
+
   /** @return the page LSN. */
   inline auto GetLSN() -> lsn_t { return *reinterpret_cast<lsn_t *>(GetData() + OFFSET_LSN); }
 
   /** Sets the page LSN. */
   inline void SetLSN(lsn_t lsn) { memcpy(GetData() + OFFSET_LSN, &lsn, sizeof(lsn_t)); }
 
- protected:
   static_assert(sizeof(page_id_t) == 4);
   static_assert(sizeof(lsn_t) == 4);
 
-  static constexpr size_t SIZE_PAGE_HEADER = 8;
+  /**
+   * Every kind of page starts with this header:
+   *  -----------------------------------------------
+   * | PageId or PageType (4) | LSN (4) | Checksum (4) |
+   *  -----------------------------------------------
+   * The first field is up to the kind of page. The checksum belongs to the DiskManager, which fills it in when it
+   * writes the page and verifies it when it reads the page back; page layouts must leave it alone.
+   */
+  static constexpr size_t SIZE_PAGE_HEADER = 12;
   static constexpr size_t OFFSET_PAGE_START = 0;
   static constexpr size_t OFFSET_LSN = 4;
+  static constexpr size_t OFFSET_CHECKSUM = 8;
 
  private:
   /** Zeroes out the data that is held within the page. */
   inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, BUSTUB_PAGE_SIZE); }
 
+  /** Data allocated by the page itself, if it does not belong to a buffer pool. */
+  std::unique_ptr<char[]> owned_data_;
   /** The actual data that is stored within a page. */
-  char data_[BUSTUB_PAGE_SIZE]{};
+  char *data_;
   /** The ID of this page. */
   page_id_t page_id_ = INVALID_PAGE_ID;
-  /** The pin count of this page. */
-  int pin_count_ = 0;
+  /** The pin count of this page. Atomic because buffer pool hits pin the page without the pool's latch. */
+  std::atomic<int> pin_count_{0};
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
   bool is_dirty_ = false;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
+  /** Bumped by WLatch() and WUnlatch(), odd while a writer holds the latch. */
+  std::atomic<uint64_t> version_{0};
 };
 
 }  // namespace bustub
@@ -33,9 +33,9 @@ namespace bustub {
  *                                free space pointer
  *
  *  Header format (size in bytes):
- *  ----------------------------------------------------------------------------
- *  | PageId (4)| LSN (4)| PrevPageId (4)| NextPageId (4)| FreeSpacePointer(4) |
- *  ----------------------------------------------------------------------------
+ *  ----------------------------------------------------------------------------------------------
+ *  | PageId (4)| LSN (4)| Checksum (4)| PrevPageId (4)| NextPageId (4)| FreeSpacePointer(4) |
+ *  ----------------------------------------------------------------------------------------------
  *  ----------------------------------------------------------------
  *  | TupleCount (4) | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
  *  ----------------------------------------------------------------
@@ -141,14 +141,14 @@ class TablePage : public Page {
  private:
   static_assert(sizeof(page_id_t) == 4);
 
-  static constexpr size_t SIZE_TABLE_PAGE_HEADER = 24;
+  static constexpr size_t SIZE_TABLE_PAGE_HEADER = SIZE_PAGE_HEADER + 16;
   static constexpr size_t SIZE_TUPLE = 8;
-  static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
-  static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
-  static constexpr size_t OFFSET_FREE_SPACE = 16;
-  static constexpr size_t OFFSET_TUPLE_COUNT = 20;
-  static constexpr size_t OFFSET_TUPLE_OFFSET = 24;  // Naming things is hard.
-  static constexpr size_t OFFSET_TUPLE_SIZE = 28;
+  static constexpr size_t OFFSET_PREV_PAGE_ID = SIZE_PAGE_HEADER;
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = SIZE_PAGE_HEADER + 4;
+  static constexpr size_t OFFSET_FREE_SPACE = SIZE_PAGE_HEADER + 8;
+  static constexpr size_t OFFSET_TUPLE_COUNT = SIZE_PAGE_HEADER + 12;
+  static constexpr size_t OFFSET_TUPLE_OFFSET = SIZE_TABLE_PAGE_HEADER;  // Naming things is hard.
+  static constexpr size_t OFFSET_TUPLE_SIZE = SIZE_TABLE_PAGE_HEADER + 4;
 
   /** @return pointer to the end of the current free space, see header comment */
   auto GetFreeSpacePointer() -> uint32_t { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
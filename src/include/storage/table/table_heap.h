@@ -12,6 +12,11 @@
 
 #pragma once
 
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
@@ -99,8 +104,22 @@ class TableHeap {
    */
   auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock = true) -> bool;
 
-  /** @return the begin iterator of this table */
-  auto Begin(Transaction *txn) -> TableIterator;
+  /**
+   * Read several tuples, fetching the pages they live on with one FetchPages() call. Pages that call cannot pin, for
+   * lack of frames, are fetched one at a time afterwards.
+   * @param rids rids of the tuples to read
+   * @param[out] tuples the tuple for every entry of rids; tuples that do not exist are left empty
+   * @param txn transaction performing the read
+   * @return false if a page could not be fetched even on its own, in which case the transaction is aborted
+   */
+  auto GetTuples(const std::vector<RID> &rids, std::vector<Tuple> *tuples, Transaction *txn) -> bool;
+
+  /**
+   * @param txn the transaction performing the scan
+   * @param strategy buffer access strategy the scan reads pages with, nullptr to compete for the whole pool
+   * @return the begin iterator of this table
+   */
+  auto Begin(Transaction *txn, std::shared_ptr<BufferAccessStrategy> strategy = nullptr) -> TableIterator;
 
   /** @return the end iterator of this table */
   auto End() -> TableIterator;
@@ -108,11 +127,27 @@ class TableHeap {
   /** @return the id of the first page of this table */
   inline auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
 
+  /** GetNumPages() of a table that was opened and not yet scanned to the end. */
+  static constexpr size_t UNKNOWN_NUM_PAGES = std::numeric_limits<size_t>::max();
+
+  /**
+   * @return the number of pages of this table, or UNKNOWN_NUM_PAGES for a table that was opened by its first page
+   * until a scan has walked all of it
+   */
+  inline auto GetNumPages() const -> size_t { return num_pages_; }
+
  private:
   BufferPoolManager *buffer_pool_manager_;
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+  std::atomic<size_t> num_pages_{0};
+
+  /** Set the number of pages found by a scan that walked the whole table, unless it is known already. */
+  void LearnNumPages(size_t num_pages);
+
+  /** Count a page added to the table, if the number of pages is known. */
+  void CountNewPage();
 };
 
 }  // namespace bustub
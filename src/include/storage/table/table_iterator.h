@@ -13,7 +13,9 @@
 #pragma once
 
 #include <cassert>
+#include <memory>
 
+#include "buffer/read_ahead.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
 #include "storage/table/tuple.h"
@@ -27,12 +29,19 @@ class TableHeap;
  */
 class TableIterator {
   friend class Cursor;
+  friend class TableHeap;
 
  public:
-  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn);
+  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn,
+                std::shared_ptr<BufferAccessStrategy> strategy = nullptr);
 
   TableIterator(const TableIterator &other)
-      : table_heap_(other.table_heap_), tuple_(new Tuple(*other.tuple_)), txn_(other.txn_) {}
+      : table_heap_(other.table_heap_),
+        tuple_(new Tuple(*other.tuple_)),
+        txn_(other.txn_),
+        strategy_(other.strategy_),
+        read_ahead_(other.read_ahead_),
+        pages_seen_(other.pages_seen_) {}
 
   ~TableIterator() { delete tuple_; }
 
@@ -54,6 +63,9 @@ class TableIterator {
     table_heap_ = other.table_heap_;
     *tuple_ = *other.tuple_;
     txn_ = other.txn_;
+    strategy_ = other.strategy_;
+    read_ahead_ = other.read_ahead_;
+    pages_seen_ = other.pages_seen_;
     return *this;
   }
 
@@ -61,6 +73,12 @@ class TableIterator {
   TableHeap *table_heap_;
   Tuple *tuple_;
   Transaction *txn_;
+  /** Buffer access strategy of the scan, nullptr if the scan uses the whole buffer pool. */
+  std::shared_ptr<BufferAccessStrategy> strategy_;
+  /** Prefetches the pages following the one the iterator is on. */
+  ReadAhead read_ahead_;
+  /** Pages of the table up to the one the iterator is on, for an iterator from TableHeap::Begin(); 0 otherwise. */
+  size_t pages_seen_{0};
 };
 
 }  // namespace bustub
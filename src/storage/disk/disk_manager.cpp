@@ -10,27 +10,107 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <fstream>
+#include <future>  // NOLINT
 #include <iostream>
-#include <mutex>  // NOLINT
+#include <iterator>
+#include <memory>
+#include <shared_mutex>
+#include <sstream>
 #include <string>
 #include <thread>  // NOLINT
+#include <utility>
+#include <vector>
 
 #include "common/exception.h"
 #include "common/logger.h"
+#include "common/util/crc32c.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
 
 namespace bustub {
 
 static char *buffer_used;
 
+namespace {
 /**
- * Constructor: open/create a single database file & log file
+ * Read or write a run of pages at offset of a file with as few preadv()/pwritev() calls as possible, resuming after
+ * short transfers.
+ * @return the number of bytes transferred, less than the whole run only if the file ends; -1 on an I/O error
+ */
+auto TransferPages(int fd, bool write, char *const *pages, size_t num_pages, off_t offset) -> ssize_t {
+  size_t total = num_pages * BUSTUB_PAGE_SIZE;
+  size_t done = 0;
+  std::vector<iovec> iov;
+  while (done < total) {
+    iov.clear();
+    size_t first = done / BUSTUB_PAGE_SIZE;
+    for (size_t i = first; i < num_pages && iov.size() < IOV_MAX; i++) {
+      size_t skip = i == first ? done % BUSTUB_PAGE_SIZE : 0;
+      iov.push_back({pages[i] + skip, BUSTUB_PAGE_SIZE - skip});
+    }
+    ssize_t transferred = write ? pwritev(fd, iov.data(), static_cast<int>(iov.size()), offset + done)
+                                : preadv(fd, iov.data(), static_cast<int>(iov.size()), offset + done);
+    if (transferred < 0 && errno == EINTR) {
+      continue;
+    }
+    if (transferred < 0) {
+      return -1;
+    }
+    if (transferred == 0) {
+      break;
+    }
+    done += transferred;
+  }
+  return static_cast<ssize_t>(done);
+}
+
+auto PageOffset(page_id_t page_id) -> off_t { return static_cast<off_t>(page_id) * BUSTUB_PAGE_SIZE; }
+
+auto IsAligned(const char *data) -> bool { return reinterpret_cast<uintptr_t>(data) % DIRECT_IO_ALIGNMENT == 0; }
+
+/** @return a page-sized buffer aligned for O_DIRECT, one per thread */
+auto BounceBuffer() -> char * {
+  thread_local AlignedPage buffer = AllocateAlignedPage();
+  return buffer.get();
+}
+
+/** Pages of a run that are copied and stamped at a time. */
+constexpr size_t STAMP_CHUNK_PAGES = 32;
+
+/** @return STAMP_CHUNK_PAGES page-sized buffers aligned for O_DIRECT, one set per thread */
+auto StampBuffers() -> char *const * {
+  thread_local AlignedPage buffer(static_cast<char *>(
+      aligned_alloc(DIRECT_IO_ALIGNMENT, STAMP_CHUNK_PAGES * BUSTUB_PAGE_SIZE)));  // NOLINT
+  thread_local std::vector<char *> pages = [] {
+    std::vector<char *> pages(STAMP_CHUNK_PAGES);
+    for (size_t i = 0; i < STAMP_CHUNK_PAGES; i++) {
+      pages[i] = buffer.get() + i * BUSTUB_PAGE_SIZE;
+    }
+    return pages;
+  }();
+  return pages.data();
+}
+}  // namespace
+
+/**
+ * Constructor: open/create the first segment of the database file & log file
  * @input db_file: database file name
  */
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+DiskManager::DiskManager(const std::string &db_file, bool direct_io, size_t segment_pages)
+    : file_name_(db_file), segment_pages_(segment_pages) {
   std::string::size_type n = file_name_.rfind('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
@@ -49,79 +129,498 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
     }
   }
 
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
-    if (!db_io_.is_open()) {
-      throw Exception("can't open db file");
-    }
+  // Segment 0 is opened right away, so that a bad path fails here and not on the first write.
+  direct_io_ = direct_io;
+  if (SegmentFd(0, true) < 0) {
+    throw Exception("can't open db file");
   }
+  LoadFreePages();
   buffer_used = nullptr;
 }
 
+DiskManager::~DiskManager() {
+  io_engine_.reset();
+  CloseSegments();
+}
+
 /**
  * Close all file streams
  */
 void DiskManager::ShutDown() {
-  {
-    std::scoped_lock scoped_db_io_latch(db_io_latch_);
-    db_io_.close();
-  }
+  io_engine_.reset();
+  Sync();
+  CloseSegments();
   log_io_.close();
 }
 
+/**
+ * Sync the data of the db file to the device
+ */
+void DiskManager::Sync() {
+  SyncSegments();
+  // The map goes after the data, so that the pages it lists as in use have their contents on disk.
+  if (!file_name_.empty()) {
+    SaveFreePages();
+  }
+}
+
+void DiskManager::SyncSegments() {
+  std::shared_lock<std::shared_mutex> lock(segments_latch_);
+  for (int fd : segment_fds_) {
+    if (fd >= 0 && fdatasync(fd) != 0) {
+      LOG_DEBUG("I/O error while syncing");
+    }
+  }
+}
+
 /**
  * Write the contents of the specified page into disk file
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  size_t offset = static_cast<size_t>(page_id) * BUSTUB_PAGE_SIZE;
-  // set write cursor to offset
+  WritePages(page_id, &page_data, 1);
+}
+
+/**
+ * Write a run of consecutive pages with one pwritev() per segment
+ */
+void DiskManager::WritePages(page_id_t first_page_id, const char *const *pages, size_t num_pages) {
   num_writes_ += 1;
-  db_io_.seekp(offset);
-  db_io_.write(page_data, BUSTUB_PAGE_SIZE);
-  // check for I/O error
-  if (db_io_.bad()) {
-    LOG_DEBUG("I/O error while writing");
+  if (!checksums_) {
+    // pwritev() does not write to the buffers, the iovec type just lacks a const variant.
+    if (!TransferRun(true, first_page_id, const_cast<char *const *>(pages), num_pages)) {
+      ReportIOError("I/O error while writing");
+    }
     return;
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
+  // The pages are stamped in copies; the caller's buffers may be frames that others read meanwhile.
+  char *const *copies = StampBuffers();
+  for (size_t i = 0; i < num_pages; i += STAMP_CHUNK_PAGES) {
+    size_t chunk = std::min(num_pages - i, STAMP_CHUNK_PAGES);
+    auto chunk_page_id = first_page_id + static_cast<page_id_t>(i);
+    for (size_t j = 0; j < chunk; j++) {
+      memcpy(copies[j], pages[i + j], BUSTUB_PAGE_SIZE);
+      StampChecksum(chunk_page_id + static_cast<page_id_t>(j), copies[j]);
+    }
+    if (!TransferRun(true, chunk_page_id, copies, chunk)) {
+      ReportIOError("I/O error while writing");
+      return;
+    }
+  }
 }
 
 /**
  * Read the contents of the specified page into the given memory area
  */
-void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  int offset = page_id * BUSTUB_PAGE_SIZE;
-  // check if read beyond file length
-  if (offset > GetFileSize(file_name_)) {
-    LOG_DEBUG("I/O error reading past end of file");
-    // std::cerr << "I/O error while reading" << std::endl;
+void DiskManager::ReadPage(page_id_t page_id, char *page_data) { ReadPages(page_id, &page_data, 1); }
+
+/**
+ * Read a run of consecutive pages with one preadv() per segment
+ */
+void DiskManager::ReadPages(page_id_t first_page_id, char *const *pages, size_t num_pages) {
+  if (!TransferRun(false, first_page_id, pages, num_pages)) {
+    ReportIOError("I/O error while reading");
+    return;
+  }
+  for (size_t i = 0; checksums_ && i < num_pages; i++) {
+    CheckPage(first_page_id + static_cast<page_id_t>(i), pages[i]);
+  }
+}
+
+namespace {
+/** The checksum of a page covers its id and everything but the checksum field itself. */
+auto PageChecksum(page_id_t page_id, const char *page_data) -> uint32_t {
+  uint32_t crc = Crc32c::Compute(reinterpret_cast<const char *>(&page_id), sizeof(page_id));
+  crc = Crc32c::Extend(crc, page_data, Page::OFFSET_CHECKSUM);
+  constexpr size_t checksum_end = Page::OFFSET_CHECKSUM + sizeof(uint32_t);
+  crc = Crc32c::Extend(crc, page_data + checksum_end, BUSTUB_PAGE_SIZE - checksum_end);
+  // 0 is left to pages that were never written.
+  return crc == 0 ? 1 : crc;
+}
+}  // namespace
+
+void DiskManager::StampChecksum(page_id_t page_id, char *page_data) {
+  uint32_t checksum = PageChecksum(page_id, page_data);
+  memcpy(page_data + Page::OFFSET_CHECKSUM, &checksum, sizeof(checksum));
+}
+
+auto DiskManager::VerifyChecksum(page_id_t page_id, const char *page_data) -> bool {
+  uint32_t stored;
+  memcpy(&stored, page_data + Page::OFFSET_CHECKSUM, sizeof(stored));
+  if (stored == 0) {
+    return std::all_of(page_data, page_data + BUSTUB_PAGE_SIZE, [](char c) { return c == 0; });
+  }
+  return stored == PageChecksum(page_id, page_data);
+}
+
+void DiskManager::CheckPage(page_id_t page_id, const char *page_data) {
+  if (!VerifyChecksum(page_id, page_data)) {
+    ReportCorruptPage(page_id);
+  }
+}
+
+namespace {
+thread_local uint64_t thread_io_errors = 0;
+}  // namespace
+
+auto DiskManager::GetThreadIOErrors() -> uint64_t { return thread_io_errors; }
+
+void DiskManager::ReportIOError(const char *message) {
+  thread_io_errors++;
+  LOG_DEBUG("%s", message);
+}
+
+void DiskManager::ReportCorruptPage(page_id_t page_id) {
+  num_checksum_failures_ += 1;
+  LOG_WARN("page %d was read corrupt", page_id);
+  if (checksum_failure_handler_) {
+    checksum_failure_handler_(page_id);
+  }
+}
+
+auto DiskManager::TransferRun(bool write, page_id_t first_page_id, char *const *pages, size_t num_pages) -> bool {
+  // A negative id, such as INVALID_PAGE_ID, would be taken for a page far beyond the last segment.
+  if (first_page_id < 0) {
+    return false;
+  }
+  if (direct_io_ && !std::all_of(pages, pages + num_pages, IsAligned)) {
+    char *bounce = BounceBuffer();
+    for (size_t i = 0; i < num_pages; i++) {
+      if (write) {
+        memcpy(bounce, pages[i], BUSTUB_PAGE_SIZE);
+      }
+      if (!TransferRun(write, first_page_id + static_cast<page_id_t>(i), &bounce, 1)) {
+        return false;
+      }
+      if (!write) {
+        memcpy(pages[i], bounce, BUSTUB_PAGE_SIZE);
+      }
+    }
+    return true;
+  }
+  for (size_t i = 0; i < num_pages;) {
+    auto page_id = first_page_id + static_cast<page_id_t>(i);
+    size_t in_segment = std::min(num_pages - i, segment_pages_ - static_cast<size_t>(page_id) % segment_pages_);
+    off_t offset;
+    int fd = LocatePage(page_id, write, &offset);
+    ssize_t transferred = 0;
+    if (fd >= 0) {
+      transferred = TransferPages(fd, write, pages + i, in_segment, offset);
+      if (transferred < 0 && errno == EINVAL && direct_io_) {
+        DisableDirectIO();
+        transferred = TransferPages(fd, write, pages + i, in_segment, offset);
+      }
+    }
+    if (transferred < 0 || (fd < 0 && write)) {
+      return false;
+    }
+    // The part of a segment past the end of its file, or of a segment without a file, reads as zeros.
+    for (auto j = static_cast<size_t>(transferred) / BUSTUB_PAGE_SIZE; !write && j < in_segment; j++) {
+      size_t in_page = j == static_cast<size_t>(transferred) / BUSTUB_PAGE_SIZE ? transferred % BUSTUB_PAGE_SIZE : 0;
+      memset(pages[i + j] + in_page, 0, BUSTUB_PAGE_SIZE - in_page);
+    }
+    i += in_segment;
+  }
+  return true;
+}
+
+auto DiskManager::LocatePage(page_id_t page_id, bool create, off_t *offset) -> int {
+  if (page_id < 0) {
+    return -1;
+  }
+  *offset = PageOffset(static_cast<page_id_t>(static_cast<size_t>(page_id) % segment_pages_));
+  return SegmentFd(static_cast<size_t>(page_id) / segment_pages_, create);
+}
+
+auto DiskManager::SegmentFd(size_t segment, bool create) -> int {
+  {
+    std::shared_lock<std::shared_mutex> lock(segments_latch_);
+    if (segment < segment_fds_.size() && segment_fds_[segment] >= 0) {
+      return segment_fds_[segment];
+    }
+  }
+  std::unique_lock<std::shared_mutex> lock(segments_latch_);
+  if (segment >= segment_fds_.size()) {
+    segment_fds_.resize(segment + 1, -1);
+  }
+  if (segment_fds_[segment] >= 0) {
+    return segment_fds_[segment];
+  }
+  std::string name = segment == 0 ? file_name_ : file_name_ + "." + std::to_string(segment);
+  int flags = O_RDWR | (create ? O_CREAT : 0);
+  int fd = -1;
+  if (direct_io_) {
+    fd = open(name.c_str(), flags | O_DIRECT, 0644);
+    // A missing segment says nothing about O_DIRECT; any other failure is taken as the file system refusing it.
+    if (fd < 0 && errno != ENOENT) {
+      direct_io_ = false;
+    }
+  }
+  if (fd < 0 && !direct_io_) {
+    fd = open(name.c_str(), flags, 0644);
+  }
+  if (fd < 0) {
+    // Reads of a segment that was never written do not create it.
+    return -1;
+  }
+  if (create && preallocate_segments_) {
+    struct stat stat_buf;
+    if (fstat(fd, &stat_buf) == 0 && stat_buf.st_size == 0 &&
+        posix_fallocate(fd, 0, static_cast<off_t>(segment_pages_) * BUSTUB_PAGE_SIZE) != 0) {
+      LOG_DEBUG("cannot preallocate segment");
+    }
+  }
+  segment_fds_[segment] = fd;
+  return fd;
+}
+
+void DiskManager::CloseSegments() {
+  std::unique_lock<std::shared_mutex> lock(segments_latch_);
+  for (int fd : segment_fds_) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+  segment_fds_.clear();
+}
+
+void DiskManager::DisableDirectIO() {
+  LOG_DEBUG("O_DIRECT refused, falling back to buffered I/O");
+  std::shared_lock<std::shared_mutex> lock(segments_latch_);
+  for (int fd : segment_fds_) {
+    int flags = fd >= 0 ? fcntl(fd, F_GETFL) : -1;
+    if (flags >= 0) {
+      fcntl(fd, F_SETFL, flags & ~O_DIRECT);
+    }
+  }
+  direct_io_ = false;
+}
+
+auto DiskManager::ReusePage(page_id_t hint, size_t stride, size_t residue) -> page_id_t {
+  std::scoped_lock<std::mutex> lock(free_pages_latch_);
+  page_id_t page_id = ClosestFreePage(hint, stride, residue);
+  if (page_id == INVALID_PAGE_ID) {
+    return INVALID_PAGE_ID;
+  }
+  free_pages_.erase(page_id);
+  free_in_segment_[static_cast<size_t>(page_id) / segment_pages_]--;
+  free_pages_dirty_ = true;
+  return page_id;
+}
+
+auto DiskManager::FindFreePage(page_id_t hint, size_t stride, size_t residue) -> page_id_t {
+  std::scoped_lock<std::mutex> lock(free_pages_latch_);
+  return ClosestFreePage(hint, stride, residue);
+}
+
+auto DiskManager::ClosestFreePage(page_id_t hint, size_t stride, size_t residue) -> page_id_t {
+  auto matches = [&](page_id_t page_id) { return static_cast<size_t>(page_id) % stride == residue; };
+  // The closest match at or above the hint, and the closest one below it.
+  auto above = free_pages_.lower_bound(hint);
+  auto below = std::make_reverse_iterator(above);
+  while (above != free_pages_.end() && !matches(*above)) {
+    above++;
+  }
+  while (below != free_pages_.rend() && !matches(*below)) {
+    below++;
+  }
+  if (above == free_pages_.end() && below == free_pages_.rend()) {
+    return INVALID_PAGE_ID;
+  }
+  if (below == free_pages_.rend() ||
+      (above != free_pages_.end() && static_cast<int64_t>(*above) - hint <= static_cast<int64_t>(hint) - *below)) {
+    return *above;
+  }
+  return *below;
+}
+
+void DiskManager::DeallocatePage(page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(free_pages_latch_);
+  if (page_id < 0 || !free_pages_.insert(page_id).second) {
+    return;
+  }
+  size_t segment = static_cast<size_t>(page_id) / segment_pages_;
+  if (segment >= free_in_segment_.size()) {
+    free_in_segment_.resize(segment + 1, 0);
+  }
+  free_in_segment_[segment]++;
+  free_pages_dirty_ = true;
+  // The old contents stay until a saved map lists the page as free, a crash before that brings the page back in use.
+  pending_release_.insert(page_id);
+}
+
+auto DiskManager::IsFreePage(page_id_t page_id) -> bool {
+  std::scoped_lock<std::mutex> lock(free_pages_latch_);
+  return free_pages_.count(page_id) != 0;
+}
+
+auto DiskManager::GetNumFreePages() -> size_t {
+  std::scoped_lock<std::mutex> lock(free_pages_latch_);
+  return free_pages_.size();
+}
+
+void DiskManager::ReleaseSpace(page_id_t page_id) {
+  if (file_name_.empty()) {
+    return;
+  }
+  size_t segment = static_cast<size_t>(page_id) / segment_pages_;
+  off_t offset;
+  int fd = LocatePage(page_id, false, &offset);
+  if (fd < 0) {
+    return;
+  }
+  // A segment goes as a whole only once the saved map lists all of its pages as free.
+  auto first = static_cast<page_id_t>(segment * segment_pages_);
+  auto pending = pending_release_.lower_bound(first);
+  bool saved = pending == pending_release_.end() || *pending >= first + static_cast<page_id_t>(segment_pages_);
+  int rc;
+  if (free_in_segment_[segment] < segment_pages_ || !saved) {
+    rc = fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, offset, BUSTUB_PAGE_SIZE);
+  } else if (segment > 0) {
+    rc = ftruncate(fd, 0);
   } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, BUSTUB_PAGE_SIZE);
-    if (db_io_.bad()) {
-      LOG_DEBUG("I/O error while reading");
+    // The database file keeps its size, LoadFreePages() takes an empty one for a new database.
+    rc = fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, 0,
+                   static_cast<off_t>(segment_pages_) * BUSTUB_PAGE_SIZE);
+  }
+  if (rc != 0) {
+    LOG_DEBUG("cannot release the space of a free page");
+  }
+}
+
+void DiskManager::LoadFreePages() {
+  std::string path = file_name_ + ".free";
+  if (GetFileSize(file_name_) <= 0) {
+    std::remove(path.c_str());
+    return;
+  }
+  std::ifstream in(path);
+  std::string magic;
+  int version;
+  if (!(in >> magic >> version) || magic != "bustub-free-pages" || version != 1) {
+    return;
+  }
+  std::scoped_lock<std::mutex> lock(free_pages_latch_);
+  page_id_t first;
+  size_t count;
+  // Runs of consecutive free pages, one "first count" pair per line.
+  while (in >> first >> count && first >= 0) {
+    for (auto page_id = first; page_id < first + static_cast<page_id_t>(count); page_id++) {
+      free_pages_.insert(page_id);
+      size_t segment = static_cast<size_t>(page_id) / segment_pages_;
+      if (segment >= free_in_segment_.size()) {
+        free_in_segment_.resize(segment + 1, 0);
+      }
+      free_in_segment_[segment]++;
+    }
+  }
+}
+
+void DiskManager::SaveFreePages() {
+  // One save at a time, so that an older map cannot replace a newer one.
+  std::scoped_lock<std::mutex> save_lock(save_free_pages_latch_);
+  std::ostringstream out;
+  std::set<page_id_t> released;
+  {
+    std::scoped_lock<std::mutex> lock(free_pages_latch_);
+    if (!free_pages_dirty_) {
       return;
     }
-    // if file ends before reading BUSTUB_PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < BUSTUB_PAGE_SIZE) {
-      LOG_DEBUG("Read less than a page");
-      db_io_.clear();
-      // std::cerr << "Read less than a page" << std::endl;
-      memset(page_data + read_count, 0, BUSTUB_PAGE_SIZE - read_count);
+    out << "bustub-free-pages 1\n";
+    for (auto it = free_pages_.begin(); it != free_pages_.end();) {
+      page_id_t first = *it;
+      page_id_t count = 0;
+      for (; it != free_pages_.end() && *it == first + count; it++) {
+        count++;
+      }
+      out << first << ' ' << count << '\n';
+    }
+    released.swap(pending_release_);
+    free_pages_dirty_ = false;
+  }
+  bool saved = ReplaceFileDurably(file_name_ + ".free", out.str());
+  std::scoped_lock<std::mutex> lock(free_pages_latch_);
+  if (!saved) {
+    pending_release_.insert(released.begin(), released.end());
+    free_pages_dirty_ = true;
+    return;
+  }
+  // The space is released under the latch, so that the page cannot be handed out and written again before that.
+  // Pages handed out since the map was taken keep it, the ones freed again wait for the next map.
+  for (page_id_t page_id : released) {
+    if (free_pages_.count(page_id) != 0 && pending_release_.count(page_id) == 0) {
+      ReleaseSpace(page_id);
     }
   }
 }
 
+auto DiskManager::GetIOEngine() -> IOEngine * {
+  std::call_once(io_engine_once_, [this] {
+    if (io_engine_ == nullptr && !file_name_.empty()) {
+      io_engine_ = UringIOEngine::Create(
+          [this](page_id_t page_id, bool create, off_t *offset) { return LocatePage(page_id, create, offset); },
+          ASYNC_IO_QUEUE_DEPTH);
+    }
+    if (io_engine_ == nullptr) {
+      io_engine_ = std::make_unique<ThreadPoolIOEngine>(this, ASYNC_IO_WORKERS);
+    }
+  });
+  return io_engine_.get();
+}
+
+/**
+ * Start an asynchronous read of a page
+ */
+auto DiskManager::ReadPageAsync(page_id_t page_id, char *page_data) -> std::future<bool> {
+  if (page_id < 0 || (direct_io_ && !IsAligned(page_data))) {
+    // Rare enough not to be worth a bounce buffer per request. Invalid ids fail there, like synchronous requests.
+    std::promise<bool> done;
+    uint64_t errors = GetThreadIOErrors();
+    ReadPage(page_id, page_data);
+    done.set_value(GetThreadIOErrors() == errors);
+    return done.get_future();
+  }
+  IOEngine *engine = GetIOEngine();
+  auto read = engine->Submit(false, page_id, page_data);
+  // The thread pool goes through ReadPage(), which verifies the page itself; otherwise verify it once it is waited for.
+  if (!checksums_ || dynamic_cast<ThreadPoolIOEngine *>(engine) != nullptr) {
+    return read;
+  }
+  return std::async(std::launch::deferred, [this, page_id, page_data, read = std::move(read)]() mutable {
+    bool ok = read.get();
+    if (ok) {
+      CheckPage(page_id, page_data);
+    }
+    return ok;
+  });
+}
+
+/**
+ * Start an asynchronous write of a page
+ */
+auto DiskManager::WritePageAsync(page_id_t page_id, const char *page_data) -> std::future<bool> {
+  if (page_id < 0 || (direct_io_ && !IsAligned(page_data))) {
+    std::promise<bool> done;
+    uint64_t errors = GetThreadIOErrors();
+    WritePage(page_id, page_data);
+    done.set_value(GetThreadIOErrors() == errors);
+    return done.get_future();
+  }
+  IOEngine *engine = GetIOEngine();
+  // The thread pool goes through WritePage(), which counts and stamps the write itself.
+  if (dynamic_cast<ThreadPoolIOEngine *>(engine) == nullptr) {
+    num_writes_ += 1;
+    if (checksums_) {
+      // Stamp a copy that the request owns, the caller's buffer may be a frame that others read meanwhile.
+      AlignedPage copy = AllocateAlignedPage();
+      memcpy(copy.get(), page_data, BUSTUB_PAGE_SIZE);
+      StampChecksum(page_id, copy.get());
+      return engine->SubmitWrite(page_id, std::move(copy));
+    }
+  }
+  // The engine does not write to the buffer of a write request.
+  return engine->Submit(true, page_id, const_cast<char *>(page_data));
+}
+
 /**
  * Write the contents of the log into disk file
  * Only return when sync is done, and only perform sequence write
@@ -161,7 +660,7 @@ void DiskManager::WriteLog(char *log_data, int size) {
  * Always read from the beginning and perform sequence read
  * @return: false means already reach the end
  */
-auto DiskManager::ReadLog(char *log_data, int size, int offset) -> bool {
+auto DiskManager::ReadLog(char *log_data, int size, int64_t offset) -> bool {
   if (offset >= GetFileSize(log_name_)) {
     // LOG_DEBUG("end of log file");
     // LOG_DEBUG("file size is %d", GetFileSize(log_name_));
@@ -202,10 +701,49 @@ auto DiskManager::GetFlushState() const -> bool { return flush_log_; }
 /**
  * Private helper function to get disk file size
  */
-auto DiskManager::GetFileSize(const std::string &file_name) -> int {
+auto DiskManager::GetFileSize(const std::string &file_name) -> int64_t {
   struct stat stat_buf;
   int rc = stat(file_name.c_str(), &stat_buf);
-  return rc == 0 ? static_cast<int>(stat_buf.st_size) : -1;
+  return rc == 0 ? static_cast<int64_t>(stat_buf.st_size) : -1;
+}
+
+auto DiskManager::ReplaceFileDurably(const std::string &path, const std::string &contents) -> bool {
+  std::string tmp_path = path + ".tmp";
+  int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    LOG_WARN("cannot create %s", tmp_path.c_str());
+    return false;
+  }
+  bool ok = true;
+  for (size_t done = 0; ok && done < contents.size();) {
+    ssize_t rc = write(fd, contents.data() + done, contents.size() - done);
+    if (rc > 0) {
+      done += rc;
+    } else if (rc < 0 && errno != EINTR) {
+      ok = false;
+    }
+  }
+  ok = ok && fsync(fd) == 0;
+  ok = close(fd) == 0 && ok;
+  if (!ok || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    LOG_WARN("cannot write %s", path.c_str());
+    std::remove(tmp_path.c_str());
+    return false;
+  }
+  // Until the directory is synced, a crash may still bring back the old file.
+  size_t slash = path.rfind('/');
+  std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+  int dir_fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+  if (dir_fd < 0) {
+    LOG_WARN("cannot open directory %s", dir.c_str());
+    return false;
+  }
+  ok = fsync(dir_fd) == 0;
+  close(dir_fd);
+  if (!ok) {
+    LOG_WARN("cannot sync directory %s", dir.c_str());
+  }
+  return ok;
 }
 
 }  // namespace bustub
@@ -0,0 +1,367 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_compressed.cpp
+//
+// Identification: src/storage/disk/disk_manager_compressed.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_compressed.h"
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/util/lz_compressor.h"
+
+namespace bustub {
+
+namespace {
+/**
+ * Read or write all of iov at offset of a file, resuming after short transfers.
+ * @return the number of bytes transferred, less than all of iov only if the file ends; -1 on an I/O error
+ */
+auto TransferExtents(int fd, bool write, std::vector<iovec> iov, off_t offset) -> ssize_t {
+  size_t done = 0;
+  size_t first = 0;
+  while (first < iov.size()) {
+    auto count = static_cast<int>(std::min<size_t>(iov.size() - first, IOV_MAX));
+    ssize_t transferred = write ? pwritev(fd, &iov[first], count, offset + done)
+                                : preadv(fd, &iov[first], count, offset + done);
+    if (transferred < 0 && errno == EINTR) {
+      continue;
+    }
+    if (transferred < 0) {
+      return -1;
+    }
+    if (transferred == 0) {
+      break;
+    }
+    done += transferred;
+    // Skip the buffers that are done and the part of the next one that is.
+    for (auto left = static_cast<size_t>(transferred); left > 0 && first < iov.size();) {
+      size_t step = std::min(left, iov[first].iov_len);
+      iov[first].iov_base = static_cast<char *>(iov[first].iov_base) + step;
+      iov[first].iov_len -= step;
+      left -= step;
+      if (iov[first].iov_len == 0) {
+        first++;
+      }
+    }
+  }
+  return static_cast<ssize_t>(done);
+}
+
+constexpr size_t MAX_EXTENT_BYTES = DiskManagerCompressed::MAX_EXTENT_SLOTS * DiskManagerCompressed::SLOT_SIZE;
+}  // namespace
+
+DiskManagerCompressed::DiskManagerCompressed(const std::string &db_file) : DiskManager(db_file) {
+  free_extents_.resize(MAX_EXTENT_SLOTS + 1);
+  LoadExtents();
+  // The io_uring engine would transfer plain pages at their offsets in an uncompressed file.
+  SetIOEngine(std::make_unique<ThreadPoolIOEngine>(this, ASYNC_IO_WORKERS));
+}
+
+DiskManagerCompressed::~DiskManagerCompressed() {
+  // The workers call back into this object.
+  io_engine_.reset();
+}
+
+void DiskManagerCompressed::Sync() {
+  if (file_name_.empty()) {
+    DiskManager::Sync();
+    return;
+  }
+  // The pages freed since the last free page map give up their extents first, so that this map goes without them.
+  SaveFreePages();
+  // The map is taken before the pages are synced, so that it only points to extents written before the sync. Writes
+  // that are under way have their extents in the map already but not their data, they are waited for.
+  std::unordered_map<page_id_t, Extent> extents;
+  std::vector<Extent> moved;
+  std::vector<Extent> deallocated;
+  bool dirty;
+  {
+    std::unique_lock<std::shared_mutex> writes_lock(writes_latch_);
+    std::scoped_lock<std::mutex> lock(extents_latch_);
+    dirty = extents_dirty_;
+    if (dirty) {
+      extents = extents_;
+      moved.swap(moved_extents_);
+      deallocated.swap(deallocated_extents_);
+      extents_dirty_ = false;
+    }
+  }
+  SyncSegments();
+  if (!dirty) {
+    return;
+  }
+  bool saved = SaveExtents(extents);
+  std::scoped_lock<std::mutex> lock(extents_latch_);
+  if (!saved) {
+    // The extents stay reserved until a map without them is saved.
+    moved_extents_.insert(moved_extents_.end(), moved.begin(), moved.end());
+    deallocated_extents_.insert(deallocated_extents_.end(), deallocated.begin(), deallocated.end());
+    extents_dirty_ = true;
+    return;
+  }
+  // Extents that were left after the map was taken stay reserved, the saved map may still point to them.
+  for (auto extent : moved) {
+    AddFreeExtent(extent);
+  }
+  int fd = SegmentFd(0, false);
+  for (auto extent : deallocated) {
+    AddFreeExtent(extent);
+    if (fd >= 0 && fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, static_cast<off_t>(extent.offset_),
+                             static_cast<off_t>(extent.slots_ * SLOT_SIZE)) != 0) {
+      LOG_DEBUG("cannot release the space of a free page");
+    }
+  }
+}
+
+void DiskManagerCompressed::WritePages(page_id_t first_page_id, const char *const *pages, size_t num_pages) {
+  num_writes_ += 1;
+  if (first_page_id < 0) {
+    ReportIOError("I/O error while writing");
+    return;
+  }
+  // From taking the extents until the data is in them, so that Sync() does not take a map that points to them early.
+  std::shared_lock<std::shared_mutex> writes_lock(writes_latch_);
+  thread_local std::vector<char> buffer;
+  thread_local std::vector<char> stamped(BUSTUB_PAGE_SIZE);
+  buffer.resize(std::max(buffer.size(), num_pages * MAX_EXTENT_BYTES));
+  std::vector<uint32_t> slots(num_pages);
+  for (size_t i = 0; i < num_pages; i++) {
+    auto page_id = first_page_id + static_cast<page_id_t>(i);
+    const char *page = pages[i];
+    if (checksums_) {
+      // Stamp a copy, the caller's buffer may be a frame that others read meanwhile.
+      memcpy(stamped.data(), page, BUSTUB_PAGE_SIZE);
+      StampChecksum(page_id, stamped.data());
+      page = stamped.data();
+    }
+    char *extent = buffer.data() + i * MAX_EXTENT_BYTES;
+    ExtentHeader header{page_id, 0};
+    // A page is only stored compressed if that saves at least a slot.
+    header.size_ = LZCompressor::Compress(page, BUSTUB_PAGE_SIZE, extent + sizeof(header),
+                                          MAX_EXTENT_BYTES - SLOT_SIZE - sizeof(header));
+    if (header.size_ == 0) {
+      memcpy(extent + sizeof(header), page, BUSTUB_PAGE_SIZE);
+      header.size_ = BUSTUB_PAGE_SIZE;
+    }
+    memcpy(extent, &header, sizeof(header));
+    size_t used = sizeof(header) + header.size_;
+    slots[i] = (used + SLOT_SIZE - 1) / SLOT_SIZE;
+    memset(extent + used, 0, slots[i] * SLOT_SIZE - used);
+  }
+
+  std::vector<Extent> placed(num_pages);
+  {
+    std::scoped_lock<std::mutex> lock(extents_latch_);
+    for (size_t i = 0; i < num_pages; i++) {
+      auto page_id = first_page_id + static_cast<page_id_t>(i);
+      auto it = extents_.find(page_id);
+      if (it != extents_.end() && it->second.slots_ >= slots[i]) {
+        placed[i] = it->second;
+        continue;
+      }
+      if (it != extents_.end()) {
+        moved_extents_.push_back(it->second);
+        stored_bytes_ -= it->second.slots_ * SLOT_SIZE;
+      }
+      placed[i] = AllocateExtent(slots[i]);
+      extents_[page_id] = placed[i];
+      stored_bytes_ += slots[i] * SLOT_SIZE;
+      extents_dirty_ = true;
+    }
+  }
+
+  int fd = SegmentFd(0, true);
+  std::vector<iovec> iov;
+  for (size_t i = 0; i < num_pages;) {
+    iov.clear();
+    uint64_t end = placed[i].offset_;
+    size_t j = i;
+    for (; j < num_pages && placed[j].offset_ == end; j++) {
+      iov.push_back({buffer.data() + j * MAX_EXTENT_BYTES, slots[j] * SLOT_SIZE});
+      end += slots[j] * SLOT_SIZE;
+    }
+    if (fd < 0 || TransferExtents(fd, true, iov, static_cast<off_t>(placed[i].offset_)) < 0) {
+      ReportIOError("I/O error while writing");
+      return;
+    }
+    i = j;
+  }
+}
+
+void DiskManagerCompressed::ReadPages(page_id_t first_page_id, char *const *pages, size_t num_pages) {
+  std::vector<Extent> found(num_pages, Extent{0, 0});
+  {
+    std::scoped_lock<std::mutex> lock(extents_latch_);
+    for (size_t i = 0; i < num_pages; i++) {
+      auto it = extents_.find(first_page_id + static_cast<page_id_t>(i));
+      if (it != extents_.end()) {
+        found[i] = it->second;
+      }
+    }
+  }
+
+  thread_local std::vector<char> buffer;
+  int fd = SegmentFd(0, false);
+  for (size_t i = 0; i < num_pages;) {
+    // A page that was never written reads as zeros.
+    if (found[i].slots_ == 0) {
+      memset(pages[i], 0, BUSTUB_PAGE_SIZE);
+      i++;
+      continue;
+    }
+    uint64_t end = found[i].offset_;
+    size_t j = i;
+    for (; j < num_pages && found[j].slots_ != 0 && found[j].offset_ == end; j++) {
+      end += found[j].slots_ * SLOT_SIZE;
+    }
+    size_t bytes = end - found[i].offset_;
+    buffer.resize(std::max(buffer.size(), bytes));
+    ssize_t transferred =
+        fd < 0 ? -1 : TransferExtents(fd, false, {{buffer.data(), bytes}}, static_cast<off_t>(found[i].offset_));
+    if (transferred < 0) {
+      ReportIOError("I/O error while reading");
+      return;
+    }
+    memset(buffer.data() + transferred, 0, bytes - transferred);
+    for (size_t k = i; k < j; k++) {
+      DecodeExtent(first_page_id + static_cast<page_id_t>(k), buffer.data() + (found[k].offset_ - found[i].offset_),
+                   found[k].slots_ * SLOT_SIZE, pages[k]);
+    }
+    i = j;
+  }
+}
+
+void DiskManagerCompressed::DecodeExtent(page_id_t page_id, const char *extent, size_t extent_size,
+                                         char *page_data) {
+  ExtentHeader header;
+  memcpy(&header, extent, sizeof(header));
+  const char *data = extent + sizeof(header);
+  bool decoded = header.page_id_ == page_id && header.size_ <= extent_size - sizeof(header);
+  if (decoded && header.size_ == BUSTUB_PAGE_SIZE) {
+    memcpy(page_data, data, BUSTUB_PAGE_SIZE);
+  } else if (decoded) {
+    decoded = LZCompressor::Decompress(data, header.size_, page_data, BUSTUB_PAGE_SIZE) == BUSTUB_PAGE_SIZE;
+  }
+  if (!decoded) {
+    ReportCorruptPage(page_id);
+  } else if (checksums_) {
+    CheckPage(page_id, page_data);
+  }
+}
+
+auto DiskManagerCompressed::GetNumStoredPages() -> size_t {
+  std::scoped_lock<std::mutex> lock(extents_latch_);
+  return extents_.size();
+}
+
+auto DiskManagerCompressed::GetStoredBytes() -> uint64_t {
+  std::scoped_lock<std::mutex> lock(extents_latch_);
+  return stored_bytes_;
+}
+
+void DiskManagerCompressed::ReleaseSpace(page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(extents_latch_);
+  auto it = extents_.find(page_id);
+  if (it == extents_.end()) {
+    return;
+  }
+  deallocated_extents_.push_back(it->second);
+  stored_bytes_ -= it->second.slots_ * SLOT_SIZE;
+  extents_.erase(it);
+  extents_dirty_ = true;
+}
+
+auto DiskManagerCompressed::AllocateExtent(uint32_t slots) -> Extent {
+  for (size_t n = slots; n <= MAX_EXTENT_SLOTS; n++) {
+    if (free_extents_[n].empty()) {
+      continue;
+    }
+    uint64_t offset = free_extents_[n].back();
+    free_extents_[n].pop_back();
+    if (n > slots) {
+      free_extents_[n - slots].push_back(offset + slots * SLOT_SIZE);
+    }
+    return {offset, slots};
+  }
+  Extent extent{end_offset_, slots};
+  end_offset_ += slots * SLOT_SIZE;
+  return extent;
+}
+
+void DiskManagerCompressed::AddFreeExtent(Extent extent) {
+  while (extent.slots_ > 0) {
+    auto slots = static_cast<uint32_t>(std::min<size_t>(extent.slots_, MAX_EXTENT_SLOTS));
+    free_extents_[slots].push_back(extent.offset_);
+    extent.offset_ += slots * SLOT_SIZE;
+    extent.slots_ -= slots;
+  }
+}
+
+void DiskManagerCompressed::LoadExtents() {
+  if (file_name_.empty()) {
+    return;
+  }
+  std::string path = file_name_ + ".extents";
+  if (GetFileSize(file_name_) <= 0) {
+    // A new database gets its map right away, which marks the file as compressed.
+    SaveExtents(extents_);
+    return;
+  }
+  std::ifstream in(path);
+  std::string magic;
+  int version;
+  if (!(in >> magic >> version) || magic != "bustub-extents" || version != 1) {
+    throw Exception("not a compressed database file: " + file_name_);
+  }
+  std::vector<Extent> by_offset;
+  page_id_t page_id;
+  Extent extent;
+  // One "page_id offset slots" line per page.
+  while (in >> page_id >> extent.offset_ >> extent.slots_) {
+    extents_[page_id] = extent;
+    stored_bytes_ += extent.slots_ * SLOT_SIZE;
+    by_offset.push_back(extent);
+  }
+  // Everything between the extents is free. Whatever lies past the last one was written after the map was saved.
+  std::sort(by_offset.begin(), by_offset.end(), [](const Extent &a, const Extent &b) { return a.offset_ < b.offset_; });
+  for (auto &used : by_offset) {
+    if (used.offset_ > end_offset_) {
+      AddFreeExtent({end_offset_, static_cast<uint32_t>((used.offset_ - end_offset_) / SLOT_SIZE)});
+    }
+    end_offset_ = std::max(end_offset_, used.offset_ + used.slots_ * SLOT_SIZE);
+  }
+}
+
+auto DiskManagerCompressed::SaveExtents(const std::unordered_map<page_id_t, Extent> &extents) -> bool {
+  std::ostringstream out;
+  out << "bustub-extents 1\n";
+  for (const auto &[page_id, extent] : extents) {
+    out << page_id << ' ' << extent.offset_ << ' ' << extent.slots_ << '\n';
+  }
+  return ReplaceFileDurably(file_name_ + ".extents", out.str());
+}
+
+}  // namespace bustub
@@ -27,7 +27,7 @@ namespace bustub {
 /**
  * Constructor: used for memory based manager
  */
-DiskManagerMemory::DiskManagerMemory(size_t pages) { memory_ = new char[pages * BUSTUB_PAGE_SIZE]; }
+DiskManagerMemory::DiskManagerMemory(size_t pages) { memory_ = new char[pages * BUSTUB_PAGE_SIZE](); }
 
 /**
  * Write the contents of the specified page into disk file
@@ -37,6 +37,23 @@ void DiskManagerMemory::WritePage(page_id_t page_id, const char *page_data) {
   // set write cursor to offset
   num_writes_ += 1;
   memcpy(memory_ + offset, page_data, BUSTUB_PAGE_SIZE);
+  if (checksums_) {
+    StampChecksum(page_id, memory_ + offset);
+  }
+}
+
+/**
+ * Write a run of consecutive pages into memory
+ */
+void DiskManagerMemory::WritePages(page_id_t first_page_id, const char *const *pages, size_t num_pages) {
+  size_t offset = static_cast<size_t>(first_page_id) * BUSTUB_PAGE_SIZE;
+  num_writes_ += 1;
+  for (size_t i = 0; i < num_pages; i++) {
+    memcpy(memory_ + offset + i * BUSTUB_PAGE_SIZE, pages[i], BUSTUB_PAGE_SIZE);
+    if (checksums_) {
+      StampChecksum(first_page_id + static_cast<page_id_t>(i), memory_ + offset + i * BUSTUB_PAGE_SIZE);
+    }
+  }
 }
 
 /**
@@ -45,6 +62,22 @@ void DiskManagerMemory::WritePage(page_id_t page_id, const char *page_data) {
 void DiskManagerMemory::ReadPage(page_id_t page_id, char *page_data) {
   int64_t offset = static_cast<int64_t>(page_id) * BUSTUB_PAGE_SIZE;
   memcpy(page_data, memory_ + offset, BUSTUB_PAGE_SIZE);
+  if (checksums_) {
+    CheckPage(page_id, page_data);
+  }
+}
+
+/**
+ * Read a run of consecutive pages from memory
+ */
+void DiskManagerMemory::ReadPages(page_id_t first_page_id, char *const *pages, size_t num_pages) {
+  int64_t offset = static_cast<int64_t>(first_page_id) * BUSTUB_PAGE_SIZE;
+  for (size_t i = 0; i < num_pages; i++) {
+    memcpy(pages[i], memory_ + offset + i * BUSTUB_PAGE_SIZE, BUSTUB_PAGE_SIZE);
+    if (checksums_) {
+      CheckPage(first_page_id + static_cast<page_id_t>(i), pages[i]);
+    }
+  }
 }
 
 }  // namespace bustub
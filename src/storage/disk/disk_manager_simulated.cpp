@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_simulated.cpp
+//
+// Identification: src/storage/disk/disk_manager_simulated.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_simulated.h"
+
+#include <algorithm>
+#include <thread>  // NOLINT
+
+namespace bustub {
+
+namespace {
+auto SplitMix64(uint64_t x) -> uint64_t {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/** @return the histogram bucket of a latency, see SimulatedDiskStats */
+auto Bucket(std::chrono::steady_clock::duration latency) -> size_t {
+  auto us = static_cast<uint64_t>(std::max<int64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(latency).count(), 0));
+  size_t bucket = 0;
+  while (us != 0 && bucket < SimulatedDiskStats::HISTOGRAM_BUCKETS - 1) {
+    us >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+}  // namespace
+
+auto SimulatedDiskStats::Percentile(const std::array<uint64_t, HISTOGRAM_BUCKETS> &histogram, double percentile)
+    -> uint64_t {
+  uint64_t total = 0;
+  for (auto count : histogram) {
+    total += count;
+  }
+  if (total == 0) {
+    return 0;
+  }
+  uint64_t seen = 0;
+  for (size_t bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++) {
+    seen += histogram[bucket];
+    if (seen >= total * percentile / 100) {
+      return uint64_t{1} << bucket;
+    }
+  }
+  return uint64_t{1} << (HISTOGRAM_BUCKETS - 1);
+}
+
+DiskManagerSimulated::DiskManagerSimulated(const SimulatedDiskConfig &config)
+    : config_(config),
+      page_transfer_time_(config.bandwidth_mb_s_ <= 0
+                              ? Clock::duration::zero()
+                              : std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(
+                                    BUSTUB_PAGE_SIZE / (config.bandwidth_mb_s_ * 1024 * 1024)))),
+      slot_free_at_(std::max<size_t>(config.queue_depth_, 1), Clock::time_point::min()),
+      bus_free_at_(Clock::time_point::min()) {}
+
+void DiskManagerSimulated::WritePage(page_id_t page_id, const char *page_data) {
+  Simulate(true, page_id, 1);
+  DiskManagerUnlimitedMemory::WritePage(page_id, page_data);
+}
+
+void DiskManagerSimulated::WritePages(page_id_t first_page_id, const char *const *pages, size_t num_pages) {
+  Simulate(true, first_page_id, num_pages);
+  // The runs of the base class go through the virtual WritePage(), which would simulate every page again.
+  for (size_t i = 0; i < num_pages; i++) {
+    DiskManagerUnlimitedMemory::WritePage(first_page_id + static_cast<page_id_t>(i), pages[i]);
+  }
+}
+
+void DiskManagerSimulated::ReadPage(page_id_t page_id, char *page_data) {
+  Simulate(false, page_id, 1);
+  DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+}
+
+void DiskManagerSimulated::ReadPages(page_id_t first_page_id, char *const *pages, size_t num_pages) {
+  Simulate(false, first_page_id, num_pages);
+  for (size_t i = 0; i < num_pages; i++) {
+    DiskManagerUnlimitedMemory::ReadPage(first_page_id + static_cast<page_id_t>(i), pages[i]);
+  }
+}
+
+auto DiskManagerSimulated::GetStats() -> SimulatedDiskStats {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return stats_;
+}
+
+void DiskManagerSimulated::ResetStats() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  stats_ = SimulatedDiskStats();
+}
+
+auto DiskManagerSimulated::Jitter(uint64_t n) const -> double {
+  // 53 random bits make a uniform double in [0, 1).
+  double uniform = static_cast<double>(SplitMix64(config_.seed_ + n) >> 11) / static_cast<double>(uint64_t{1} << 53);
+  return 1 + config_.jitter_ * (2 * uniform - 1);
+}
+
+void DiskManagerSimulated::Simulate(bool is_write, page_id_t first_page_id, size_t num_pages) {
+  Clock::time_point done;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    auto now = Clock::now();
+    auto slot = std::min_element(slot_free_at_.begin(), slot_free_at_.end());
+    bool queued = *slot > now;
+    bool sequential = first_page_id == next_sequential_page_;
+    auto latency = sequential ? config_.sequential_latency_ : config_.random_latency_;
+    auto transfer_ready =
+        std::max(now, *slot) +
+        std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::micro>(latency.count()) *
+                                                    Jitter(num_requests_++));
+    // The bus serves transfers in the order the requests were scheduled.
+    done = std::max(transfer_ready, bus_free_at_) + page_transfer_time_ * static_cast<int64_t>(num_pages);
+    *slot = done;
+    bus_free_at_ = done;
+    next_sequential_page_ = first_page_id + static_cast<page_id_t>(num_pages);
+
+    stats_.sequential_requests_ += sequential ? 1 : 0;
+    stats_.queued_requests_ += queued ? 1 : 0;
+    if (is_write) {
+      stats_.writes_++;
+      stats_.pages_written_ += num_pages;
+      stats_.write_latency_[Bucket(done - now)]++;
+    } else {
+      stats_.reads_++;
+      stats_.pages_read_ += num_pages;
+      stats_.read_latency_[Bucket(done - now)]++;
+    }
+  }
+  // The wait overshoots by the timer slack of the thread, some 50 us. Spinning would be exact, but takes the CPU from
+  // the threads the benchmark measures.
+  std::this_thread::sleep_until(done);
+}
+
+}  // namespace bustub
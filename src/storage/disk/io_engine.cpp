@@ -0,0 +1,356 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// io_engine.cpp
+//
+// Identification: src/storage/disk/io_engine.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/io_engine.h"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <exception>
+#include <utility>
+#include <vector>
+
+#include "common/logger.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+namespace {
+/** How often a busy or failing ring is retried, and how long to wait in between, before it counts as failed. */
+constexpr int RING_RETRIES = 100;
+constexpr auto RING_RETRY_DELAY = std::chrono::microseconds(100);
+
+auto IOUringSetup(uint32_t entries, io_uring_params *params) -> int {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+auto IOUringEnter(int ring_fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags) -> int {
+  int ret;
+  do {
+    ret = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+  } while (ret < 0 && errno == EINTR);
+  return ret;
+}
+
+auto MapRing(int ring_fd, size_t size, off_t offset) -> void * {
+  void *ring = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, offset);
+  return ring == MAP_FAILED ? nullptr : ring;
+}
+
+template <typename T>
+auto RingField(void *ring, uint32_t offset) -> T * {
+  return reinterpret_cast<T *>(static_cast<char *>(ring) + offset);
+}
+}  // namespace
+
+auto UringIOEngine::Create(PageLocator locate, size_t queue_depth) -> std::unique_ptr<UringIOEngine> {
+  io_uring_params params{};
+  int ring_fd = IOUringSetup(static_cast<uint32_t>(queue_depth), &params);
+  if (ring_fd < 0) {
+    return nullptr;
+  }
+  std::unique_ptr<UringIOEngine> engine(new UringIOEngine());
+  engine->locate_ = std::move(locate);
+  engine->ring_fd_ = ring_fd;
+  // The completion queue is twice as large, so it cannot overflow.
+  engine->queue_depth_ = params.sq_entries;
+  engine->sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  engine->cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    engine->sq_ring_size_ = engine->cq_ring_size_ = std::max(engine->sq_ring_size_, engine->cq_ring_size_);
+  }
+  engine->sq_ring_ = MapRing(ring_fd, engine->sq_ring_size_, IORING_OFF_SQ_RING);
+  if (engine->sq_ring_ == nullptr) {
+    return nullptr;
+  }
+  engine->cq_ring_ = single_mmap ? engine->sq_ring_ : MapRing(ring_fd, engine->cq_ring_size_, IORING_OFF_CQ_RING);
+  if (engine->cq_ring_ == nullptr) {
+    return nullptr;
+  }
+  engine->sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  engine->sqes_ = MapRing(ring_fd, engine->sqes_size_, IORING_OFF_SQES);
+  if (engine->sqes_ == nullptr) {
+    return nullptr;
+  }
+
+  engine->sq_head_ = RingField<uint32_t>(engine->sq_ring_, params.sq_off.head);
+  engine->sq_tail_ = RingField<uint32_t>(engine->sq_ring_, params.sq_off.tail);
+  engine->sq_mask_ = *RingField<uint32_t>(engine->sq_ring_, params.sq_off.ring_mask);
+  engine->sq_array_ = RingField<uint32_t>(engine->sq_ring_, params.sq_off.array);
+  engine->cq_head_ = RingField<uint32_t>(engine->cq_ring_, params.cq_off.head);
+  engine->cq_tail_ = RingField<uint32_t>(engine->cq_ring_, params.cq_off.tail);
+  engine->cq_mask_ = *RingField<uint32_t>(engine->cq_ring_, params.cq_off.ring_mask);
+  engine->cqes_ = RingField<io_uring_cqe>(engine->cq_ring_, params.cq_off.cqes);
+  engine->reaper_ = std::thread(&UringIOEngine::ReapLoop, engine.get());
+  return engine;
+}
+
+UringIOEngine::~UringIOEngine() {
+  if (reaper_.joinable()) {
+    {
+      std::unique_lock<std::mutex> lock(latch_);
+      space_cv_.wait(lock, [&] { return in_flight_.empty(); });
+      stopping_ = true;
+      reaper_cv_.notify_one();
+    }
+    reaper_.join();
+  }
+  if (sqes_ != nullptr) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_ != nullptr) {
+    munmap(sq_ring_, sq_ring_size_);
+  }
+  close(ring_fd_);
+}
+
+auto UringIOEngine::Submit(bool is_write, page_id_t page_id, char *data) -> std::future<bool> {
+  off_t offset;
+  int fd = locate_(page_id, is_write, &offset);
+  if (fd < 0) {
+    // Nothing was ever written to the file of the page, or it cannot be created.
+    std::promise<bool> done;
+    if (!is_write) {
+      memset(data, 0, BUSTUB_PAGE_SIZE);
+    }
+    done.set_value(!is_write);
+    return done.get_future();
+  }
+  return SubmitRequest(new IORequest{is_write, page_id, data, fd, offset, {}, nullptr});
+}
+
+auto UringIOEngine::SubmitWrite(page_id_t page_id, AlignedPage page) -> std::future<bool> {
+  off_t offset;
+  int fd = locate_(page_id, true, &offset);
+  if (fd < 0) {
+    std::promise<bool> done;
+    done.set_value(false);
+    return done.get_future();
+  }
+  char *data = page.get();
+  return SubmitRequest(new IORequest{true, page_id, data, fd, offset, {}, std::move(page)});
+}
+
+auto UringIOEngine::SubmitRequest(IORequest *request) -> std::future<bool> {
+  auto future = request->done_.get_future();
+  std::unique_lock<std::mutex> lock(latch_);
+  space_cv_.wait(lock, [&] { return in_flight_.size() < queue_depth_; });
+  if (!broken_) {
+    // In the set before the kernel has it, so that the reaper finds it there however fast it completes.
+    in_flight_.insert(request);
+    if (SubmitLocked(request)) {
+      reaper_cv_.notify_one();
+      return future;
+    }
+    in_flight_.erase(request);
+  }
+  lock.unlock();
+  CompleteSynchronously(request, 0);
+  delete request;
+  return future;
+}
+
+auto UringIOEngine::SubmitLocked(IORequest *request) -> bool {
+  uint32_t tail = *sq_tail_;
+  uint32_t index = tail & sq_mask_;
+  auto *sqe = static_cast<io_uring_sqe *>(sqes_) + index;
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = request->is_write_ ? IORING_OP_WRITE : IORING_OP_READ;
+  sqe->fd = request->fd_;
+  sqe->addr = reinterpret_cast<uint64_t>(request->data_);
+  sqe->len = BUSTUB_PAGE_SIZE;
+  sqe->off = static_cast<uint64_t>(request->offset_);
+  sqe->user_data = reinterpret_cast<uint64_t>(request);
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  // Every call leaves the queue empty, so this entry is the only one to submit.
+  for (int retries = 0;; retries++) {
+    int ret = IOUringEnter(ring_fd_, 1, 0, 0);
+    if (ret == 1) {
+      return true;
+    }
+    // The ring is short of room for completions or the kernel of memory; the reaper makes room meanwhile.
+    bool busy = ret == 0 || errno == EAGAIN || errno == EBUSY;
+    if (!busy || retries == RING_RETRIES) {
+      break;
+    }
+    std::this_thread::sleep_for(RING_RETRY_DELAY);
+  }
+  LOG_DEBUG("io_uring_enter failed while submitting");
+  __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+  return false;
+}
+
+void UringIOEngine::ReapLoop() {
+  std::vector<std::pair<IORequest *, int32_t>> reaped;
+  int failures = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(latch_);
+      reaper_cv_.wait(lock, [&] { return !in_flight_.empty() || stopping_; });
+      if (in_flight_.empty()) {
+        return;
+      }
+    }
+    bool failed = IOUringEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS) < 0;
+    bool busy = failed && (errno == EAGAIN || errno == EBUSY);
+    uint32_t head = *cq_head_;
+    uint32_t tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    for (; head != tail; head++) {
+      const auto &cqe = static_cast<io_uring_cqe *>(cqes_)[head & cq_mask_];
+      reaped.emplace_back(reinterpret_cast<IORequest *>(cqe.user_data), cqe.res);
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    if (reaped.empty()) {
+      if (failed) {
+        LOG_DEBUG("io_uring_enter failed while waiting");
+        if (!busy && ++failures == RING_RETRIES) {
+          AbandonRing();
+          return;
+        }
+        std::this_thread::sleep_for(RING_RETRY_DELAY);
+      }
+      continue;
+    }
+    failures = 0;
+    {
+      std::scoped_lock<std::mutex> lock(latch_);
+      for (const auto &[request, result] : reaped) {
+        in_flight_.erase(request);
+      }
+      space_cv_.notify_all();
+    }
+    for (const auto &[request, result] : reaped) {
+      if (result == BUSTUB_PAGE_SIZE) {
+        request->done_.set_value(true);
+      } else {
+        CompleteSynchronously(request, result);
+      }
+      delete request;
+    }
+    reaped.clear();
+  }
+}
+
+void UringIOEngine::AbandonRing() {
+  LOG_WARN("io_uring keeps failing, falling back to synchronous I/O");
+  std::unordered_set<IORequest *> requests;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    broken_ = true;
+    requests.swap(in_flight_);
+    space_cv_.notify_all();
+  }
+  // Redone from the start: whatever the ring did of them, a full transfer gives the same result.
+  for (auto *request : requests) {
+    CompleteSynchronously(request, 0);
+    delete request;
+  }
+}
+
+void UringIOEngine::CompleteSynchronously(IORequest *request, int32_t transferred) {
+  // A negative result is an error code, which the retry reports if it persists.
+  size_t done = transferred > 0 ? transferred : 0;
+  int fd = request->fd_;
+  off_t offset = request->offset_;
+  while (done < BUSTUB_PAGE_SIZE) {
+    ssize_t n = request->is_write_ ? pwrite(fd, request->data_ + done, BUSTUB_PAGE_SIZE - done, offset + done)
+                                   : pread(fd, request->data_ + done, BUSTUB_PAGE_SIZE - done, offset + done);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0 || (n == 0 && request->is_write_)) {
+      LOG_DEBUG("I/O error in asynchronous request");
+      request->done_.set_value(false);
+      return;
+    }
+    if (n == 0) {
+      // Past the end of the file, like DiskManager::ReadPage().
+      memset(request->data_ + done, 0, BUSTUB_PAGE_SIZE - done);
+      break;
+    }
+    done += n;
+  }
+  request->done_.set_value(true);
+}
+
+ThreadPoolIOEngine::ThreadPoolIOEngine(DiskManager *disk_manager, size_t num_workers) : disk_manager_(disk_manager) {
+  for (size_t i = 0; i < num_workers; i++) {
+    workers_.emplace_back(&ThreadPoolIOEngine::WorkerLoop, this);
+  }
+}
+
+ThreadPoolIOEngine::~ThreadPoolIOEngine() {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    running_ = false;
+    cv_.notify_all();
+  }
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+auto ThreadPoolIOEngine::Submit(bool is_write, page_id_t page_id, char *data) -> std::future<bool> {
+  return SubmitRequest({is_write, page_id, data, -1, 0, {}, nullptr});
+}
+
+auto ThreadPoolIOEngine::SubmitWrite(page_id_t page_id, AlignedPage page) -> std::future<bool> {
+  char *data = page.get();
+  return SubmitRequest({true, page_id, data, -1, 0, {}, std::move(page)});
+}
+
+auto ThreadPoolIOEngine::SubmitRequest(IORequest request) -> std::future<bool> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  queue_.push_back(std::move(request));
+  cv_.notify_one();
+  return queue_.back().done_.get_future();
+}
+
+void ThreadPoolIOEngine::WorkerLoop() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    cv_.wait(lock, [&] { return !running_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;
+    }
+    IORequest request = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+    bool ok;
+    uint64_t errors = DiskManager::GetThreadIOErrors();
+    try {
+      if (request.is_write_) {
+        disk_manager_->WritePage(request.page_id_, request.data_);
+      } else {
+        disk_manager_->ReadPage(request.page_id_, request.data_);
+      }
+      ok = DiskManager::GetThreadIOErrors() == errors;
+    } catch (const std::exception &e) {
+      LOG_DEBUG("asynchronous request failed: %s", e.what());
+      ok = false;
+    }
+    request.done_.set_value(ok);
+    lock.lock();
+  }
+}
+
+}  // namespace bustub
@@ -1,4 +1,5 @@
 #include "storage/index/b_plus_tree.h"
+#include <algorithm>
 #include <cstddef>
 #include <type_traits>
 #include "common/exception.h"
@@ -89,6 +90,13 @@ auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return root_page_id_ == INVALID_P
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) -> bool {
+  for (int attempt = 0; attempt < OPTIMISTIC_READ_RETRIES; attempt++) {
+    bool found;
+    if (GetValueOptimistic(key, result, &found)) {
+      return found;
+    }
+  }
+  // Too many conflicts with writers, fall back to read latches.
   LockRootPageId(false);
   if (IsEmpty()) {
     UnlockRootPageId(false);
@@ -132,6 +140,88 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
   return false;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetValueOptimistic(const KeyType &key, std::vector<ValueType> *result, bool *found) -> bool {
+  // Sizes read before validation may be torn; never index past the arrays of the page.
+  constexpr int leaf_capacity =
+      (BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / static_cast<int>(sizeof(std::pair<KeyType, ValueType>));
+  constexpr int internal_capacity =
+      (BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / static_cast<int>(sizeof(std::pair<KeyType, page_id_t>));
+
+  page_id_t page_id = root_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
+    *found = false;
+    return true;
+  }
+  Page *page_ptr = buffer_pool_manager_->FetchPage(page_id);
+  if (page_ptr == nullptr) {
+    return false;
+  }
+  uint64_t version;
+  // A new root may have been installed between reading root_page_id_ and taking the version.
+  if (!page_ptr->TryOptimisticRead(&version) || page_id != root_page_id_) {
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    return false;
+  }
+
+  while (true) {
+    auto tree_page_ptr = reinterpret_cast<BPlusTreePage *>(page_ptr->GetData());
+    if (tree_page_ptr->IsLeafPage()) {
+      auto leaf_page_ptr = reinterpret_cast<LeafPage *>(tree_page_ptr);
+      int sz = std::clamp(leaf_page_ptr->GetSize(), 0, leaf_capacity);
+      int lo = 0;
+      int hi = sz;
+      while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (comparator_(leaf_page_ptr->KeyAt(mid), key) < 0) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+      bool hit = lo < sz && comparator_(leaf_page_ptr->KeyAt(lo), key) == 0;
+      ValueType value = hit ? leaf_page_ptr->ValueAt(lo) : ValueType();
+      bool valid = page_ptr->ValidateOptimisticRead(version);
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      if (!valid) {
+        return false;
+      }
+      if (hit) {
+        result->emplace_back(value);
+      }
+      *found = hit;
+      return true;
+    }
+
+    auto internal_page_ptr = reinterpret_cast<InternalPage *>(tree_page_ptr);
+    int sz = std::clamp(internal_page_ptr->GetSize(), 0, internal_capacity - 1);
+    int i = 1;
+    while (i <= sz && comparator_(internal_page_ptr->KeyAt(i), key) <= 0) {
+      i++;
+    }
+    page_id_t child_page_id = internal_page_ptr->ValueAt(i - 1);
+    // The child page id is only trustworthy once the read has been validated.
+    if (!page_ptr->ValidateOptimisticRead(version)) {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      return false;
+    }
+    Page *child_page_ptr = buffer_pool_manager_->FetchPage(child_page_id);
+    uint64_t child_version;
+    bool valid = child_page_ptr != nullptr && child_page_ptr->TryOptimisticRead(&child_version) &&
+                 page_ptr->ValidateOptimisticRead(version);
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    if (!valid) {
+      if (child_page_ptr != nullptr) {
+        buffer_pool_manager_->UnpinPage(child_page_id, false);
+      }
+      return false;
+    }
+    page_id = child_page_id;
+    page_ptr = child_page_ptr;
+    version = child_version;
+  }
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::FindLeaf(const KeyType &key, Transaction *transaction) -> LeafPage * {
   page_id_t page_id = root_page_id_;
@@ -168,7 +258,9 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
   auto leaf_page_ptr = FindLeafPage(key, OperationType::INSERT, transaction);
   if (leaf_page_ptr == nullptr) {
     LockRootPageId(true);
-    Page *root_page = buffer_pool_manager_->NewPage(&root_page_id_);
+    page_id_t root_page_id;
+    Page *root_page = buffer_pool_manager_->NewPage(&root_page_id);
+    root_page_id_ = root_page_id;
     UpdateRootPageId(1);
     auto root_page_ptr = reinterpret_cast<LeafPage *>(root_page->GetData());
     root_page_ptr->Init(root_page_id_, INVALID_PAGE_ID, leaf_max_size_);
@@ -185,7 +277,7 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
   if (leaf_page_ptr->GetSize() == leaf_page_ptr->GetMaxSize()) {
     // split new leafpage
     page_id_t new_leaf_page_id;
-    Page *new_leaf_page = buffer_pool_manager_->NewPage(&new_leaf_page_id);
+    Page *new_leaf_page = buffer_pool_manager_->NewPageNear(&new_leaf_page_id, leaf_page_ptr->GetPageId());
     auto new_leaf_page_ptr = reinterpret_cast<LeafPage *>(new_leaf_page->GetData());
     new_leaf_page_ptr->Init(new_leaf_page_id, leaf_page_ptr->GetParentPageId(), leaf_max_size_);
     KeyType mid_key = leaf_page_ptr->SplitInto(new_leaf_page_ptr);
@@ -227,7 +319,7 @@ void BPLUSTREE_TYPE::InsertIntoInternal(const page_id_t &parent_page_id, const K
   // internal_page is full
   if (internal_page_ptr->GetSize() == internal_page_ptr->GetMaxSize()) {
     page_id_t new_internal_page_id;
-    Page *new_internal_page = buffer_pool_manager_->NewPage(&new_internal_page_id);
+    Page *new_internal_page = buffer_pool_manager_->NewPageNear(&new_internal_page_id, parent_page_id);
 
     auto new_internal_page_ptr = reinterpret_cast<InternalPage *>(new_internal_page->GetData());
     new_internal_page_ptr->Init(new_internal_page_id, internal_page_ptr->GetParentPageId(), internal_max_size_);
@@ -13,10 +13,11 @@ namespace bustub {
  */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator(page_id_t page_id, int index, BufferPoolManager *buffer_pool_manager)
-    : index_(index), page_id_(page_id), buffer_pool_manager_(buffer_pool_manager) {
+    : index_(index), page_id_(page_id), buffer_pool_manager_(buffer_pool_manager), read_ahead_(buffer_pool_manager) {
   if (page_id_ != INVALID_PAGE_ID) {
-    Page *leaf_page = buffer_pool_manager_->FetchPage(page_id_);
-    leaf_page_ptr_ = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(leaf_page->GetData());
+    read_ahead_.Advance(INVALID_PAGE_ID, page_id_);
+    page_ptr_ = buffer_pool_manager_->FetchPage(page_id_);
+    leaf_page_ptr_ = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(page_ptr_->GetData());
   }
 }
 
@@ -31,19 +32,29 @@ INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::IsEnd() const -> bool { return page_id_ == INVALID_PAGE_ID && index_ == 0; }
 
 INDEX_TEMPLATE_ARGUMENTS auto INDEXITERATOR_TYPE::operator*() -> const MappingType & {
-  return leaf_page_ptr_->PairAt(index_);
+  // Copy the entry out with an optimistic read, so that a concurrent writer cannot change it under the caller.
+  page_ptr_->ReadOptimistically([&] { item_ = leaf_page_ptr_->PairAt(index_); });
+  return item_;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
   index_++;
-  if (index_ == leaf_page_ptr_->GetSize()) {
-    page_id_ = leaf_page_ptr_->GetNextPageId();
-    buffer_pool_manager_->UnpinPage(leaf_page_ptr_->GetPageId(), false);
+  int size;
+  page_id_t next_page_id;
+  page_ptr_->ReadOptimistically([&] {
+    size = leaf_page_ptr_->GetSize();
+    next_page_id = leaf_page_ptr_->GetNextPageId();
+  });
+  if (index_ == size) {
+    read_ahead_.Advance(page_id_, next_page_id);
+    buffer_pool_manager_->UnpinPage(page_id_, false);
+    page_id_ = next_page_id;
     if (page_id_ != INVALID_PAGE_ID) {
-      Page *leaf_page = buffer_pool_manager_->FetchPage(page_id_);
-      leaf_page_ptr_ = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(leaf_page->GetData());
+      page_ptr_ = buffer_pool_manager_->FetchPage(page_id_);
+      leaf_page_ptr_ = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(page_ptr_->GetData());
     } else {
+      page_ptr_ = nullptr;
       leaf_page_ptr_ = nullptr;
     }
     index_ = 0;
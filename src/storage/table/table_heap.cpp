@@ -10,7 +10,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
+#include <utility>
 
 #include "common/logger.h"
 #include "fmt/format.h"
@@ -23,7 +25,9 @@ TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_m
     : buffer_pool_manager_(buffer_pool_manager),
       lock_manager_(lock_manager),
       log_manager_(log_manager),
-      first_page_id_(first_page_id) {}
+      first_page_id_(first_page_id),
+      // Counting the pages here would read the whole table; the first full scan counts them instead.
+      num_pages_(UNKNOWN_NUM_PAGES) {}
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
                      Transaction *txn)
@@ -34,6 +38,7 @@ TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_m
                 "Couldn't create a page for the table heap. Have you completed the buffer pool manager project?");
   first_page->Init(first_page_id_, BUSTUB_PAGE_SIZE, INVALID_LSN, log_manager_, txn);
   buffer_pool_manager_->UnpinPage(first_page_id_, true);
+  num_pages_ = 1;
 }
 
 auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool {
@@ -64,7 +69,8 @@ auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> b
       cur_page = next_page;
     } else {
       // Otherwise we have run out of valid pages. We need to create a new page.
-      auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&next_page_id));
+      auto new_page =
+          static_cast<TablePage *>(buffer_pool_manager_->NewPageNear(&next_page_id, cur_page->GetTablePageId()));
       // If we could not create a new page,
       if (new_page == nullptr) {
         // Then life sucks and we abort the transaction.
@@ -77,6 +83,7 @@ auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> b
       new_page->WLatch();
       cur_page->SetNextPageId(next_page_id);
       new_page->Init(next_page_id, BUSTUB_PAGE_SIZE, cur_page->GetTablePageId(), log_manager_, txn);
+      CountNewPage();
       cur_page->WUnlatch();
       buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
       cur_page = new_page;
@@ -176,14 +183,66 @@ auto TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool ac
   return res;
 }
 
-auto TableHeap::Begin(Transaction *txn) -> TableIterator {
+auto TableHeap::GetTuples(const std::vector<RID> &rids, std::vector<Tuple> *tuples, Transaction *txn) -> bool {
+  // Every page is fetched once, however many of the tuples live on it.
+  std::vector<page_id_t> page_ids;
+  for (const auto &rid : rids) {
+    if (std::find(page_ids.begin(), page_ids.end(), rid.GetPageId()) == page_ids.end()) {
+      page_ids.push_back(rid.GetPageId());
+    }
+  }
+  tuples->assign(rids.size(), Tuple());
+  auto read_tuples = [&](page_id_t page_id, Page *page) {
+    auto table_page = static_cast<TablePage *>(page);
+    table_page->RLatch();
+    for (size_t i = 0; i < rids.size(); i++) {
+      if (rids[i].GetPageId() == page_id) {
+        table_page->GetTuple(rids[i], &(*tuples)[i], txn, lock_manager_);
+      }
+    }
+    table_page->RUnlatch();
+  };
+
+  std::vector<Page *> pages;
+  if (buffer_pool_manager_->FetchPages(page_ids, &pages) == page_ids.size()) {
+    for (size_t i = 0; i < page_ids.size(); i++) {
+      read_tuples(page_ids[i], pages[i]);
+    }
+    buffer_pool_manager_->UnpinPages(page_ids, false);
+    return true;
+  }
+  // Too few frames to pin the whole batch. Read what was pinned, let go of it, and fetch the rest one page at a time.
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    if (pages[i] != nullptr) {
+      read_tuples(page_ids[i], pages[i]);
+      buffer_pool_manager_->UnpinPage(page_ids[i], false);
+    }
+  }
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    if (pages[i] != nullptr) {
+      continue;
+    }
+    auto page = buffer_pool_manager_->FetchPage(page_ids[i]);
+    if (page == nullptr) {
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    read_tuples(page_ids[i], page);
+    buffer_pool_manager_->UnpinPage(page_ids[i], false);
+  }
+  return true;
+}
+
+auto TableHeap::Begin(Transaction *txn, std::shared_ptr<BufferAccessStrategy> strategy) -> TableIterator {
   // Start an iterator from the first page.
   // TODO(Wuwen): Hacky fix for now. Removing empty pages is a better way to handle this.
   RID rid;
   auto page_id = first_page_id_;
+  size_t pages_seen = 0;
   while (page_id != INVALID_PAGE_ID) {
-    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPageWithStrategy(page_id, strategy.get()));
     page->RLatch();
+    pages_seen++;
     // If this fails because there is no tuple, then RID will be the default-constructed value, which means EOF.
     auto found_tuple = page->GetFirstTupleRid(&rid);
     page->RUnlatch();
@@ -193,9 +252,25 @@ auto TableHeap::Begin(Transaction *txn) -> TableIterator {
     }
     page_id = page->GetNextPageId();
   }
-  return {this, rid, txn};
+  if (page_id == INVALID_PAGE_ID) {
+    LearnNumPages(pages_seen);
+  }
+  TableIterator it(this, rid, txn, std::move(strategy));
+  it.pages_seen_ = pages_seen;
+  return it;
 }
 
 auto TableHeap::End() -> TableIterator { return {this, RID(INVALID_PAGE_ID, 0), nullptr}; }
 
+void TableHeap::LearnNumPages(size_t num_pages) {
+  size_t unknown = UNKNOWN_NUM_PAGES;
+  num_pages_.compare_exchange_strong(unknown, num_pages);
+}
+
+void TableHeap::CountNewPage() {
+  size_t num_pages = num_pages_;
+  while (num_pages != UNKNOWN_NUM_PAGES && !num_pages_.compare_exchange_weak(num_pages, num_pages + 1)) {
+  }
+}
+
 }  // namespace bustub
@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// access_buffer_test.cpp
+//
+// Identification: test/buffer/access_buffer_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/access_buffer.h"
+
+#include <atomic>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(AccessBufferTest, SampleTest) {
+  AccessBuffer buffer;
+  std::vector<AccessBuffer::Event> events;
+
+  // Scenario: an empty buffer drains nothing.
+  buffer.Drain(&events);
+  EXPECT_TRUE(events.empty());
+
+  // Scenario: a thread fills its ring; the next access does not fit.
+  for (size_t i = 0; i < AccessBuffer::STRIPE_CAPACITY; i++) {
+    ASSERT_TRUE(buffer.TryRecord({buffer.NextTimestamp(), static_cast<frame_id_t>(i), i % 2 == 0}));
+  }
+  EXPECT_FALSE(buffer.TryRecord({buffer.NextTimestamp(), 0, false}));
+
+  // Scenario: draining returns the events in order, and makes room again.
+  buffer.Drain(&events);
+  ASSERT_EQ(AccessBuffer::STRIPE_CAPACITY, events.size());
+  for (size_t i = 0; i < events.size(); i++) {
+    EXPECT_EQ(i, events[i].timestamp_);
+    EXPECT_EQ(static_cast<frame_id_t>(i), events[i].frame_id_);
+    EXPECT_EQ(i % 2 == 0, events[i].pin_);
+  }
+  EXPECT_TRUE(buffer.TryRecord({buffer.NextTimestamp(), 7, false}));
+  events.clear();
+  buffer.Drain(&events);
+  ASSERT_EQ(1, events.size());
+  EXPECT_EQ(7, events[0].frame_id_);
+}
+
+// NOLINTNEXTLINE
+TEST(AccessBufferTest, ConcurrencyTest) {
+  const int num_threads = 8;
+  const int events_per_thread = 100000;
+  AccessBuffer buffer;
+
+  // Scenario: producers record as fast as they can, waiting whenever their ring is full, while one thread keeps
+  // draining. Every event comes out exactly once, and every batch is ordered.
+  std::atomic<int> running{num_threads};
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid] {
+      for (int i = 0; i < events_per_thread; i++) {
+        while (!buffer.TryRecord({buffer.NextTimestamp(), tid, false})) {
+          std::this_thread::yield();
+        }
+      }
+      running--;
+    });
+  }
+  std::vector<int> drained(num_threads, 0);
+  std::vector<AccessBuffer::Event> events;
+  bool done = false;
+  while (!done) {
+    done = running == 0;
+    std::this_thread::yield();
+    events.clear();
+    buffer.Drain(&events);
+    for (size_t i = 0; i < events.size(); i++) {
+      ASSERT_TRUE(i == 0 || events[i - 1].timestamp_ < events[i].timestamp_);
+      drained[events[i].frame_id_]++;
+    }
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (int tid = 0; tid < num_threads; tid++) {
+    EXPECT_EQ(events_per_thread, drained[tid]);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer_test.cpp
+//
+// Identification: test/buffer/arc_replacer_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ARCReplacerTest, SampleTest) {
+  ARCReplacer replacer(4);
+  frame_id_t frame_id;
+
+  // Scenario: pages 1 to 4 are brought into frames 0 to 3 and land in T1. A hit on page 1 moves it to T2.
+  for (frame_id_t i = 0; i < 4; i++) {
+    replacer.RecordAccess(i, i + 1);
+    replacer.SetEvictable(i, true);
+  }
+  replacer.RecordAccess(0, 1);
+  ASSERT_EQ(4, replacer.Size());
+  EXPECT_EQ(0, replacer.GetTarget());
+
+  // Scenario: T1 is larger than its target, so its LRU frame goes first. Page 2 is remembered in B1.
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(1, frame_id);
+  EXPECT_EQ(3, replacer.Size());
+
+  // Scenario: page 2 comes back. T1 was too small: the target grows and the page goes to T2.
+  replacer.RecordAccess(1, 2);
+  replacer.SetEvictable(1, true);
+  EXPECT_EQ(1, replacer.GetTarget());
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(2, frame_id);
+
+  // Scenario: with frame 3 pinned, T1 is at its target, so the LRU frame of T2 goes. Page 1 is remembered in B2.
+  replacer.SetEvictable(3, false);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(0, frame_id);
+  EXPECT_EQ(1, replacer.Size());
+
+  // Scenario: page 1 comes back. T2 was too small: the target shrinks.
+  replacer.RecordAccess(0, 1);
+  replacer.SetEvictable(0, true);
+  EXPECT_EQ(0, replacer.GetTarget());
+
+  // Scenario: pinned frames are never evicted, and removed frames are not remembered.
+  replacer.Remove(1);
+  EXPECT_EQ(1, replacer.Size());
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(0, frame_id);
+  EXPECT_FALSE(replacer.Evict(&frame_id));
+  EXPECT_EQ(0, replacer.Size());
+  replacer.RecordAccess(1, 2);
+  replacer.SetEvictable(1, true);
+  EXPECT_EQ(0, replacer.GetTarget());
+}
+
+// NOLINTNEXTLINE
+TEST(ARCReplacerTest, ScanResistanceTest) {
+  const size_t num_frames = 8;
+  ARCReplacer replacer(num_frames);
+  frame_id_t frame_id;
+
+  // Scenario: pages 0 to 3 are hot and sit in T2.
+  for (frame_id_t i = 0; i < 4; i++) {
+    replacer.RecordAccess(i, i);
+    replacer.RecordAccess(i, i);
+    replacer.SetEvictable(i, true);
+  }
+
+  // Scenario: a long scan runs through the other frames. It only ever evicts its own pages from T1.
+  page_id_t next_page_id = 100;
+  for (frame_id_t i = 4; i < static_cast<frame_id_t>(num_frames); i++) {
+    replacer.RecordAccess(i, next_page_id++);
+    replacer.SetEvictable(i, true);
+  }
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_TRUE(replacer.Evict(&frame_id));
+    ASSERT_GE(frame_id, 4);
+    replacer.RecordAccess(frame_id, next_page_id++);
+    replacer.SetEvictable(frame_id, true);
+  }
+  EXPECT_EQ(num_frames, replacer.Size());
+}
+
+}  // namespace bustub
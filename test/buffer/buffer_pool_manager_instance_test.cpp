@@ -12,12 +12,23 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <future>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
 
 namespace bustub {
 
@@ -75,10 +86,12 @@ TEST(BufferPoolManagerInstanceTest, BinaryDataTest) {
     EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
     bpm->UnpinPage(page_id_temp, false);
   }
-  // Scenario: We should be able to fetch the data we wrote a while ago.
+  // Scenario: We should be able to fetch the data we wrote a while ago. Only the checksum field was filled in.
   page0 = bpm->FetchPage(0);
+  std::memcpy(random_binary_data + Page::OFFSET_CHECKSUM, page0->GetData() + Page::OFFSET_CHECKSUM, sizeof(uint32_t));
   EXPECT_EQ(0, memcmp(page0->GetData(), random_binary_data, BUSTUB_PAGE_SIZE));
   EXPECT_EQ(true, bpm->UnpinPage(0, true));
+  EXPECT_EQ(0, disk_manager->GetNumChecksumFailures());
 
   // Shutdown the disk manager and remove the temporary file we created.
   disk_manager->ShutDown();
@@ -145,4 +158,949 @@ TEST(BufferPoolManagerInstanceTest, SampleTest) {
   delete disk_manager;
 }
 
+// Disk manager whose reads of one page block until the test releases them.
+class BlockingDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  explicit BlockingDiskManager(page_id_t blocked_page_id) : blocked_page_id_(blocked_page_id) {}
+
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    if (page_id == blocked_page_id_) {
+      entered_.set_value();
+      release_.wait();
+    }
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
+
+  page_id_t blocked_page_id_;
+  std::promise<void> entered_;
+  std::shared_future<void> release_;
+};
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, IOOutsideLatchTest) {
+  const size_t buffer_pool_size = 10;
+  const page_id_t cold_page_id = 100;
+
+  std::promise<void> release;
+  auto *disk_manager = new BlockingDiskManager(cold_page_id);
+  disk_manager->release_ = release.get_future().share();
+  char data[BUSTUB_PAGE_SIZE] = "cold";
+  disk_manager->WritePage(cold_page_id, data);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  page_id_t hot_page_id;
+  auto *hot_page = bpm->NewPage(&hot_page_id);
+  ASSERT_NE(nullptr, hot_page);
+  snprintf(hot_page->GetData(), BUSTUB_PAGE_SIZE, "hot");
+  EXPECT_TRUE(bpm->UnpinPage(hot_page_id, true));
+
+  // Scenario: a miss is stuck in the disk manager.
+  Page *cold_page_a = nullptr;
+  std::thread reader_a([&] { cold_page_a = bpm->FetchPage(cold_page_id); });
+  disk_manager->entered_.get_future().wait();
+
+  // Scenario: hits and new pages do not wait behind the miss.
+  auto *page = bpm->FetchPage(hot_page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, strcmp(page->GetData(), "hot"));
+  EXPECT_TRUE(bpm->UnpinPage(hot_page_id, false));
+  page_id_t page_id_temp;
+  EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+
+  // Scenario: a second fetcher of the same page waits for the first read instead of issuing its own.
+  std::atomic<bool> reader_b_done{false};
+  Page *cold_page_b = nullptr;
+  std::thread reader_b([&] {
+    cold_page_b = bpm->FetchPage(cold_page_id);
+    reader_b_done = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(reader_b_done);
+
+  release.set_value();
+  reader_a.join();
+  reader_b.join();
+  ASSERT_NE(nullptr, cold_page_a);
+  EXPECT_EQ(cold_page_a, cold_page_b);
+  EXPECT_EQ(0, strcmp(cold_page_a->GetData(), "cold"));
+  EXPECT_EQ(2, cold_page_a->GetPinCount());
+  EXPECT_EQ(1, bpm->GetStats().misses_);
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, PageCleanerTest) {
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: fill the pool with dirty, unpinned pages.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: no frame is ready for reuse, so the cleaner writes out the upcoming victims.
+  bpm->RunPageCleaner(buffer_pool_size / 2, buffer_pool_size);
+  for (int i = 0; i < 500 && bpm->GetStats().background_write_backs_ < buffer_pool_size; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(buffer_pool_size, bpm->GetStats().background_write_backs_);
+  bpm->StopPageCleaner();
+
+  // Scenario: evictions now find clean frames and do not write anything themselves.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  }
+  EXPECT_EQ(0, bpm->GetStats().write_backs_);
+
+  // Scenario: the cleaned pages made it to disk.
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size); ++page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, PrefetchTest) {
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: write out twice as many pages as the pool holds, so that pages 0-9 are on disk only.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < 2 * buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+  auto misses = bpm->GetStats().misses_;
+
+  // Scenario: unallocated pages are not prefetched, only the pages 0-3 are read.
+  bpm->PrefetchPages(-2, 6, nullptr);
+  bpm->PrefetchPages(100, 4, nullptr);
+  for (int i = 0; i < 500 && bpm->GetStats().prefetches_ < 4; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(4, bpm->GetStats().prefetches_);
+
+  // Scenario: fetching the prefetched pages does not go to disk.
+  for (page_id_t page_id = 0; page_id < 4; ++page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_EQ(1, page->GetPinCount());
+  }
+  EXPECT_EQ(misses, bpm->GetStats().misses_);
+
+  // Scenario: resident pages are skipped. The 4 pinned pages leave 6 frames to prefetch into.
+  bpm->PrefetchPages(0, 20, nullptr);
+  for (int i = 0; i < 500 && bpm->GetStats().prefetches_ < 10; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  bpm->StopPrefetcher();
+  EXPECT_EQ(10, bpm->GetStats().prefetches_);
+  for (page_id_t page_id = 0; page_id < 4; ++page_id) {
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, AccessStrategyTest) {
+  const size_t buffer_pool_size = 10;
+  const page_id_t num_pages = 30;
+  const page_id_t hot_pages = 4;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  page_id_t page_id_temp;
+  for (page_id_t i = 0; i < num_pages; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+  // Scenario: the first pages are the hot set of some other transactions.
+  for (page_id_t page_id = 0; page_id < hot_pages; ++page_id) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: a scan with a ring of 2 frames only takes 2 frames from the pool and recycles them afterwards.
+  auto strategy = std::make_shared<BufferAccessStrategy>(2);
+  auto before = bpm->GetStats();
+  for (page_id_t page_id = hot_pages; page_id < num_pages; ++page_id) {
+    auto *page = bpm->FetchPageWithStrategy(page_id, strategy.get());
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  auto after = bpm->GetStats();
+  EXPECT_LT(2, after.misses_ - before.misses_);
+  EXPECT_EQ(after.misses_ - before.misses_ - 2, after.ring_reuses_ - before.ring_reuses_);
+
+  // Scenario: the hot set survived the scan.
+  for (page_id_t page_id = 0; page_id < hot_pages; ++page_id) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(after.misses_, bpm->GetStats().misses_);
+
+  // Scenario: ring frames that are still pinned are not recycled, the scan falls back to the replacer.
+  for (page_id_t page_id = hot_pages; page_id < hot_pages + 3; ++page_id) {
+    auto *page = bpm->FetchPageWithStrategy(page_id, strategy.get());
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+  }
+  EXPECT_EQ(after.ring_reuses_ + 2, bpm->GetStats().ring_reuses_);
+  for (page_id_t page_id = hot_pages; page_id < hot_pages + 3; ++page_id) {
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: read-ahead for a scan only recycles the frames of its ring. Pages 12 and 13 take the frames of 10 and
+  // 11, while 14 and 15 would have to wait for 12 and 13 to be read and are dropped instead of evicting the hot set.
+  auto prefetch_strategy = std::make_shared<BufferAccessStrategy>(2);
+  for (page_id_t page_id = 10; page_id < 12; ++page_id) {
+    ASSERT_NE(nullptr, bpm->FetchPageWithStrategy(page_id, prefetch_strategy.get()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  before = bpm->GetStats();
+  bpm->PrefetchPages(12, 4, prefetch_strategy);
+  for (int i = 0; i < 500 && bpm->GetStats().prefetches_ < before.prefetches_ + 2; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  bpm->StopPrefetcher();
+  after = bpm->GetStats();
+  EXPECT_EQ(before.prefetches_ + 2, after.prefetches_);
+  EXPECT_EQ(before.ring_reuses_ + 2, after.ring_reuses_);
+  for (page_id_t page_id = 0; page_id < hot_pages; ++page_id) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(after.misses_, bpm->GetStats().misses_);
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, ResizeTest) {
+  const size_t buffer_pool_size = 5;
+  const size_t max_pool_size = 10;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, LRUK_REPLACER_K, nullptr, max_pool_size);
+  EXPECT_EQ(buffer_pool_size, bpm->GetPoolSize());
+  EXPECT_EQ(max_pool_size, bpm->GetMaxPoolSize());
+
+  // Scenario: sizes out of range are rejected.
+  EXPECT_FALSE(bpm->Resize(0));
+  EXPECT_FALSE(bpm->Resize(max_pool_size + 1));
+
+  // Scenario: a full pool takes new pages again once it has grown.
+  std::vector<page_id_t> page_ids(max_pool_size);
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_ids[i]);
+  }
+  page_id_t page_id_temp;
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+  ASSERT_TRUE(bpm->Resize(max_pool_size));
+  EXPECT_EQ(max_pool_size, bpm->GetPoolSize());
+  for (size_t i = buffer_pool_size; i < max_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_ids[i]);
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+
+  // Scenario: shrinking waits for the pinned pages in the dropped frames. Pages stay usable meanwhile.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], true));
+  }
+  auto shrink = std::async(std::launch::async, [&] { return bpm->Resize(buffer_pool_size); });
+  EXPECT_EQ(std::future_status::timeout, shrink.wait_for(std::chrono::milliseconds(50)));
+  EXPECT_FALSE(bpm->Resize(max_pool_size));
+  for (size_t i = buffer_pool_size; i < max_pool_size; ++i) {
+    EXPECT_EQ(std::to_string(page_ids[i]), std::string(bpm->FetchPage(page_ids[i])->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], true));
+  }
+  EXPECT_TRUE(shrink.get());
+  EXPECT_EQ(buffer_pool_size, bpm->GetPoolSize());
+  EXPECT_EQ(buffer_pool_size, bpm->GetFrameArena()->GetNumFrames());
+
+  // Scenario: the evicted pages were written back, and the pool holds only buffer_pool_size pages at once.
+  for (size_t i = 0; i < max_pool_size; ++i) {
+    auto *page = bpm->FetchPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(std::to_string(page_ids[i]), std::string(page->GetData()));
+    EXPECT_LT(static_cast<size_t>(page - bpm->GetPages()), buffer_pool_size);
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    EXPECT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+  }
+  EXPECT_EQ(nullptr, bpm->FetchPage(page_ids[buffer_pool_size]));
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, ResizeUnderLoadTest) {
+  const size_t max_pool_size = 32;
+  const page_id_t num_pages = 64;
+  const size_t num_threads = 4;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(max_pool_size, disk_manager, LRUK_REPLACER_K, nullptr, max_pool_size);
+  page_id_t page_id_temp;
+  for (page_id_t i = 0; i < num_pages; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: readers and writers keep going while the pool shrinks and grows underneath them.
+  std::atomic<bool> done{false};
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([&, tid] {
+      std::mt19937 gen(tid);
+      std::uniform_int_distribution<page_id_t> dis(0, num_pages - 1);
+      while (!done) {
+        auto page_id = dis(gen);
+        auto *page = bpm->FetchPage(page_id);
+        if (page == nullptr) {
+          continue;
+        }
+        page->WLatch();
+        EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+        page->WUnlatch();
+        EXPECT_TRUE(bpm->UnpinPage(page_id, tid % 2 == 0));
+      }
+    });
+  }
+  for (size_t new_size : {16, 8, 32, 4, 24, 32}) {
+    EXPECT_TRUE(bpm->Resize(new_size));
+    EXPECT_EQ(new_size, bpm->GetPoolSize());
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  done = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, ReplacerPolicyTest) {
+  const size_t buffer_pool_size = 10;
+  const page_id_t num_pages = 30;
+
+  for (auto policy : {ReplacerPolicy::LRU_K, ReplacerPolicy::ARC, ReplacerPolicy::TWO_Q, ReplacerPolicy::W_TINY_LFU}) {
+    SCOPED_TRACE(ReplacerPolicyToString(policy));
+    auto *disk_manager = new DiskManagerUnlimitedMemory();
+    auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, LRUK_REPLACER_K, nullptr, 0, policy);
+
+    // Scenario: create three times as many pages as there are frames. The first page stays pinned.
+    page_id_t page_id_temp;
+    Page *pinned = nullptr;
+    for (page_id_t i = 0; i < num_pages; ++i) {
+      auto *page = bpm->NewPage(&page_id_temp);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+      if (i == 0) {
+        pinned = page;
+      } else {
+        EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+      }
+    }
+
+    // Scenario: a skewed mix of fetches. Every page comes back with its data, and the pinned page never moves.
+    std::mt19937 gen(15445);
+    std::uniform_int_distribution<page_id_t> dis(1, num_pages - 1);
+    for (int i = 0; i < 1000; ++i) {
+      auto page_id = i % 2 == 0 ? dis(gen) % 4 + 1 : dis(gen);
+      auto *page = bpm->FetchPage(page_id);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+      EXPECT_NE(pinned, page);
+      EXPECT_TRUE(bpm->UnpinPage(page_id, i % 3 == 0));
+    }
+    EXPECT_EQ(0, pinned->GetPageId());
+    EXPECT_TRUE(bpm->UnpinPage(0, false));
+
+    // Scenario: deleted pages free their frames for new pages.
+    for (page_id_t i = 1; i < 5; ++i) {
+      ASSERT_NE(nullptr, bpm->FetchPage(i));
+      EXPECT_TRUE(bpm->UnpinPage(i, false));
+      EXPECT_TRUE(bpm->DeletePage(i));
+    }
+    for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size); ++i) {
+      ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    }
+    EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+// Disk manager that records the runs handed to WritePages.
+class RunRecordingDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  void WritePages(page_id_t first_page_id, const char *const *pages, size_t num_pages) override {
+    {
+      std::scoped_lock<std::mutex> lock(runs_latch_);
+      runs_.emplace_back(first_page_id, num_pages);
+    }
+    DiskManagerUnlimitedMemory::WritePages(first_page_id, pages, num_pages);
+  }
+
+  std::mutex runs_latch_;
+  std::vector<std::pair<page_id_t, size_t>> runs_;
+};
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, BatchEvictionTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t batch_size = 8;
+
+  auto *disk_manager = new RunRecordingDiskManager();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  bpm->EnableBatchEviction(1, batch_size);
+
+  // Scenario: fill the pool with dirty, unpinned pages 0 to 9.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+  EXPECT_EQ(0, bpm->GetStats().eviction_batches_);
+
+  // Scenario: the next page finds no free frame. Pages 0 to 7 are evicted together and written with one request;
+  // the following pages take the freed frames without evicting anything.
+  for (size_t i = 0; i < batch_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, page_id_temp % 2 == 0));
+  }
+  auto stats = bpm->GetStats();
+  EXPECT_EQ(1, stats.eviction_batches_);
+  EXPECT_EQ(1, stats.batch_writes_);
+  EXPECT_EQ(batch_size, stats.evictions_);
+  ASSERT_EQ(1, disk_manager->runs_.size());
+  EXPECT_EQ(std::make_pair(0, batch_size), disk_manager->runs_[0]);
+
+  // Scenario: the next batch holds pages 8 to 15, of which 11, 13 and 15 are clean. The dirty ones are written as
+  // the runs 8-10, 12 and 14.
+  EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  stats = bpm->GetStats();
+  EXPECT_EQ(2, stats.eviction_batches_);
+  EXPECT_EQ(4, stats.batch_writes_);
+  ASSERT_EQ(4, disk_manager->runs_.size());
+  EXPECT_EQ(std::make_pair(8, size_t{3}), disk_manager->runs_[1]);
+  EXPECT_EQ(std::make_pair(12, size_t{1}), disk_manager->runs_[2]);
+  EXPECT_EQ(std::make_pair(14, size_t{1}), disk_manager->runs_[3]);
+
+  // Scenario: every page that was written back comes back with its data.
+  for (page_id_t page_id = 0; page_id < 15; ++page_id) {
+    if (page_id > 10 && page_id % 2 == 1) {
+      continue;
+    }
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, BatchEvictionUnderLoadTest) {
+  const size_t max_pool_size = 32;
+  const page_id_t num_pages = 128;
+  const size_t num_threads = 4;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(max_pool_size, disk_manager, LRUK_REPLACER_K, nullptr, max_pool_size);
+  bpm->EnableBatchEviction(4, 8);
+  page_id_t page_id_temp;
+  for (page_id_t i = 0; i < num_pages; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: readers and writers miss all the time while batches are written back, the pool is resized and
+  // everything is flushed. No page loses its data.
+  std::atomic<bool> done{false};
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([&, tid] {
+      std::mt19937 gen(tid);
+      std::uniform_int_distribution<page_id_t> dis(0, num_pages - 1);
+      while (!done) {
+        auto page_id = dis(gen);
+        auto *page = bpm->FetchPage(page_id);
+        if (page == nullptr) {
+          continue;
+        }
+        page->WLatch();
+        EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+        page->WUnlatch();
+        EXPECT_TRUE(bpm->UnpinPage(page_id, tid % 2 == 0));
+      }
+    });
+  }
+  for (size_t new_size : {16, 32, 8, 32}) {
+    EXPECT_TRUE(bpm->Resize(new_size));
+    bpm->FlushAllPages();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  done = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_LT(0, bpm->GetStats().eviction_batches_);
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, HitsRaceEvictionTest) {
+  const size_t buffer_pool_size = 4;
+  const page_id_t num_pages = 8;
+  const size_t num_threads = 4;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  page_id_t page_id_temp;
+  for (page_id_t i = 0; i < num_pages; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: twice as many pages as frames, so hits keep finding pages that are being evicted. A hit either gets
+  // the page it asked for, or falls back to a miss; no frame is left pinned or non-evictable.
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([&, tid] {
+      std::mt19937 gen(tid);
+      std::uniform_int_distribution<page_id_t> dis(0, num_pages - 1);
+      for (int i = 0; i < 20000; ++i) {
+        auto page_id = dis(gen);
+        auto *page = bpm->FetchPage(page_id);
+        if (page == nullptr) {
+          continue;
+        }
+        EXPECT_EQ(page_id, page->GetPageId());
+        page->RLatch();
+        EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+        page->RUnlatch();
+        EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_LT(0, bpm->GetStats().hits_);
+  EXPECT_LT(0, bpm->GetStats().evictions_);
+
+  // Every frame can still be taken.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, FetchPagesTest) {
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: create twice as many pages as there are frames; pages 10 to 19 stay resident.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < 2 * buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: hits and misses in one call. Every page comes back pinned once per occurrence.
+  std::vector<page_id_t> page_ids{12, 3, 15, 4, 12, 5};
+  std::vector<Page *> pages;
+  auto before = bpm->GetStats();
+  ASSERT_EQ(page_ids.size(), bpm->FetchPages(page_ids, &pages));
+  ASSERT_EQ(page_ids.size(), pages.size());
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    ASSERT_NE(nullptr, pages[i]);
+    EXPECT_EQ(page_ids[i], pages[i]->GetPageId());
+    EXPECT_EQ(std::to_string(page_ids[i]), std::string(pages[i]->GetData()));
+  }
+  EXPECT_EQ(pages[0], pages[4]);
+  EXPECT_EQ(2, pages[0]->GetPinCount());
+  auto after = bpm->GetStats();
+  EXPECT_EQ(3, after.hits_ - before.hits_);
+  EXPECT_EQ(3, after.misses_ - before.misses_);
+  EXPECT_EQ(page_ids.size(), bpm->UnpinPages(page_ids, false));
+  EXPECT_EQ(0, pages[0]->GetPinCount());
+  EXPECT_EQ(0, bpm->UnpinPages({12, 100}, false));
+
+  // Scenario: more pages than frames. The pages that do not fit are not fetched.
+  page_ids.clear();
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size) + 2; ++page_id) {
+    page_ids.push_back(page_id);
+  }
+  EXPECT_EQ(buffer_pool_size, bpm->FetchPages(page_ids, &pages));
+  EXPECT_EQ(nullptr, pages[buffer_pool_size]);
+  EXPECT_EQ(nullptr, pages[buffer_pool_size + 1]);
+  EXPECT_EQ(buffer_pool_size, bpm->UnpinPages(page_ids, false));
+
+  // Scenario: concurrent batches that overlap keep missing and evicting each other's pages.
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < 4; ++tid) {
+    threads.emplace_back([&, tid] {
+      std::mt19937 gen(tid);
+      std::uniform_int_distribution<page_id_t> dis(0, 2 * buffer_pool_size - 1);
+      std::vector<Page *> thread_pages;
+      for (int round = 0; round < 500; ++round) {
+        std::vector<page_id_t> thread_page_ids{dis(gen), dis(gen)};
+        bpm->FetchPages(thread_page_ids, &thread_pages);
+        for (size_t i = 0; i < thread_page_ids.size(); ++i) {
+          if (thread_pages[i] != nullptr) {
+            EXPECT_EQ(std::to_string(thread_page_ids[i]), std::string(thread_pages[i]->GetData()));
+            EXPECT_TRUE(bpm->UnpinPage(thread_page_ids[i], round % 2 == 0));
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, WarmUpTest) {
+  const size_t buffer_pool_size = 10;
+  const std::string hot_set_path = "bpm_warm_up_test.hotset";
+  remove(hot_set_path.c_str());
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, 2);
+
+  // Scenario: create three times as many pages as there are frames; pages 20 to 29 stay resident, and pages 21 and
+  // 25 are used again.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < 3 * buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+  for (page_id_t page_id : {25, 21}) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  bpm->FlushAllPages();
+  ASSERT_TRUE(bpm->SaveHotSet(hot_set_path));
+  delete bpm;
+
+  // Scenario: a restarted buffer pool loads the hot set before it serves anything, so every fetch is a hit.
+  bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, 2);
+  EXPECT_EQ(buffer_pool_size, bpm->WarmUp(hot_set_path, false));
+  EXPECT_EQ(buffer_pool_size, bpm->GetStats().warm_up_pages_);
+  for (page_id_t page_id = 20; page_id < 30; ++page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(buffer_pool_size, bpm->GetStats().hits_);
+  EXPECT_EQ(0, bpm->GetStats().misses_);
+
+  // Scenario: new pages do not reuse the ids of saved pages, and the restored history decides the victims: page 20
+  // was used first and only once before the restart.
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(30, page_id_temp);
+  EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  ASSERT_NE(nullptr, bpm->FetchPage(20));
+  EXPECT_TRUE(bpm->UnpinPage(20, false));
+  EXPECT_EQ(1, bpm->GetStats().misses_);
+  delete bpm;
+
+  // Scenario: a smaller pool warms up in the background and keeps the most recently used pages.
+  bpm = new BufferPoolManagerInstance(buffer_pool_size / 2, disk_manager, 2);
+  EXPECT_EQ(buffer_pool_size / 2, bpm->WarmUp(hot_set_path, true));
+  bpm->WaitForWarmUp();
+  EXPECT_EQ(buffer_pool_size / 2, bpm->GetStats().warm_up_pages_);
+  for (page_id_t page_id : {21, 25, 27, 28, 29}) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(0, bpm->GetStats().misses_);
+  delete bpm;
+
+  // Scenario: a hot set of another instance, or no hot set at all, loads nothing.
+  bpm = new BufferPoolManagerInstance(buffer_pool_size, 2, 0, disk_manager, 2);
+  EXPECT_EQ(0, bpm->WarmUp(hot_set_path, false));
+  EXPECT_EQ(0, bpm->WarmUp("no_such_file.hotset", false));
+  delete bpm;
+
+  // Scenario: the dumper saves the hot set when it stops.
+  bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, 2);
+  remove(hot_set_path.c_str());
+  bpm->RunHotSetDumper(hot_set_path);
+  ASSERT_NE(nullptr, bpm->FetchPage(3));
+  EXPECT_TRUE(bpm->UnpinPage(3, false));
+  bpm->StopHotSetDumper();
+  delete bpm;
+  bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, 2);
+  EXPECT_EQ(1, bpm->WarmUp(hot_set_path, false));
+  delete bpm;
+
+  remove(hot_set_path.c_str());
+  delete disk_manager;
+}
+
+class CountingDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    reads_++;
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
+
+  void WritePage(page_id_t page_id, const char *page_data) override {
+    writes_++;
+    DiskManagerUnlimitedMemory::WritePage(page_id, page_data);
+  }
+
+  std::atomic<size_t> reads_{0};
+  std::atomic<size_t> writes_{0};
+};
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, VictimCacheTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t num_pages = 16;
+
+  auto *disk_manager = new CountingDiskManager();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  bpm->EnableVictimCache(num_pages * BUSTUB_PAGE_SIZE);
+
+  // Scenario: create four times as many pages as there are frames. Dirty victims are written back and cached.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < num_pages; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+  EXPECT_EQ(num_pages - buffer_pool_size, bpm->GetVictimCacheStats().pages_);
+  EXPECT_EQ(num_pages - buffer_pool_size, disk_manager->writes_);
+
+  // Scenario: reading all pages twice over misses on every page but never goes to disk; clean victims are cached too.
+  for (int round = 0; round < 2; ++round) {
+    for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(num_pages); ++page_id) {
+      auto *page = bpm->FetchPage(page_id);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+      EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+    }
+  }
+  EXPECT_EQ(0, disk_manager->reads_);
+  EXPECT_EQ(num_pages, disk_manager->writes_);
+  auto stats = bpm->GetVictimCacheStats();
+  EXPECT_EQ(2 * num_pages, stats.hits_);
+  EXPECT_EQ(0, stats.misses_);
+  EXPECT_GT(stats.CompressionRatio(), 10);
+
+  // Scenario: a deleted page leaves the cache as well.
+  EXPECT_TRUE(bpm->DeletePage(0));
+  EXPECT_EQ(num_pages - buffer_pool_size - 1, bpm->GetVictimCacheStats().pages_);
+
+  // Scenario: concurrent updates; whichever tier a page comes from, it is the latest version.
+  std::vector<std::atomic<int>> versions(num_pages);
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < 4; ++tid) {
+    threads.emplace_back([&, tid] {
+      std::mt19937 gen(tid);
+      std::uniform_int_distribution<page_id_t> dis(1, num_pages - 1);
+      for (int i = 0; i < 500; ++i) {
+        page_id_t page_id = dis(gen);
+        auto *page = bpm->FetchPage(page_id);
+        if (page == nullptr) {
+          continue;
+        }
+        page->WLatch();
+        int version = versions[page_id];
+        EXPECT_EQ(version == 0 ? std::to_string(page_id) : std::to_string(page_id) + "." + std::to_string(version),
+                  std::string(page->GetData()));
+        versions[page_id] = ++version;
+        snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d.%d", page_id, version);
+        page->WUnlatch();
+        EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, PageReuseTest) {
+  const size_t buffer_pool_size = 5;
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: create ten pages and write all of them out.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < 2 * buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+  bpm->FlushAllPages();
+
+  // Scenario: deleted pages, resident or not, are reused before new ids are allocated, the one closest to the hint
+  // first.
+  EXPECT_TRUE(bpm->DeletePage(2));
+  EXPECT_TRUE(bpm->DeletePage(7));
+  EXPECT_EQ(2, disk_manager->GetNumFreePages());
+  auto *page = bpm->NewPageNear(&page_id_temp, 6);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(7, page_id_temp);
+  EXPECT_EQ(0, page->GetData()[0]);
+  EXPECT_TRUE(bpm->UnpinPage(7, false));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(2, page_id_temp);
+  EXPECT_TRUE(bpm->UnpinPage(2, false));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(10, page_id_temp);
+  EXPECT_TRUE(bpm->UnpinPage(10, false));
+  EXPECT_EQ(2, bpm->GetStats().reused_pages_);
+
+  // Scenario: a reused page is written out on eviction even if nobody dirtied it, so the old data never comes back.
+  for (page_id_t page_id = 0; page_id < 10; ++page_id) {
+    page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(page_id == 2 || page_id == 7 ? "" : std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: a deleted page cannot be fetched, so its id is never resident when it is reused.
+  EXPECT_TRUE(bpm->DeletePage(3));
+  EXPECT_EQ(nullptr, bpm->FetchPage(3));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(3, page_id_temp);
+  EXPECT_TRUE(bpm->UnpinPage(3, false));
+  page = bpm->FetchPage(3);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, page->GetData()[0]);
+  EXPECT_TRUE(bpm->UnpinPage(3, false));
+
+  // Scenario: deleting an id that was never handed out, or one that is free already, frees nothing.
+  EXPECT_TRUE(bpm->DeletePage(100));
+  EXPECT_TRUE(bpm->DeletePage(4));
+  EXPECT_TRUE(bpm->DeletePage(4));
+  EXPECT_EQ(1, disk_manager->GetNumFreePages());
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, WriteErrorTest) {
+  const size_t buffer_pool_size = 5;
+  const size_t segment_pages = 4;
+  const std::string dir = "bpm_write_error_test";
+  const std::string db_name = dir + "/test.db";
+  mkdir(dir.c_str(), 0755);
+  auto *disk_manager = new DiskManager(db_name, false, segment_pages);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+  // Page 4 lies in the second segment, whose file can no longer be created.
+  remove(db_name.c_str());
+  remove((dir + "/test.log").c_str());
+  rmdir(dir.c_str());
+
+  // Scenario: a page whose flush fails stays dirty, the others are clean.
+  bpm->FlushAllPages();
+  EXPECT_EQ(1, bpm->GetStats().io_errors_);
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size); ++page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(page_id == 4, page->IsDirty());
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: a victim whose write-back fails is written once more before its frame is read over.
+  std::vector<page_id_t> page_ids{5, 6, 7, 8, 9};
+  std::vector<Page *> pages;
+  EXPECT_EQ(page_ids.size(), bpm->FetchPages(page_ids, &pages));
+  EXPECT_EQ(3, bpm->GetStats().io_errors_);
+  EXPECT_EQ(page_ids.size(), bpm->UnpinPages(page_ids, false));
+
+  disk_manager->ShutDown();
+  delete bpm;
+  delete disk_manager;
+}
+
 }  // namespace bustub
@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache_test.cpp
+//
+// Identification: test/buffer/compressed_page_cache_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/compressed_page_cache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, SampleTest) {
+  CompressedPageCache cache(4096);
+  std::vector<char> page(BUSTUB_PAGE_SIZE, 0);
+  std::vector<char> data(BUSTUB_PAGE_SIZE);
+
+  // Scenario: pages come back once, the cache is exclusive.
+  for (page_id_t page_id = 0; page_id < 4; page_id++) {
+    snprintf(page.data(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    cache.Insert(page_id, page.data());
+  }
+  ASSERT_TRUE(cache.Lookup(2, data.data()));
+  EXPECT_EQ("page 2", std::string(data.data()));
+  EXPECT_FALSE(cache.Lookup(2, data.data()));
+  auto stats = cache.GetStats();
+  EXPECT_EQ(4, stats.inserts_);
+  EXPECT_EQ(1, stats.hits_);
+  EXPECT_EQ(1, stats.misses_);
+  EXPECT_EQ(3, stats.pages_);
+  EXPECT_GT(stats.CompressionRatio(), 10);
+
+  // Scenario: a page inserted again replaces its old version; an erased page is gone.
+  snprintf(page.data(), BUSTUB_PAGE_SIZE, "page %d, version 2", 1);
+  cache.Insert(1, page.data());
+  cache.Erase(3);
+  EXPECT_FALSE(cache.Lookup(3, data.data()));
+  ASSERT_TRUE(cache.Lookup(1, data.data()));
+  EXPECT_EQ("page 1, version 2", std::string(data.data()));
+
+  // Scenario: a page that does not compress is not kept, and takes its old version with it.
+  std::mt19937 gen(15445);
+  for (auto &byte : page) {
+    byte = static_cast<char>(gen());
+  }
+  cache.Insert(0, page.data());
+  EXPECT_FALSE(cache.Lookup(0, data.data()));
+  EXPECT_EQ(1, cache.GetStats().rejects_);
+  EXPECT_EQ(0, cache.GetStats().pages_);
+  EXPECT_EQ(0, cache.GetStats().bytes_);
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, CapacityTest) {
+  std::vector<char> page(BUSTUB_PAGE_SIZE, 0);
+  std::mt19937 gen(15445);
+  // Half random, half zeros: about half a page per entry.
+  for (size_t i = 0; i < BUSTUB_PAGE_SIZE / 2; i++) {
+    page[i] = static_cast<char>(gen());
+  }
+  CompressedPageCache cache(BUSTUB_PAGE_SIZE * 2);
+
+  // Scenario: a full cache drops the oldest pages first and stays within its capacity.
+  for (page_id_t page_id = 0; page_id < 10; page_id++) {
+    page[0] = static_cast<char>(page_id);
+    cache.Insert(page_id, page.data());
+    EXPECT_LE(cache.GetStats().bytes_, BUSTUB_PAGE_SIZE * 2);
+  }
+  auto stats = cache.GetStats();
+  EXPECT_EQ(10, stats.inserts_);
+  EXPECT_EQ(10, stats.evictions_ + stats.pages_);
+  EXPECT_EQ(3, stats.pages_);
+  std::vector<char> data(BUSTUB_PAGE_SIZE);
+  EXPECT_FALSE(cache.Lookup(6, data.data()));
+  for (page_id_t page_id = 7; page_id < 10; page_id++) {
+    ASSERT_TRUE(cache.Lookup(page_id, data.data()));
+    EXPECT_EQ(static_cast<char>(page_id), data[0]);
+    EXPECT_EQ(0, memcmp(page.data() + 1, data.data() + 1, BUSTUB_PAGE_SIZE - 1));
+  }
+}
+
+}  // namespace bustub
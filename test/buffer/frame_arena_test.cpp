@@ -0,0 +1,143 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena_test.cpp
+//
+// Identification: test/buffer/frame_arena_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_arena.h"
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(FrameArenaTest, SampleTest) {
+  const size_t num_frames = 10;
+  FrameArena arena(num_frames);
+
+  // Scenario: a small arena is not worth a huge page.
+  EXPECT_EQ(FrameArena::Backing::REGULAR, arena.GetBacking());
+  EXPECT_GE(arena.GetMappedSize(), num_frames * BUSTUB_PAGE_SIZE);
+
+  // Scenario: the frames are laid out back to back in one page-aligned region, and start out empty.
+  auto os_page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(arena.GetData()) % os_page_size);
+  for (size_t i = 0; i < num_frames; i++) {
+    Page &page = arena.GetPages()[i];
+    EXPECT_EQ(arena.GetData() + i * BUSTUB_PAGE_SIZE, page.GetData());
+    EXPECT_EQ(INVALID_PAGE_ID, page.GetPageId());
+    EXPECT_EQ(0, page.GetPinCount());
+    EXPECT_FALSE(page.IsDirty());
+    for (size_t j = 0; j < BUSTUB_PAGE_SIZE; j++) {
+      ASSERT_EQ(0, page.GetData()[j]);
+    }
+  }
+
+  // Scenario: the frames do not overlap.
+  for (size_t i = 0; i < num_frames; i++) {
+    memset(arena.GetPages()[i].GetData(), static_cast<int>(i), BUSTUB_PAGE_SIZE);
+  }
+  for (size_t i = 0; i < num_frames; i++) {
+    EXPECT_EQ(static_cast<char>(i), arena.GetPages()[i].GetData()[0]);
+    EXPECT_EQ(static_cast<char>(i), arena.GetPages()[i].GetData()[BUSTUB_PAGE_SIZE - 1]);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(FrameArenaTest, HugePageTest) {
+  // A little over two huge pages, so that the region has to be rounded up.
+  const size_t num_frames = 2 * FrameArena::HUGE_PAGE_SIZE / BUSTUB_PAGE_SIZE + 1;
+
+  // Scenario: without huge pages, the region is only rounded up to the OS page size.
+  FrameArena regular(num_frames, false);
+  EXPECT_EQ(FrameArena::Backing::REGULAR, regular.GetBacking());
+  EXPECT_LT(regular.GetMappedSize(), 3 * FrameArena::HUGE_PAGE_SIZE);
+
+  // Scenario: with huge pages, the region is a whole number of huge pages. Whatever backs it on this machine, a huge
+  // page backing must start on a huge page boundary.
+  FrameArena huge(num_frames);
+  EXPECT_EQ(3 * FrameArena::HUGE_PAGE_SIZE, huge.GetMappedSize());
+  if (huge.GetBacking() != FrameArena::Backing::REGULAR) {
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(huge.GetData()) % FrameArena::HUGE_PAGE_SIZE);
+  }
+  Page &last = huge.GetPages()[num_frames - 1];
+  memset(last.GetData(), 1, BUSTUB_PAGE_SIZE);
+  EXPECT_EQ(1, last.GetData()[BUSTUB_PAGE_SIZE - 1]);
+
+  // Scenario: pages outside of a buffer pool still own their data.
+  Page page;
+  EXPECT_NE(nullptr, page.GetData());
+  EXPECT_EQ(0, page.GetData()[0]);
+}
+
+// NOLINTNEXTLINE
+TEST(FrameArenaTest, ResizeTest) {
+  FrameArena arena(4, false, 8);
+  EXPECT_EQ(4, arena.GetNumFrames());
+  EXPECT_EQ(8, arena.GetMaxFrames());
+  EXPECT_GE(arena.GetMappedSize(), 8 * BUSTUB_PAGE_SIZE);
+
+  // Scenario: growing keeps the existing frames in place and lays out the new ones behind them.
+  char *data = arena.GetData();
+  memset(arena.GetPages()[3].GetData(), 3, BUSTUB_PAGE_SIZE);
+  arena.Resize(8);
+  EXPECT_EQ(8, arena.GetNumFrames());
+  EXPECT_EQ(data, arena.GetData());
+  EXPECT_EQ(3, arena.GetPages()[3].GetData()[0]);
+  for (size_t i = 4; i < 8; i++) {
+    EXPECT_EQ(data + i * BUSTUB_PAGE_SIZE, arena.GetPages()[i].GetData());
+    EXPECT_EQ(INVALID_PAGE_ID, arena.GetPages()[i].GetPageId());
+    memset(arena.GetPages()[i].GetData(), 1, BUSTUB_PAGE_SIZE);
+  }
+
+  // Scenario: shrinking keeps the frames in front, and frames can be added again afterwards.
+  arena.Resize(2);
+  EXPECT_EQ(2, arena.GetNumFrames());
+  arena.Resize(6);
+  EXPECT_EQ(6, arena.GetNumFrames());
+  EXPECT_EQ(data + 5 * BUSTUB_PAGE_SIZE, arena.GetPages()[5].GetData());
+
+  // Scenario: an arena that may grow never reserves hugetlb pages for its maximum size.
+  const size_t huge_frames = 2 * FrameArena::HUGE_PAGE_SIZE / BUSTUB_PAGE_SIZE;
+  FrameArena growable(huge_frames / 2, true, huge_frames);
+  EXPECT_NE(FrameArena::Backing::HUGETLB, growable.GetBacking());
+}
+
+// NOLINTNEXTLINE
+TEST(FrameArenaTest, BufferPoolTest) {
+  const size_t buffer_pool_size = 10;
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: the pages handed out by the buffer pool are the frames of its arena.
+  auto *arena = bpm->GetFrameArena();
+  ASSERT_EQ(buffer_pool_size, arena->GetNumFrames());
+  EXPECT_EQ(arena->GetPages(), bpm->GetPages());
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    auto offset = page->GetData() - arena->GetData();
+    EXPECT_EQ(0, offset % BUSTUB_PAGE_SIZE);
+    EXPECT_LT(offset, buffer_pool_size * BUSTUB_PAGE_SIZE);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
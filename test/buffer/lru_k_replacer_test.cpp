@@ -5,6 +5,7 @@
 #include "buffer/lru_k_replacer.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdio>
 #include <memory>
 #include <random>
@@ -97,4 +98,225 @@ TEST(LRUKReplacerTest, SampleTest) {
   lru_replacer.Remove(1);
   ASSERT_EQ(0, lru_replacer.Size());
 }
+
+TEST(LRUKReplacerTest, KDistanceTest) {
+  LRUKReplacer lru_replacer(4, 3);
+
+  // Scenario: frames 0 and 1 have 3 accesses, frame 2 has 2 accesses.
+  // Access order: 0 1 0 1 2 0 1 2. Frame 0's 3rd most recent access is at t=0, frame 1's at t=1.
+  for (frame_id_t frame : {0, 1, 0, 1, 2, 0, 1, 2}) {
+    lru_replacer.RecordAccess(frame);
+  }
+  for (frame_id_t frame = 0; frame < 3; frame++) {
+    lru_replacer.SetEvictable(frame, true);
+  }
+
+  // Scenario: frame 2 has +inf backward k-distance and goes first, then frame 0.
+  int value;
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(2, value);
+
+  // Scenario: another access to frame 0 moves its 3rd most recent access to t=2, behind frame 1.
+  lru_replacer.RecordAccess(0);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(1, value);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(0, value);
+  ASSERT_EQ(false, lru_replacer.Evict(&value));
+
+  // Scenario: an evicted frame starts with an empty history.
+  lru_replacer.RecordAccess(0);
+  lru_replacer.RecordAccess(3);
+  lru_replacer.RecordAccess(3);
+  lru_replacer.RecordAccess(3);
+  lru_replacer.SetEvictable(3, true);
+  lru_replacer.SetEvictable(0, true);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(0, value);
+}
+
+TEST(LRUKReplacerTest, RandomizedTest) {
+  const size_t num_frames = 64;
+  const size_t k = 3;
+  LRUKReplacer lru_replacer(num_frames, k);
+
+  // Reference model: full access history per frame, victim chosen by scanning every frame.
+  std::vector<std::vector<size_t>> history(num_frames);
+  std::vector<bool> evictable(num_frames, false);
+  size_t timestamp = 0;
+  auto expected_victim = [&]() -> frame_id_t {
+    frame_id_t victim = -1;
+    bool victim_inf = false;
+    size_t victim_ts = 0;
+    for (size_t i = 0; i < num_frames; i++) {
+      if (!evictable[i] || history[i].empty()) {
+        continue;
+      }
+      bool inf = history[i].size() < k;
+      size_t ts = inf ? history[i].front() : history[i][history[i].size() - k];
+      if (victim == -1 || (inf && !victim_inf) || (inf == victim_inf && ts < victim_ts)) {
+        victim = static_cast<frame_id_t>(i);
+        victim_inf = inf;
+        victim_ts = ts;
+      }
+    }
+    return victim;
+  };
+
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<frame_id_t> frame_dis(0, num_frames - 1);
+  std::uniform_int_distribution<int> op_dis(0, 9);
+  for (int i = 0; i < 20000; i++) {
+    auto frame = frame_dis(gen);
+    auto op = op_dis(gen);
+    if (op < 6) {
+      lru_replacer.RecordAccess(frame);
+      history[frame].push_back(timestamp++);
+    } else if (op < 9) {
+      bool set_evictable = op != 8;
+      lru_replacer.SetEvictable(frame, set_evictable);
+      if (!history[frame].empty()) {
+        evictable[frame] = set_evictable;
+      }
+    } else {
+      frame_id_t value;
+      auto victim = expected_victim();
+      ASSERT_EQ(victim != -1, lru_replacer.Evict(&value));
+      if (victim != -1) {
+        ASSERT_EQ(victim, value);
+        history[victim].clear();
+        evictable[victim] = false;
+      }
+    }
+    size_t size = 0;
+    for (size_t j = 0; j < num_frames; j++) {
+      size += evictable[j] ? 1 : 0;
+    }
+    ASSERT_EQ(size, lru_replacer.Size());
+  }
+}
+
+TEST(LRUKReplacerTest, BufferedAccessTest) {
+  const size_t num_frames = 64;
+  const size_t k = 3;
+  LRUKReplacer lru_replacer(num_frames, k);
+  std::vector<std::vector<size_t>> history(num_frames);
+  std::vector<bool> evictable(num_frames, false);
+  size_t timestamp = 0;
+
+  // Scenario: bursts of accesses that overflow the access buffer, some of them pins, are applied in order before
+  // the next eviction. Checked against a full history per frame.
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<frame_id_t> frame_dis(0, num_frames - 1);
+  for (int round = 0; round < 200; round++) {
+    int burst = round % 2 == 0 ? 10 : static_cast<int>(2 * AccessBuffer::STRIPE_CAPACITY + 5);
+    for (int i = 0; i < burst; i++) {
+      auto frame = frame_dis(gen);
+      if (i % 5 == 0) {
+        lru_replacer.RecordAccessAndPin(frame, INVALID_PAGE_ID);
+        evictable[frame] = false;
+      } else {
+        lru_replacer.RecordAccess(frame);
+      }
+      history[frame].push_back(timestamp++);
+    }
+    for (int i = 0; i < 8; i++) {
+      auto frame = frame_dis(gen);
+      lru_replacer.SetEvictable(frame, true);
+      evictable[frame] = !history[frame].empty();
+    }
+
+    frame_id_t victim = -1;
+    for (size_t i = 0; i < num_frames; i++) {
+      if (!evictable[i]) {
+        continue;
+      }
+      auto key = [&](size_t f) {
+        bool inf = history[f].size() < k;
+        return std::make_pair(inf ? 0 : 1, inf ? history[f].front() : history[f][history[f].size() - k]);
+      };
+      if (victim == -1 || key(i) < key(victim)) {
+        victim = static_cast<frame_id_t>(i);
+      }
+    }
+    frame_id_t value;
+    ASSERT_EQ(victim != -1, lru_replacer.Evict(&value));
+    if (victim != -1) {
+      ASSERT_EQ(victim, value);
+      history[victim].clear();
+      evictable[victim] = false;
+    }
+  }
+}
+
+TEST(LRUKReplacerTest, AccessHistoryTest) {
+  LRUKReplacer lru_replacer(4, 2);
+
+  // Scenario: frame 0 is accessed three times, frame 1 once. Only the last k accesses are kept.
+  lru_replacer.RecordAccess(0);
+  lru_replacer.RecordAccess(0);
+  lru_replacer.RecordAccess(0);
+  lru_replacer.RecordAccess(1);
+  EXPECT_EQ(std::vector<uint64_t>({1, 2}), lru_replacer.GetAccessHistory(0));
+  EXPECT_EQ(std::vector<uint64_t>({3}), lru_replacer.GetAccessHistory(1));
+  EXPECT_TRUE(lru_replacer.GetAccessHistory(2).empty());
+
+  // Scenario: the histories are restored into another replacer, in other frames. A frame without history counts as
+  // accessed now, and a frame that was accessed in the meantime keeps its own history.
+  LRUKReplacer restored(4, 2);
+  restored.RestoreAccessHistory(3, 0, lru_replacer.GetAccessHistory(0));
+  restored.RestoreAccessHistory(2, 1, lru_replacer.GetAccessHistory(1));
+  restored.RestoreAccessHistory(1, 2, {});
+  restored.RecordAccess(0);
+  restored.RestoreAccessHistory(0, 3, {0, 1});
+  EXPECT_EQ(std::vector<uint64_t>({4}), restored.GetAccessHistory(1));
+  EXPECT_EQ(std::vector<uint64_t>({5}), restored.GetAccessHistory(0));
+
+  // Scenario: restored frames are pinned until they are made evictable, then evicted as if nothing happened.
+  EXPECT_EQ(0, restored.Size());
+  for (frame_id_t i = 0; i < 4; i++) {
+    restored.SetEvictable(i, true);
+  }
+  frame_id_t value;
+  for (frame_id_t expected : {2, 1, 0, 3}) {
+    ASSERT_TRUE(restored.Evict(&value));
+    EXPECT_EQ(expected, value);
+  }
+}
+
+TEST(LRUKReplacerTest, ConcurrentAccessTest) {
+  const size_t num_threads = 8;
+  const size_t frames_per_thread = 32;
+  LRUKReplacer lru_replacer(num_threads * frames_per_thread, 2);
+
+  // Scenario: every thread pins and unpins its own frames while the main thread keeps looking at the replacer.
+  // No access gets lost, so in the end every frame is evictable exactly once.
+  std::atomic<size_t> running{num_threads};
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid] {
+      for (int i = 0; i < 20000; i++) {
+        auto frame = static_cast<frame_id_t>(tid * frames_per_thread + i % frames_per_thread);
+        lru_replacer.RecordAccessAndPin(frame, INVALID_PAGE_ID);
+        lru_replacer.RecordAccess(frame);
+        lru_replacer.SetEvictable(frame, true);
+      }
+      running--;
+    });
+  }
+  while (running > 0) {
+    ASSERT_LE(lru_replacer.Size(), num_threads * frames_per_thread);
+    lru_replacer.GetEvictionCandidates(4);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(num_threads * frames_per_thread, lru_replacer.Size());
+  std::set<frame_id_t> evicted;
+  frame_id_t value;
+  while (lru_replacer.Evict(&value)) {
+    ASSERT_TRUE(evicted.insert(value).second);
+  }
+  EXPECT_EQ(num_threads * frames_per_thread, evicted.size());
+}
 }  // namespace bustub
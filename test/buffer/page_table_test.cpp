@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table_test.cpp
+//
+// Identification: test/buffer/page_table_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_table.h"
+
+#include <random>
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(PageTableTest, SampleTest) {
+  PageTable page_table(10);
+  frame_id_t frame_id;
+
+  // Scenario: an empty table finds nothing.
+  EXPECT_FALSE(page_table.Find(0, frame_id));
+  EXPECT_FALSE(page_table.Remove(0));
+
+  // Scenario: insert and find pages.
+  for (page_id_t page_id = 0; page_id < 10; ++page_id) {
+    page_table.Insert(page_id, page_id + 100);
+  }
+  EXPECT_EQ(10, page_table.Size());
+  for (page_id_t page_id = 0; page_id < 10; ++page_id) {
+    ASSERT_TRUE(page_table.Find(page_id, frame_id));
+    EXPECT_EQ(page_id + 100, frame_id);
+  }
+  EXPECT_FALSE(page_table.Find(10, frame_id));
+
+  // Scenario: inserting a page again replaces its frame.
+  page_table.Insert(3, 7);
+  EXPECT_EQ(10, page_table.Size());
+  ASSERT_TRUE(page_table.Find(3, frame_id));
+  EXPECT_EQ(7, frame_id);
+
+  // Scenario: removed pages are gone, the others are still found.
+  EXPECT_TRUE(page_table.Remove(3));
+  EXPECT_FALSE(page_table.Remove(3));
+  EXPECT_FALSE(page_table.Find(3, frame_id));
+  EXPECT_EQ(9, page_table.Size());
+  for (page_id_t page_id = 0; page_id < 10; ++page_id) {
+    EXPECT_EQ(page_id != 3, page_table.Find(page_id, frame_id));
+  }
+
+  // Scenario: the table grows beyond the expected size.
+  for (page_id_t page_id = 10; page_id < 1000; ++page_id) {
+    page_table.Insert(page_id, page_id);
+  }
+  EXPECT_EQ(999, page_table.Size());
+  for (page_id_t page_id = 10; page_id < 1000; ++page_id) {
+    ASSERT_TRUE(page_table.Find(page_id, frame_id));
+    EXPECT_EQ(page_id, frame_id);
+  }
+
+  // Scenario: the pages of one instance of a parallel buffer pool share their low bits.
+  PageTable strided_table(64);
+  for (page_id_t page_id = 3; page_id < 8 * 1000; page_id += 8) {
+    strided_table.Insert(page_id, page_id);
+  }
+  EXPECT_EQ(1000, strided_table.Size());
+  for (page_id_t page_id = 0; page_id < 8 * 1000; ++page_id) {
+    ASSERT_EQ(page_id % 8 == 3, strided_table.Find(page_id, frame_id));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(PageTableTest, RandomizedTest) {
+  // Scenario: a buffer-pool-like mix of inserts and removes over a small key range, so that probe runs wrap around
+  // and get shifted back all the time. The table must agree with std::unordered_map after every step.
+  PageTable page_table(64);
+  std::unordered_map<page_id_t, frame_id_t> expected;
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<page_id_t> page_dis(0, 255);
+  frame_id_t frame_id;
+  for (int i = 0; i < 100000; ++i) {
+    auto page_id = page_dis(gen);
+    if (gen() % 2 == 0 && expected.size() < 64) {
+      page_table.Insert(page_id, i);
+      expected[page_id] = i;
+    } else {
+      EXPECT_EQ(expected.erase(page_id) == 1, page_table.Remove(page_id));
+    }
+    if (i % 1000 == 0) {
+      ASSERT_EQ(expected.size(), page_table.Size());
+      for (page_id_t probe = 0; probe < 256; ++probe) {
+        auto it = expected.find(probe);
+        ASSERT_EQ(it != expected.end(), page_table.Find(probe, frame_id));
+        if (it != expected.end()) {
+          ASSERT_EQ(it->second, frame_id);
+        }
+      }
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(PageTableTest, ConcurrencyTest) {
+  const int num_threads = 8;
+  const page_id_t pages_per_thread = 1000;
+
+  // Scenario: every thread churns through its own pages while the others do the same.
+  PageTable page_table(num_threads * pages_per_thread / 2);
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([&page_table, tid]() {
+      page_id_t first = tid * pages_per_thread;
+      frame_id_t frame_id;
+      for (int round = 0; round < 10; ++round) {
+        for (page_id_t page_id = first; page_id < first + pages_per_thread; ++page_id) {
+          page_table.Insert(page_id, page_id + round);
+        }
+        for (page_id_t page_id = first; page_id < first + pages_per_thread; ++page_id) {
+          ASSERT_TRUE(page_table.Find(page_id, frame_id));
+          ASSERT_EQ(page_id + round, frame_id);
+          if (page_id % 2 == round % 2) {
+            ASSERT_TRUE(page_table.Remove(page_id));
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(num_threads * pages_per_thread / 2, page_table.Size());
+}
+
+}  // namespace bustub
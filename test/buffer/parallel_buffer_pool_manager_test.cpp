@@ -0,0 +1,239 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager_test.cpp
+//
+// Identification: test/buffer/parallel_buffer_pool_manager_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <cstdio>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, SampleTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 5;
+  const size_t num_instances = 5;
+  const size_t k = 5;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager, k);
+  EXPECT_EQ(buffer_pool_size * num_instances, bpm->GetPoolSize());
+
+  page_id_t page_id_temp;
+  auto *page0 = bpm->NewPage(&page_id_temp);
+
+  // Scenario: The buffer pool is empty. We should be able to create a new page.
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, page_id_temp);
+
+  // Scenario: Once we have a page, we should be able to read and write content.
+  snprintf(page0->GetData(), BUSTUB_PAGE_SIZE, "Hello");
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+
+  // Scenario: We should be able to create new pages until we fill up the buffer pool. Allocation is round robin, so
+  // every page id maps back to the instance that created it.
+  for (size_t i = 1; i < buffer_pool_size * num_instances; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(page, bpm->GetBufferPoolManager(page_id_temp)->FetchPage(page_id_temp));
+    EXPECT_TRUE(bpm->GetBufferPoolManager(page_id_temp)->UnpinPage(page_id_temp, false));
+  }
+
+  // Scenario: Once the buffer pool is full, we should not be able to create any new pages.
+  for (size_t i = 0; i < buffer_pool_size * num_instances; ++i) {
+    EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+  }
+
+  // Scenario: Every shard was filled evenly.
+  for (size_t i = 0; i < num_instances; ++i) {
+    EXPECT_EQ(buffer_pool_size, bpm->GetInstanceStats(i).new_pages_);
+  }
+
+  // Scenario: After unpinning pages {1, 2, 3, 4}, each of the instances 1-4 has one evictable frame, so we should be
+  // able to create 4 new pages. Page 0 stays pinned in instance 0.
+  for (int i = 1; i < 5; ++i) {
+    EXPECT_EQ(true, bpm->UnpinPage(i, true));
+  }
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+
+  // Scenario: We should be able to fetch the data we wrote a while ago.
+  EXPECT_EQ(true, bpm->UnpinPage(0, true));
+  page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+  EXPECT_EQ(true, bpm->UnpinPage(0, true));
+
+  // Scenario: The aggregated counters are the sum of the per-shard counters.
+  auto stats = bpm->GetStats();
+  EXPECT_EQ(buffer_pool_size * num_instances + 4, stats.new_pages_);
+  EXPECT_EQ(4, stats.evictions_);
+  EXPECT_EQ(4, stats.write_backs_);
+  uint64_t hits = 0;
+  for (size_t i = 0; i < num_instances; ++i) {
+    hits += bpm->GetInstanceStats(i).hits_;
+  }
+  EXPECT_EQ(stats.hits_, hits);
+
+  // Shutdown the disk manager and remove the temporary file we created.
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, ConcurrencyTest) {
+  const size_t num_threads = 8;
+  const size_t num_instances = 4;
+  const size_t buffer_pool_size = 50;
+  const size_t rounds = 100;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&bpm]() {
+      page_id_t page_id_temp;
+      std::vector<page_id_t> page_ids;
+      for (size_t i = 0; i < rounds; i++) {
+        auto *page = bpm->NewPage(&page_id_temp);
+        ASSERT_NE(nullptr, page);
+        snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+        page_ids.push_back(page_id_temp);
+        EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+      }
+      for (auto page_id : page_ids) {
+        auto *page = bpm->FetchPage(page_id);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+        EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(num_threads * rounds, bpm->GetStats().new_pages_);
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, ResizeTest) {
+  const size_t num_instances = 4;
+  const size_t buffer_pool_size = 5;
+  const size_t max_pool_size = 10;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager, LRUK_REPLACER_K, nullptr,
+                                            max_pool_size);
+
+  // Scenario: the new size is spread over the instances, the first ones take the remainder.
+  ASSERT_TRUE(bpm->Resize(30));
+  EXPECT_EQ(30, bpm->GetPoolSize());
+  EXPECT_EQ(8, bpm->GetBufferPoolManager(0)->GetPoolSize());
+  EXPECT_EQ(8, bpm->GetBufferPoolManager(1)->GetPoolSize());
+  EXPECT_EQ(7, bpm->GetBufferPoolManager(2)->GetPoolSize());
+  EXPECT_EQ(7, bpm->GetBufferPoolManager(3)->GetPoolSize());
+
+  // Scenario: nothing changes if a share is out of range for its instance.
+  EXPECT_FALSE(bpm->Resize(num_instances * max_pool_size + 1));
+  EXPECT_FALSE(bpm->Resize(num_instances - 1));
+  EXPECT_EQ(30, bpm->GetPoolSize());
+
+  ASSERT_TRUE(bpm->Resize(num_instances));
+  EXPECT_EQ(num_instances, bpm->GetPoolSize());
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, FetchPagesTest) {
+  const size_t num_instances = 4;
+  const size_t buffer_pool_size = 5;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < num_instances * buffer_pool_size * 2; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: the pages of one call are spread over all instances and come back in the order they were asked for.
+  std::vector<page_id_t> page_ids{9, 2, 31, 4, 16, 7, 2};
+  std::vector<Page *> pages;
+  ASSERT_EQ(page_ids.size(), bpm->FetchPages(page_ids, &pages));
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    ASSERT_NE(nullptr, pages[i]);
+    EXPECT_EQ(std::to_string(page_ids[i]), std::string(pages[i]->GetData()));
+  }
+  EXPECT_EQ(2, pages[1]->GetPinCount());
+  EXPECT_EQ(page_ids.size(), bpm->UnpinPages(page_ids, false));
+  EXPECT_EQ(0, pages[1]->GetPinCount());
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, NewPageNearTest) {
+  const size_t num_instances = 4;
+  const size_t buffer_pool_size = 5;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < num_instances * 2; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: without a free page to reuse, pages created near the same hint are spread over all instances.
+  for (size_t i = 0; i < num_instances; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPageNear(&page_id_temp, 5));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+  for (size_t i = 0; i < num_instances; ++i) {
+    EXPECT_EQ(3, bpm->GetInstanceStats(i).new_pages_);
+  }
+
+  // Scenario: the free page closest to the hint is reused, whichever instance owns it.
+  EXPECT_TRUE(bpm->DeletePage(6));
+  EXPECT_TRUE(bpm->DeletePage(1));
+  ASSERT_NE(nullptr, bpm->NewPageNear(&page_id_temp, 4));
+  EXPECT_EQ(6, page_id_temp);
+  EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  ASSERT_NE(nullptr, bpm->NewPageNear(&page_id_temp, 4));
+  EXPECT_EQ(1, page_id_temp);
+  EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tiny_lfu_replacer_test.cpp
+//
+// Identification: test/buffer/tiny_lfu_replacer_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/tiny_lfu_replacer.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TinyLFUReplacerTest, SketchTest) {
+  FrequencySketch sketch(16);
+
+  // Scenario: counters saturate, and pages that were never seen have no frequency.
+  for (int i = 0; i < 20; i++) {
+    sketch.Increment(1);
+  }
+  sketch.Increment(2);
+  sketch.Increment(2);
+  EXPECT_EQ(FrequencySketch::MAX_COUNT, sketch.Frequency(1));
+  EXPECT_EQ(2, sketch.Frequency(2));
+  EXPECT_EQ(0, sketch.Frequency(3));
+
+  // Scenario: after a sample of ten accesses per frame, old popularity fades out.
+  for (page_id_t page_id = 1000; page_id < 1160; page_id++) {
+    sketch.Increment(page_id);
+  }
+  EXPECT_LE(sketch.Frequency(1), FrequencySketch::MAX_COUNT / 2 + 1);
+}
+
+// NOLINTNEXTLINE
+TEST(TinyLFUReplacerTest, SampleTest) {
+  // 10 frames: a window of 1 frame, a main region of 9 frames of which up to 7 are protected.
+  TinyLFUReplacer replacer(10);
+  frame_id_t frame_id;
+
+  // Scenario: pages 0 to 9 are brought into frames 0 to 9, and pages 0 to 4 are accessed three more times.
+  for (frame_id_t i = 0; i < 10; i++) {
+    replacer.RecordAccess(i, i);
+    replacer.SetEvictable(i, true);
+  }
+  for (int round = 0; round < 3; round++) {
+    for (frame_id_t i = 0; i < 5; i++) {
+      replacer.RecordAccess(i, i);
+    }
+  }
+  ASSERT_EQ(10, replacer.Size());
+
+  // Scenario: all but the most recent page leave the window for the main region. The last one, page 4, is more
+  // popular than page 5 at the LRU end of probation, so page 5 is evicted and page 4 admitted.
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(5, frame_id);
+
+  // Scenario: a page seen once loses against page 6, which was seen once as well; it is evicted right away.
+  replacer.RecordAccess(5, 100);
+  replacer.SetEvictable(5, true);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(5, frame_id);
+
+  // Scenario: a page that turns out to be popular while in the window is admitted.
+  for (int i = 0; i < 5; i++) {
+    replacer.RecordAccess(5, 200);
+  }
+  replacer.SetEvictable(5, true);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(6, frame_id);
+
+  // Scenario: a hit in probation protects the page; the window is empty, so probation is evicted in LRU order.
+  replacer.RecordAccess(7, 7);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(8, frame_id);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(9, frame_id);
+
+  // Scenario: pinned frames are never evicted.
+  replacer.SetEvictable(0, false);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(1, frame_id);
+  EXPECT_EQ(5, replacer.Size());
+  replacer.Remove(2);
+  EXPECT_EQ(4, replacer.Size());
+}
+
+// NOLINTNEXTLINE
+TEST(TinyLFUReplacerTest, ScanResistanceTest) {
+  const size_t num_frames = 100;
+  TinyLFUReplacer replacer(num_frames);
+  frame_id_t frame_id;
+
+  // Scenario: pages 0 to 98 are hot and the last frame holds a cold page.
+  std::vector<page_id_t> frame_pages(num_frames);
+  for (frame_id_t i = 0; i < static_cast<frame_id_t>(num_frames); i++) {
+    frame_pages[i] = i;
+    replacer.RecordAccess(i, i);
+    replacer.SetEvictable(i, true);
+  }
+  for (int round = 0; round < 3; round++) {
+    for (frame_id_t i = 0; i < static_cast<frame_id_t>(num_frames) - 1; i++) {
+      replacer.RecordAccess(i, i);
+    }
+  }
+
+  // Scenario: a long scan runs through the buffer while the hot pages keep being used. Scanned pages are seen once
+  // and almost never win the admission duel, only sketch collisions can let one in.
+  const page_id_t first_scan_page = 1000;
+  page_id_t next_page_id = first_scan_page;
+  size_t hot_evictions = 0;
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_TRUE(replacer.Evict(&frame_id));
+    hot_evictions += frame_pages[frame_id] < static_cast<page_id_t>(num_frames) - 1 ? 1 : 0;
+    frame_pages[frame_id] = next_page_id;
+    replacer.RecordAccess(frame_id, next_page_id++);
+    replacer.SetEvictable(frame_id, true);
+    auto hot_frame = static_cast<frame_id_t>(i % num_frames);
+    if (frame_pages[hot_frame] < first_scan_page) {
+      replacer.RecordAccess(hot_frame, frame_pages[hot_frame]);
+    }
+  }
+  EXPECT_LE(hot_evictions, 10);
+  EXPECT_EQ(num_frames, replacer.Size());
+}
+
+}  // namespace bustub
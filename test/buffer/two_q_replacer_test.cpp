@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_q_replacer_test.cpp
+//
+// Identification: test/buffer/two_q_replacer_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/two_q_replacer.h"
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TwoQReplacerTest, SampleTest) {
+  // 8 frames: A1in may keep 2 of them, A1out remembers 4 pages.
+  TwoQReplacer replacer(8);
+  frame_id_t frame_id;
+
+  // Scenario: pages 1 to 8 are brought into frames 0 to 7 and enter A1in. The hit on page 1 is a correlated
+  // reference and does not save it from being the first victim.
+  for (frame_id_t i = 0; i < 8; i++) {
+    replacer.RecordAccess(i, i + 1);
+    replacer.SetEvictable(i, true);
+  }
+  replacer.RecordAccess(0, 1);
+  ASSERT_EQ(8, replacer.Size());
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(0, frame_id);
+
+  // Scenario: page 1 comes back while it is in A1out and enters Am. A1in is still over its share.
+  replacer.RecordAccess(0, 1);
+  replacer.SetEvictable(0, true);
+  for (frame_id_t expected = 1; expected <= 5; expected++) {
+    ASSERT_TRUE(replacer.Evict(&frame_id));
+    EXPECT_EQ(expected, frame_id);
+  }
+  EXPECT_EQ(3, replacer.Size());
+
+  // Scenario: A1in is down to its share, so Am is evicted from now on.
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(0, frame_id);
+
+  // Scenario: A1out only remembers the last 4 pages evicted from A1in (3 to 6). Page 2 is new again and enters A1in,
+  // page 3 goes to Am. Am is only evicted from once A1in is down to its share.
+  replacer.RecordAccess(1, 2);
+  replacer.SetEvictable(1, true);
+  replacer.RecordAccess(2, 3);
+  replacer.SetEvictable(2, true);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(6, frame_id);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(2, frame_id);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(7, frame_id);
+
+  // Scenario: pinned frames are never evicted.
+  replacer.SetEvictable(1, false);
+  EXPECT_FALSE(replacer.Evict(&frame_id));
+  EXPECT_EQ(0, replacer.Size());
+  replacer.SetEvictable(1, true);
+  replacer.Remove(1);
+  EXPECT_EQ(0, replacer.Size());
+}
+
+// NOLINTNEXTLINE
+TEST(TwoQReplacerTest, ScanResistanceTest) {
+  const size_t num_frames = 8;
+  TwoQReplacer replacer(num_frames);
+  frame_id_t frame_id;
+
+  // Scenario: pages 0 and 1 were evicted once and came back, so they sit in Am.
+  for (frame_id_t i = 0; i < static_cast<frame_id_t>(num_frames); i++) {
+    replacer.RecordAccess(i, i);
+    replacer.SetEvictable(i, true);
+  }
+  for (page_id_t page_id = 0; page_id < 2; page_id++) {
+    ASSERT_TRUE(replacer.Evict(&frame_id));
+    replacer.RecordAccess(frame_id, page_id);
+    replacer.SetEvictable(frame_id, true);
+  }
+
+  // Scenario: a long scan only ever evicts its own pages from A1in.
+  page_id_t next_page_id = 100;
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_TRUE(replacer.Evict(&frame_id));
+    ASSERT_GE(frame_id, 2);
+    replacer.RecordAccess(frame_id, next_page_id++);
+    replacer.SetEvictable(frame_id, true);
+  }
+  EXPECT_EQ(num_frames, replacer.Size());
+}
+
+}  // namespace bustub
@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// crc32c_test.cpp
+//
+// Identification: test/common/crc32c_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/util/crc32c.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(Crc32cTest, KnownValuesTest) {
+  // Scenario: the check value of CRC-32C, and the test vectors of RFC 3720 (iSCSI), section B.4.
+  const std::string check = "123456789";
+  EXPECT_EQ(0xe3069283, Crc32c::Compute(check.data(), check.size()));
+  EXPECT_EQ(0xe3069283, Crc32c::ExtendSoftware(0, check.data(), check.size()));
+
+  std::vector<char> data(32, 0);
+  EXPECT_EQ(0x8a9136aa, Crc32c::Compute(data.data(), data.size()));
+  data.assign(32, static_cast<char>(0xff));
+  EXPECT_EQ(0x62a8ab43, Crc32c::Compute(data.data(), data.size()));
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<char>(i);
+  }
+  EXPECT_EQ(0x46dd794e, Crc32c::Compute(data.data(), data.size()));
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<char>(31 - i);
+  }
+  EXPECT_EQ(0x113fdb5c, Crc32c::Compute(data.data(), data.size()));
+
+  EXPECT_EQ(0, Crc32c::Compute(nullptr, 0));
+}
+
+// NOLINTNEXTLINE
+TEST(Crc32cTest, HardwareMatchesSoftwareTest) {
+  std::mt19937 gen(15445);
+  std::vector<char> data(3 * 8192 * 2 + 1000);
+  for (auto &byte : data) {
+    byte = static_cast<char>(gen());
+  }
+  // Scenario: every path of the three-stream loop, at every alignment of the start and the end.
+  for (size_t size : {0, 1, 7, 8, 255, 4079, 4080, 4084, 4096, 3 * 8192, 3 * 8192 + 777, 3 * 8192 * 2 + 999}) {
+    for (size_t offset = 0; offset < 8; offset++) {
+      SCOPED_TRACE("size " + std::to_string(size) + " offset " + std::to_string(offset));
+      EXPECT_EQ(Crc32c::ExtendSoftware(0, data.data() + offset, size), Crc32c::Compute(data.data() + offset, size));
+    }
+  }
+
+  // Scenario: extending the CRC of a prefix gives the CRC of the whole.
+  auto whole = Crc32c::Compute(data.data(), 5000);
+  for (size_t split : {0, 1, 8, 12, 4096, 5000}) {
+    EXPECT_EQ(whole, Crc32c::Extend(Crc32c::Compute(data.data(), split), data.data() + split, 5000 - split));
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lz_compressor_test.cpp
+//
+// Identification: test/common/lz_compressor_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/util/lz_compressor.h"
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+namespace {
+/** Compress and decompress data; the round trip must give it back. Returns the compressed size. */
+auto RoundTrip(const std::vector<char> &data) -> size_t {
+  std::vector<char> compressed(data.size() * 2 + 16);
+  size_t size = LZCompressor::Compress(data.data(), data.size(), compressed.data(), compressed.size());
+  EXPECT_GT(size, 0);
+  std::vector<char> decompressed(data.size());
+  EXPECT_EQ(data.size(), LZCompressor::Decompress(compressed.data(), size, decompressed.data(), decompressed.size()));
+  EXPECT_EQ(data, decompressed);
+  return size;
+}
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(LZCompressorTest, RoundTripTest) {
+  // Scenario: an empty page compresses to almost nothing, a length byte per 255 bytes of match.
+  std::vector<char> page(BUSTUB_PAGE_SIZE, 0);
+  EXPECT_LT(RoundTrip(page), BUSTUB_PAGE_SIZE / 64);
+
+  // Scenario: a page of similar records with a free-space gap, like a table page.
+  std::mt19937 gen(15445);
+  for (size_t offset = 0; offset + 64 < BUSTUB_PAGE_SIZE / 2; offset += 64) {
+    auto record = "id=" + std::to_string(offset / 64) + " name=customer#" + std::to_string(gen() % 1000) + " state=NY";
+    memcpy(page.data() + offset, record.data(), record.size());
+  }
+  EXPECT_LT(RoundTrip(page), BUSTUB_PAGE_SIZE / 3);
+
+  // Scenario: random bytes do not compress, but still make the round trip given room.
+  for (auto &byte : page) {
+    byte = static_cast<char>(gen());
+  }
+  EXPECT_GT(RoundTrip(page), BUSTUB_PAGE_SIZE);
+
+  // Scenario: long literal runs and long matches need length continuation bytes.
+  std::vector<char> data(300, 'a');
+  for (size_t i = 0; i < 300; i++) {
+    data.push_back(static_cast<char>(gen()));
+  }
+  RoundTrip(data);
+  RoundTrip({'x'});
+}
+
+// NOLINTNEXTLINE
+TEST(LZCompressorTest, BoundsTest) {
+  std::vector<char> page(BUSTUB_PAGE_SIZE);
+  std::mt19937 gen(15445);
+  for (auto &byte : page) {
+    byte = static_cast<char>(gen() % 4);
+  }
+  std::vector<char> compressed(BUSTUB_PAGE_SIZE * 2);
+  size_t size = LZCompressor::Compress(page.data(), page.size(), compressed.data(), compressed.size());
+  ASSERT_GT(size, 0);
+
+  // Scenario: output that does not fit is refused instead of overflowing.
+  EXPECT_EQ(0, LZCompressor::Compress(page.data(), page.size(), compressed.data(), size / 2));
+  std::vector<char> decompressed(BUSTUB_PAGE_SIZE);
+  EXPECT_EQ(0, LZCompressor::Decompress(compressed.data(), size, decompressed.data(), BUSTUB_PAGE_SIZE / 2));
+
+  // Scenario: truncated or damaged input never reads or writes out of bounds.
+  for (size_t cut = 1; cut < size; cut += 97) {
+    EXPECT_LE(LZCompressor::Decompress(compressed.data(), cut, decompressed.data(), decompressed.size()),
+              BUSTUB_PAGE_SIZE);
+  }
+  for (int i = 0; i < 100; i++) {
+    auto damaged = compressed;
+    damaged[gen() % size] ^= static_cast<char>(1 + gen() % 255);
+    EXPECT_LE(LZCompressor::Decompress(damaged.data(), size, decompressed.data(), decompressed.size()),
+              BUSTUB_PAGE_SIZE);
+  }
+}
+
+}  // namespace bustub
@@ -16,6 +16,7 @@
 #include "buffer/buffer_pool_manager_instance.h"
 #include "common/logger.h"
 #include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
 #include "storage/index/b_plus_tree.h"
 #include "test_util.h"  // NOLINT
 
@@ -195,4 +196,51 @@ TEST(BPlusTreeTests, InsertTest3) {
   remove("test.db");
   remove("test.log");
 }
+TEST(BPlusTreeTests, FullPageTest) {
+  // A leaf of the default size fills a whole page of the configured size, and splits when it is full.
+  using LeafPage = BPlusTreeLeafPage<GenericKey<64>, RID, GenericComparator<64>>;
+  const int leaf_max_size = (BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<GenericKey<64>, RID>);
+  ASSERT_GE(leaf_max_size, BUSTUB_PAGE_SIZE / 80);
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<64> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  BPlusTree<GenericKey<64>, RID, GenericComparator<64>> tree("foo_pk", bpm, comparator);
+  GenericKey<64> index_key;
+  auto *transaction = new Transaction(0);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  ASSERT_EQ(page_id, HEADER_PAGE_ID);
+
+  for (int64_t key = 0; key < leaf_max_size - 1; key++) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, static_cast<uint32_t>(key)), transaction);
+  }
+  auto root_page_id = tree.GetRootPageId();
+  auto *root = reinterpret_cast<LeafPage *>(bpm->FetchPage(root_page_id)->GetData());
+  ASSERT_TRUE(root->IsLeafPage());
+  EXPECT_EQ(leaf_max_size, root->GetMaxSize());
+  EXPECT_EQ(leaf_max_size - 1, root->GetSize());
+  bpm->UnpinPage(root_page_id, false);
+
+  index_key.SetFromInteger(leaf_max_size - 1);
+  tree.Insert(index_key, RID(0, static_cast<uint32_t>(leaf_max_size - 1)), transaction);
+  root_page_id = tree.GetRootPageId();
+  EXPECT_FALSE(reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(root_page_id)->GetData())->IsLeafPage());
+  bpm->UnpinPage(root_page_id, false);
+
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < leaf_max_size; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.GetValue(index_key, &rids));
+    EXPECT_EQ(key, rids[0].GetSlotNum());
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+  delete disk_manager;
+}
 }  // namespace bustub
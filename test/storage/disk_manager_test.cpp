@@ -10,25 +10,50 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <sys/stat.h>
+#include <unistd.h>
+#include <chrono>  // NOLINT
+#include <cstdint>
 #include <cstring>
+#include <fstream>
+#include <functional>
+#include <future>  // NOLINT
+#include <memory>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "common/exception.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_compressed.h"
+#include "storage/disk/disk_manager_simulated.h"
 
 namespace bustub {
 
+namespace {
+/** @return the page as it reads back once it was written as page_id, with the checksum the write filled in */
+auto Stamped(page_id_t page_id, std::vector<char> page) -> std::vector<char> {
+  DiskManager::StampChecksum(page_id, page.data());
+  return page;
+}
+}  // namespace
+
 class DiskManagerTest : public ::testing::Test {
  protected:
   // This function is called before every test.
   void SetUp() override {
     remove("test.db");
+    remove("test.db.free");
+    remove("test.db.extents");
     remove("test.log");
   }
 
   // This function is called after every test.
   void TearDown() override {
     remove("test.db");
+    remove("test.db.free");
+    remove("test.db.extents");
     remove("test.log");
   };
 };
@@ -45,13 +70,623 @@ TEST_F(DiskManagerTest, ReadWritePageTest) {
 
   dm.WritePage(0, data);
   dm.ReadPage(0, buf);
+  // The page reads back with the checksum the write filled in.
+  DiskManager::StampChecksum(0, data);
   EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
 
   std::memset(buf, 0, sizeof(buf));
   dm.WritePage(5, data);
   dm.ReadPage(5, buf);
+  DiskManager::StampChecksum(5, data);
   EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
 
+  // Scenario: an invalid page id is an I/O error, not a page far beyond the end of the file.
+  uint64_t errors = DiskManager::GetThreadIOErrors();
+  dm.ReadPage(INVALID_PAGE_ID, buf);
+  dm.WritePage(INVALID_PAGE_ID, data);
+  EXPECT_FALSE(dm.ReadPageAsync(INVALID_PAGE_ID, buf).get());
+  EXPECT_FALSE(dm.WritePageAsync(INVALID_PAGE_ID, data).get());
+  EXPECT_EQ(errors + 4, DiskManager::GetThreadIOErrors());
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, ConcurrentReadWritePageTest) {
+  const int num_threads = 4;
+  const int pages_per_thread = 64;
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file);
+
+  // Scenario: every thread writes and reads back its own pages, interleaved with the other threads.
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&dm, tid]() {
+      char data[BUSTUB_PAGE_SIZE];
+      char buf[BUSTUB_PAGE_SIZE];
+      for (int i = 0; i < pages_per_thread; i++) {
+        page_id_t page_id = i * num_threads + tid;
+        std::memset(data, page_id, sizeof(data));
+        dm.WritePage(page_id, data);
+        dm.ReadPage(page_id, buf);
+        DiskManager::StampChecksum(page_id, data);
+        EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  dm.Sync();
+  EXPECT_EQ(num_threads * pages_per_thread, dm.GetNumWrites());
+
+  // Scenario: a run of pages that reaches past the end of the file reads as zeros there.
+  const page_id_t num_pages = num_threads * pages_per_thread;
+  std::vector<std::vector<char>> run(4, std::vector<char>(BUSTUB_PAGE_SIZE, 1));
+  std::vector<char *> run_pages;
+  for (auto &page : run) {
+    run_pages.push_back(page.data());
+  }
+  dm.ReadPages(num_pages - 2, run_pages.data(), run_pages.size());
+  EXPECT_EQ(static_cast<char>(num_pages - 2), run[0][0]);
+  EXPECT_EQ(static_cast<char>(num_pages - 1), run[1][BUSTUB_PAGE_SIZE - 1]);
+  EXPECT_EQ(0, run[2][0]);
+  EXPECT_EQ(0, run[3][BUSTUB_PAGE_SIZE - 1]);
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, AsyncReadWritePageTest) {
+  const int num_pages = 256;
+  std::string db_file("test.db");
+  for (bool thread_pool : {false, true}) {
+    remove("test.db");
+    auto dm = DiskManager(db_file);
+    if (thread_pool) {
+      dm.SetIOEngine(std::make_unique<ThreadPoolIOEngine>(&dm, 4));
+    }
+
+    // Scenario: write many pages with all requests in flight at once.
+    std::vector<std::vector<char>> data(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+    std::vector<std::future<bool>> requests;
+    for (int i = 0; i < num_pages; i++) {
+      std::memset(data[i].data(), i, BUSTUB_PAGE_SIZE);
+      requests.push_back(dm.WritePageAsync(i, data[i].data()));
+    }
+    for (auto &request : requests) {
+      EXPECT_TRUE(request.get());
+    }
+    EXPECT_EQ(num_pages, dm.GetNumWrites());
+
+    // Scenario: read them back the same way, plus a page past the end of the file, which reads as zeros.
+    std::vector<std::vector<char>> buf(num_pages + 1, std::vector<char>(BUSTUB_PAGE_SIZE, 1));
+    requests.clear();
+    for (int i = 0; i <= num_pages; i++) {
+      requests.push_back(dm.ReadPageAsync(i, buf[i].data()));
+    }
+    for (auto &request : requests) {
+      EXPECT_TRUE(request.get());
+    }
+    for (int i = 0; i < num_pages; i++) {
+      EXPECT_EQ(Stamped(i, data[i]), buf[i]) << dm.GetIOEngine()->GetName() << " page " << i;
+    }
+    EXPECT_EQ(std::vector<char>(BUSTUB_PAGE_SIZE, 0), buf[num_pages]);
+
+    dm.ShutDown();
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, DirectIOTest) {
+  std::string db_file("test.db");
+  // Falls back to buffered I/O where the file system refuses O_DIRECT, which the scenarios below do not notice.
+  auto dm = DiskManager(db_file, true);
+  std::vector<char> storage(3 * BUSTUB_PAGE_SIZE + DIRECT_IO_ALIGNMENT);
+  auto misalignment = reinterpret_cast<uintptr_t>(storage.data()) % DIRECT_IO_ALIGNMENT;
+  char *aligned = storage.data() + (DIRECT_IO_ALIGNMENT - misalignment);
+  char *unaligned = aligned + BUSTUB_PAGE_SIZE + 1;
+  char *buf = aligned + 2 * BUSTUB_PAGE_SIZE;
+
+  // Scenario: aligned buffers are transferred in place, unaligned ones through a bounce buffer.
+  std::memset(aligned, 'a', BUSTUB_PAGE_SIZE);
+  std::memset(unaligned, 'u', BUSTUB_PAGE_SIZE);
+  dm.WritePage(0, aligned);
+  dm.WritePage(1, unaligned);
+  dm.ReadPage(1, buf);
+  DiskManager::StampChecksum(1, unaligned);
+  EXPECT_EQ(std::memcmp(buf, unaligned, BUSTUB_PAGE_SIZE), 0);
+  dm.ReadPage(0, unaligned);
+  DiskManager::StampChecksum(0, aligned);
+  EXPECT_EQ(std::memcmp(unaligned, aligned, BUSTUB_PAGE_SIZE), 0);
+
+  // Scenario: a run with an unaligned buffer that reaches past the end of the file.
+  std::vector<char> tail(BUSTUB_PAGE_SIZE, 1);
+  std::vector<char *> run{buf, tail.data()};
+  dm.ReadPages(0, run.data(), run.size());
+  EXPECT_EQ('a', buf[BUSTUB_PAGE_SIZE - 1]);
+  EXPECT_EQ('u', tail[0]);
+  dm.ReadPages(1, run.data(), run.size());
+  EXPECT_EQ('u', buf[0]);
+  EXPECT_EQ(std::vector<char>(BUSTUB_PAGE_SIZE, 0), tail);
+
+  // Scenario: asynchronous requests with both kinds of buffers.
+  std::memset(buf, 0, BUSTUB_PAGE_SIZE);
+  EXPECT_TRUE(dm.ReadPageAsync(0, buf).get());
+  EXPECT_EQ('a', buf[0]);
+  EXPECT_TRUE(dm.WritePageAsync(2, unaligned).get());
+  EXPECT_TRUE(dm.ReadPageAsync(2, tail.data()).get());
+  EXPECT_EQ('a', tail[BUSTUB_PAGE_SIZE - 1]);
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, SegmentTest) {
+  const size_t segment_pages = 4;
+  std::string db_file("test.db");
+  auto segment_size = [&](int segment) {
+    struct stat stat_buf;
+    return stat((db_file + "." + std::to_string(segment)).c_str(), &stat_buf) == 0 ? stat_buf.st_size : -1;
+  };
+  std::vector<std::vector<char>> data(8, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<char *> run;
+  for (size_t i = 0; i < data.size(); i++) {
+    std::memset(data[i].data(), 'a' + i, BUSTUB_PAGE_SIZE);
+    run.push_back(data[i].data());
+  }
+  {
+    auto dm = DiskManager(db_file, false, segment_pages);
+
+    // Scenario: a run of pages 2 to 9 is split over segments 0, 1 and 2.
+    dm.WritePages(2, run.data(), run.size());
+    EXPECT_EQ(4 * BUSTUB_PAGE_SIZE, segment_size(1));
+    EXPECT_EQ(2 * BUSTUB_PAGE_SIZE, segment_size(2));
+
+    // Scenario: reading segments that were never written gives zeros and does not create them.
+    std::vector<char> buf(BUSTUB_PAGE_SIZE, 1);
+    dm.ReadPage(21, buf.data());
+    EXPECT_EQ(std::vector<char>(BUSTUB_PAGE_SIZE, 0), buf);
+    EXPECT_EQ(-1, segment_size(5));
+
+    // Scenario: asynchronous requests find the segment of their page too.
+    EXPECT_TRUE(dm.WritePageAsync(13, data[0].data()).get());
+    EXPECT_TRUE(dm.ReadPageAsync(13, buf.data()).get());
+    EXPECT_EQ(Stamped(13, data[0]), buf);
+    EXPECT_TRUE(dm.ReadPageAsync(17, buf.data()).get());
+    EXPECT_EQ(std::vector<char>(BUSTUB_PAGE_SIZE, 0), buf);
+
+    // Scenario: a preallocated segment gets its full size when it is created.
+    dm.SetPreallocateSegments(true);
+    dm.WritePage(24, data[0].data());
+    EXPECT_EQ(4 * BUSTUB_PAGE_SIZE, segment_size(6));
+    dm.ShutDown();
+  }
+
+  // Scenario: the segments are found again when the database is reopened.
+  auto dm = DiskManager(db_file, false, segment_pages);
+  std::vector<std::vector<char>> buf(8, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<char *> buf_run;
+  for (auto &page : buf) {
+    buf_run.push_back(page.data());
+  }
+  dm.ReadPages(2, buf_run.data(), buf_run.size());
+  for (size_t i = 0; i < data.size(); i++) {
+    EXPECT_EQ(Stamped(2 + i, data[i]), buf[i]);
+  }
+  dm.ShutDown();
+  for (int segment : {1, 2, 3, 6}) {
+    remove((db_file + "." + std::to_string(segment)).c_str());
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, AsyncIOErrorTest) {
+  const size_t segment_pages = 4;
+  std::string dir("test_io_error");
+  std::string db_file(dir + "/test.db");
+  std::vector<char> data(BUSTUB_PAGE_SIZE, 'x');
+  for (bool thread_pool : {false, true}) {
+    mkdir(dir.c_str(), 0755);
+    auto dm = DiskManager(db_file, false, segment_pages);
+    if (thread_pool) {
+      dm.SetIOEngine(std::make_unique<ThreadPoolIOEngine>(&dm, 2));
+    }
+    EXPECT_TRUE(dm.WritePageAsync(0, data.data()).get());
+
+    // Scenario: a write whose segment file cannot be created completes with false.
+    remove(db_file.c_str());
+    remove((dir + "/test.log").c_str());
+    rmdir(dir.c_str());
+    uint64_t errors = DiskManager::GetThreadIOErrors();
+    EXPECT_FALSE(dm.WritePageAsync(segment_pages, data.data()).get()) << dm.GetIOEngine()->GetName();
+    dm.WritePage(segment_pages, data.data());
+    EXPECT_EQ(errors + 1, DiskManager::GetThreadIOErrors());
+    dm.ShutDown();
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, LargeOffsetTest) {
+  std::string db_file("test.db");
+  // Scenario: with segments of 4 GB, page 600000 lies 2.4 GB into the first file, past what 32-bit offsets reach.
+  auto dm = DiskManager(db_file, false, size_t{1} << 20);
+  std::vector<char> data(BUSTUB_PAGE_SIZE, 'x');
+  std::vector<char> buf(BUSTUB_PAGE_SIZE);
+  dm.WritePage(600000, data.data());
+  dm.ReadPage(600000, buf.data());
+  EXPECT_EQ(Stamped(600000, data), buf);
+  dm.ReadPage(600000 % (1 << 19), buf.data());
+  EXPECT_EQ(std::vector<char>(BUSTUB_PAGE_SIZE, 0), buf);
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, FreePageTest) {
+  const size_t segment_pages = 4;
+  std::string db_file("test.db");
+  auto allocated_bytes = [&](const std::string &name) {
+    struct stat stat_buf;
+    return stat(name.c_str(), &stat_buf) == 0 ? static_cast<int64_t>(stat_buf.st_blocks) * 512 : -1;
+  };
+  auto file_size = [&](const std::string &name) {
+    struct stat stat_buf;
+    return stat(name.c_str(), &stat_buf) == 0 ? static_cast<int64_t>(stat_buf.st_size) : -1;
+  };
+  std::vector<char> data(BUSTUB_PAGE_SIZE, 'x');
+  std::vector<char> buf(BUSTUB_PAGE_SIZE);
+  {
+    auto dm = DiskManager(db_file, false, segment_pages);
+    for (page_id_t page_id = 0; page_id < 12; page_id++) {
+      dm.WritePage(page_id, data.data());
+    }
+    dm.Sync();
+
+    // Scenario: nothing is free yet.
+    EXPECT_EQ(INVALID_PAGE_ID, dm.ReusePage(INVALID_PAGE_ID));
+
+    // Scenario: a freed page keeps its space until a saved map lists it as free.
+    int64_t before = allocated_bytes(db_file);
+    dm.DeallocatePage(1);
+    EXPECT_TRUE(dm.IsFreePage(1));
+    dm.ReadPage(1, buf.data());
+    EXPECT_EQ(Stamped(1, data), buf);
+
+    // Scenario: after the next sync, a freed page reads as zeros, and its space is punched out of the file.
+    dm.Sync();
+    dm.ReadPage(1, buf.data());
+    EXPECT_EQ(std::vector<char>(BUSTUB_PAGE_SIZE, 0), buf);
+    if (before > 0 && allocated_bytes(db_file) < before) {
+      EXPECT_EQ(before - BUSTUB_PAGE_SIZE, allocated_bytes(db_file));
+    }
+    EXPECT_EQ(4 * BUSTUB_PAGE_SIZE, file_size(db_file));
+
+    // Scenario: a segment that becomes entirely free is truncated.
+    for (page_id_t page_id = 8; page_id < 12; page_id++) {
+      dm.DeallocatePage(page_id);
+    }
+    EXPECT_EQ(segment_pages * BUSTUB_PAGE_SIZE, file_size(db_file + ".2"));
+    dm.Sync();
+    EXPECT_EQ(0, file_size(db_file + ".2"));
+    EXPECT_EQ(5, dm.GetNumFreePages());
+
+    // Scenario: the free page closest to the hint is reused, within the pages of the given stride.
+    EXPECT_EQ(8, dm.ReusePage(7));
+    EXPECT_EQ(1, dm.ReusePage(3, 2, 1));
+    EXPECT_EQ(10, dm.ReusePage(INVALID_PAGE_ID, 2, 0));
+    EXPECT_FALSE(dm.IsFreePage(10));
+    EXPECT_EQ(INVALID_PAGE_ID, dm.ReusePage(0, 4, 2));
+
+    // Scenario: a reused page is written again.
+    dm.WritePage(10, data.data());
+    dm.ReadPage(10, buf.data());
+    EXPECT_EQ(Stamped(10, data), buf);
+    dm.ShutDown();
+  }
+
+  {
+    // Scenario: the free page map is saved and comes back when the database is reopened.
+    auto dm = DiskManager(db_file, false, segment_pages);
+    EXPECT_EQ(2, dm.GetNumFreePages());
+    EXPECT_TRUE(dm.IsFreePage(9));
+    EXPECT_TRUE(dm.IsFreePage(11));
+    dm.ShutDown();
+  }
+
+  // Scenario: the map of a database that was removed is not applied to a new one of the same name.
+  remove(db_file.c_str());
+  auto dm = DiskManager(db_file, false, segment_pages);
+  EXPECT_EQ(0, dm.GetNumFreePages());
+  dm.ShutDown();
+  for (int segment : {1, 2}) {
+    remove((db_file + "." + std::to_string(segment)).c_str());
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, ChecksumTest) {
+  std::string db_file("test.db");
+  auto overwrite_file = [&](int64_t offset, const char *bytes, size_t size) {
+    std::fstream file(db_file, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(offset);
+    file.write(bytes, static_cast<std::streamsize>(size));
+  };
+  std::vector<char> data(BUSTUB_PAGE_SIZE, 'x');
+  std::vector<char> buf(BUSTUB_PAGE_SIZE);
+  auto dm = DiskManager(db_file);
+  std::vector<page_id_t> failed;
+  dm.SetChecksumFailureHandler([&](page_id_t page_id) { failed.push_back(page_id); });
+
+  // Scenario: the checksum is filled in by the write, in the page on disk but not in the buffer written from, and
+  // matches on the read; pages never written read as zeros.
+  for (page_id_t page_id = 0; page_id < 3; page_id++) {
+    dm.WritePage(page_id, data.data());
+  }
+  EXPECT_TRUE(dm.WritePageAsync(4, data.data()).get());
+  EXPECT_EQ(std::vector<char>(BUSTUB_PAGE_SIZE, 'x'), data);
+  dm.ReadPage(2, buf.data());
+  EXPECT_TRUE(DiskManager::VerifyChecksum(2, buf.data()));
+  EXPECT_FALSE(DiskManager::VerifyChecksum(1, buf.data()));
+  dm.ReadPage(4, buf.data());
+  dm.ReadPage(0, buf.data());
+  dm.ReadPage(5, buf.data());
+  EXPECT_TRUE(dm.ReadPageAsync(1, buf.data()).get());
+  EXPECT_EQ(0, dm.GetNumChecksumFailures());
+
+  // Scenario: a flipped byte is found by synchronous and asynchronous reads, which still hand out the page.
+  overwrite_file(BUSTUB_PAGE_SIZE + 100, "y", 1);
+  dm.ReadPage(1, buf.data());
+  EXPECT_EQ('y', buf[100]);
+  EXPECT_TRUE(dm.ReadPageAsync(1, buf.data()).get());
+  EXPECT_EQ(2, dm.GetNumChecksumFailures());
+  EXPECT_EQ(std::vector<page_id_t>({1, 1}), failed);
+
+  // Scenario: a page written to the wrong place does not match its new page id.
+  dm.ReadPage(0, buf.data());
+  overwrite_file(2 * BUSTUB_PAGE_SIZE, buf.data(), buf.size());
+  dm.ReadPage(2, buf.data());
+  EXPECT_EQ(std::vector<page_id_t>({1, 1, 2}), failed);
+
+  // Scenario: without checksums pages are neither stamped nor verified.
+  dm.SetChecksums(false);
+  dm.ReadPage(1, buf.data());
+  std::vector<char> unstamped(BUSTUB_PAGE_SIZE, 'z');
+  dm.WritePage(3, unstamped.data());
+  EXPECT_EQ(std::vector<char>(BUSTUB_PAGE_SIZE, 'z'), unstamped);
+  EXPECT_EQ(3, dm.GetNumChecksumFailures());
+  dm.SetChecksums(true);
+  dm.ReadPage(3, buf.data());
+  EXPECT_EQ(4, dm.GetNumChecksumFailures());
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, SimulatedDiskTest) {
+  SimulatedDiskConfig config;
+  config.random_latency_ = std::chrono::microseconds(2000);
+  config.sequential_latency_ = std::chrono::microseconds(100);
+  config.bandwidth_mb_s_ = 400;
+  config.queue_depth_ = 2;
+  std::vector<char> data(BUSTUB_PAGE_SIZE, 'x');
+  std::vector<char> buf(BUSTUB_PAGE_SIZE);
+  auto elapsed_us = [](const std::function<void()> &work) {
+    auto start = std::chrono::steady_clock::now();
+    work();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  // Scenario: pages are kept, a random request pays the random latency and a sequential one much less.
+  DiskManagerSimulated dm(config);
+  EXPECT_GE(elapsed_us([&] { dm.WritePage(10, data.data()); }), 1800);
+  EXPECT_LT(elapsed_us([&] { dm.WritePage(11, data.data()); }), 1000);
+  dm.ReadPage(10, buf.data());
+  EXPECT_EQ(Stamped(10, data), buf);
+  EXPECT_EQ(0, dm.GetNumChecksumFailures());
+  auto stats = dm.GetStats();
+  EXPECT_EQ(2, stats.writes_);
+  EXPECT_EQ(1, stats.reads_);
+  EXPECT_EQ(1, stats.sequential_requests_);
+  EXPECT_GE(SimulatedDiskStats::Percentile(stats.write_latency_, 100), 2048);
+
+  // Scenario: a run is one request, and pays the transfer of every page (10 us per page at 400 MB/s).
+  std::vector<std::vector<char>> run(64, data);
+  std::vector<const char *> pages;
+  for (auto &page : run) {
+    pages.push_back(page.data());
+  }
+  EXPECT_GE(elapsed_us([&] { dm.WritePages(100, pages.data(), pages.size()); }), 1800 + 600);
+  EXPECT_EQ(3, dm.GetStats().writes_);
+  EXPECT_EQ(66, dm.GetStats().pages_written_);
+
+  // Scenario: requests beyond the queue depth wait for a slot.
+  dm.ResetStats();
+  std::vector<std::thread> threads;
+  auto concurrent_us = elapsed_us([&] {
+    for (int i = 0; i < 4; i++) {
+      threads.emplace_back([&, i] {
+        std::vector<char> page(BUSTUB_PAGE_SIZE);
+        dm.ReadPage(i * 1000, page.data());
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  });
+  EXPECT_GE(concurrent_us, 2 * 1800);
+  EXPECT_EQ(4, dm.GetStats().reads_);
+  EXPECT_GE(dm.GetStats().queued_requests_, 2);
+
+  // Scenario: pages in memory are checksummed like on disk, a page stored without a checksum is caught.
+  dm.SetChecksums(false);
+  dm.WritePage(12, data.data());
+  dm.SetChecksums(true);
+  dm.ReadPage(12, buf.data());
+  EXPECT_EQ(1, dm.GetNumChecksumFailures());
+
+  // Scenario: with the same seed, a single-threaded run sees the same service times every time.
+  config.random_latency_ = std::chrono::microseconds(300);
+  config.jitter_ = 0.5;
+  auto histogram = [&](uint64_t seed) {
+    config.seed_ = seed;
+    DiskManagerSimulated seeded(config);
+    for (page_id_t page_id = 0; page_id < 32; page_id++) {
+      seeded.WritePage(page_id * 7, data.data());
+    }
+    return seeded.GetStats().write_latency_;
+  };
+  EXPECT_EQ(histogram(1), histogram(1));
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, CompressedDiskTest) {
+  std::string db_file("test.db");
+  auto file_size = [&]() {
+    struct stat stat_buf;
+    return stat(db_file.c_str(), &stat_buf) == 0 ? static_cast<int64_t>(stat_buf.st_size) : -1;
+  };
+  // Pages of repeating numbers, like a table of integers, and one of noise.
+  std::vector<std::vector<char>> data(8, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<const char *> run;
+  for (size_t i = 0; i < data.size(); i++) {
+    for (size_t offset = 0; offset < BUSTUB_PAGE_SIZE; offset += sizeof(uint32_t)) {
+      auto value = static_cast<uint32_t>(i * 1000 + offset / 64);
+      std::memcpy(data[i].data() + offset, &value, sizeof(value));
+    }
+    run.push_back(data[i].data());
+  }
+  std::vector<char> noise(BUSTUB_PAGE_SIZE);
+  std::mt19937 gen(15445);
+  for (auto &byte : noise) {
+    byte = static_cast<char>(gen());
+  }
+  std::vector<char> buf(BUSTUB_PAGE_SIZE);
+  {
+    DiskManagerCompressed dm(db_file);
+
+    // Scenario: a run of pages is compressed into consecutive extents and read back as it was written.
+    dm.WritePages(0, run.data(), run.size());
+    EXPECT_EQ(8, dm.GetNumStoredPages());
+    EXPECT_LT(dm.GetStoredBytes(), 8 * BUSTUB_PAGE_SIZE / 4);
+    EXPECT_EQ(static_cast<int64_t>(dm.GetStoredBytes()), file_size());
+    std::vector<std::vector<char>> read(8, std::vector<char>(BUSTUB_PAGE_SIZE));
+    std::vector<char *> read_run;
+    for (auto &page : read) {
+      read_run.push_back(page.data());
+    }
+    dm.ReadPages(0, read_run.data(), read_run.size());
+    for (size_t i = 0; i < data.size(); i++) {
+      EXPECT_EQ(Stamped(i, data[i]), read[i]);
+    }
+
+    // Scenario: a page that does not compress is stored as it is, and one never written reads as zeros.
+    uint64_t stored = dm.GetStoredBytes();
+    dm.WritePage(8, noise.data());
+    EXPECT_EQ(DiskManagerCompressed::MAX_EXTENT_SLOTS * DiskManagerCompressed::SLOT_SIZE,
+              dm.GetStoredBytes() - stored);
+    dm.ReadPage(8, buf.data());
+    EXPECT_EQ(Stamped(8, noise), buf);
+    dm.ReadPage(20, buf.data());
+    EXPECT_EQ(std::vector<char>(BUSTUB_PAGE_SIZE, 0), buf);
+
+    // Scenario: asynchronous requests go through the thread pool, which compresses too.
+    EXPECT_TRUE(dm.WritePageAsync(9, data[0].data()).get());
+    EXPECT_TRUE(dm.ReadPageAsync(9, buf.data()).get());
+    EXPECT_EQ(Stamped(9, data[0]), buf);
+
+    // Scenario: a page that outgrows its extent moves, and its old extent is only reused after a sync.
+    int64_t size = file_size();
+    dm.WritePage(3, noise.data());
+    EXPECT_GT(file_size(), size);
+    size = file_size();
+    dm.WritePage(10, data[1].data());
+    EXPECT_GT(file_size(), size);
+    dm.Sync();
+    size = file_size();
+    dm.WritePage(11, data[2].data());
+    EXPECT_EQ(size, file_size());
+    dm.ReadPage(11, buf.data());
+    EXPECT_EQ(Stamped(11, data[2]), buf);
+
+    // Scenario: a deallocated page loses its extent once the free page map is saved.
+    dm.DeallocatePage(5);
+    EXPECT_EQ(12, dm.GetNumStoredPages());
+    dm.Sync();
+    EXPECT_EQ(11, dm.GetNumStoredPages());
+    dm.ShutDown();
+  }
+
+  {
+    // Scenario: the extent map comes back when the database is reopened.
+    DiskManagerCompressed dm(db_file);
+    EXPECT_EQ(11, dm.GetNumStoredPages());
+    for (page_id_t page_id : {0, 7}) {
+      dm.ReadPage(page_id, buf.data());
+      EXPECT_EQ(Stamped(page_id, data[page_id]), buf);
+    }
+    dm.ReadPage(11, buf.data());
+    EXPECT_EQ(Stamped(11, data[2]), buf);
+    dm.ReadPage(3, buf.data());
+    EXPECT_EQ(Stamped(3, noise), buf);
+    EXPECT_EQ(0, dm.GetNumChecksumFailures());
+
+    // Scenario: an extent that no longer decompresses is reported like a checksum mismatch.
+    {
+      std::fstream file(db_file, std::ios::binary | std::ios::in | std::ios::out);
+      file.seekp(sizeof(DiskManagerCompressed::ExtentHeader) + 1);
+      file.write("\xff\xff\xff\xff", 4);
+    }
+    std::vector<page_id_t> failed;
+    dm.SetChecksumFailureHandler([&](page_id_t page_id) { failed.push_back(page_id); });
+    dm.ReadPage(0, buf.data());
+    EXPECT_EQ(std::vector<page_id_t>({0}), failed);
+    dm.ShutDown();
+  }
+
+  // Scenario: an uncompressed database is not taken for a compressed one.
+  remove((db_file + ".extents").c_str());
+  EXPECT_THROW(DiskManagerCompressed dm(db_file), Exception);
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, CompressedDiskSyncTest) {
+  const page_id_t num_pages = 32;
+  const int rounds = 20;
+  std::string db_file("test.db");
+  // Round r fills page i with a pattern that compresses worse the larger r is, so that pages keep moving.
+  auto fill = [](page_id_t page_id, int round) {
+    std::vector<char> page(BUSTUB_PAGE_SIZE);
+    std::mt19937 gen(page_id);
+    for (size_t offset = 0; offset < BUSTUB_PAGE_SIZE; offset++) {
+      page[offset] = offset % rounds < static_cast<size_t>(round) ? static_cast<char>(gen()) : 'a';
+    }
+    return page;
+  };
+  {
+    DiskManagerCompressed dm(db_file);
+
+    // Scenario: pages move to new extents while other threads sync; no extent is freed while a saved map uses it.
+    std::thread writer([&] {
+      for (int round = 1; round <= rounds; round++) {
+        for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+          dm.WritePage(page_id, fill(page_id, round).data());
+        }
+      }
+    });
+    for (int i = 0; i < 2 * rounds; i++) {
+      dm.Sync();
+    }
+    writer.join();
+    dm.ShutDown();
+  }
+
+  // Scenario: after a reopen every page reads as it was last written.
+  DiskManagerCompressed dm(db_file);
+  std::vector<char> buf(BUSTUB_PAGE_SIZE);
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    dm.ReadPage(page_id, buf.data());
+    EXPECT_EQ(Stamped(page_id, fill(page_id, rounds)), buf) << "page " << page_id;
+  }
+  EXPECT_EQ(0, dm.GetNumChecksumFailures());
   dm.ShutDown();
 }
 
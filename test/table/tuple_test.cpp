@@ -19,8 +19,10 @@
 #include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
 #include "logging/common.h"
+#include "storage/disk/disk_manager_memory.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 // NOLINTNEXTLINE
@@ -71,4 +73,71 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(TupleTest, TableHeapNumPagesTest) {
+  Column col1{"a", TypeId::VARCHAR, 200};
+  Schema schema{std::vector<Column>{col1}};
+  Tuple tuple({ValueFactory::GetVarcharValue(std::string(200, 'x'))}, &schema);
+  Transaction transaction(0);
+  DiskManagerUnlimitedMemory disk_manager;
+  BufferPoolManagerInstance bpm(16, &disk_manager);
+
+  // Scenario: a new table counts the pages it grows by.
+  TableHeap table(&bpm, nullptr, nullptr, &transaction);
+  RID rid;
+  for (int i = 0; i < 100; i++) {
+    ASSERT_TRUE(table.InsertTuple(tuple, &rid, &transaction));
+  }
+  size_t num_pages = table.GetNumPages();
+  EXPECT_GT(num_pages, 1);
+
+  // Scenario: a table opened by its first page does not read it to count the pages, the first full scan does.
+  auto stats = bpm.GetStats();
+  TableHeap opened(&bpm, nullptr, nullptr, table.GetFirstPageId());
+  EXPECT_EQ(stats.hits_ + stats.misses_, bpm.GetStats().hits_ + bpm.GetStats().misses_);
+  EXPECT_EQ(TableHeap::UNKNOWN_NUM_PAGES, opened.GetNumPages());
+  auto it = opened.Begin(&transaction);
+  ++it;
+  EXPECT_EQ(TableHeap::UNKNOWN_NUM_PAGES, opened.GetNumPages());
+  for (; it != opened.End(); ++it) {
+  }
+  EXPECT_EQ(num_pages, opened.GetNumPages());
+  ASSERT_TRUE(opened.InsertTuple(tuple, &rid, &transaction));
+  EXPECT_GE(opened.GetNumPages(), num_pages);
+}
+
+TEST(TupleTest, TableHeapGetTuplesTest) {
+  Column col1{"a", TypeId::VARCHAR, 200};
+  Schema schema{std::vector<Column>{col1}};
+  Transaction transaction(0);
+  DiskManagerUnlimitedMemory disk_manager;
+  BufferPoolManagerInstance bpm(3, &disk_manager);
+
+  TableHeap table(&bpm, nullptr, nullptr, &transaction);
+  std::vector<RID> rids;
+  for (int i = 0; i < 100; i++) {
+    Tuple tuple({ValueFactory::GetVarcharValue(std::to_string(i) + std::string(200, 'x'))}, &schema);
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(tuple, &rid, &transaction));
+    rids.push_back(rid);
+  }
+  ASSERT_GT(table.GetNumPages(), 3);
+
+  // Scenario: the tuples span more pages than the pool has frames; those that cannot be pinned together are read one
+  // page at a time.
+  std::vector<Tuple> tuples;
+  ASSERT_TRUE(table.GetTuples(rids, &tuples, &transaction));
+  ASSERT_EQ(rids.size(), tuples.size());
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(std::to_string(i) + std::string(200, 'x'), tuples[i].GetValue(&schema, 0).ToString());
+  }
+  EXPECT_NE(TransactionState::ABORTED, transaction.GetState());
+
+  // Scenario: every page was unpinned again.
+  page_id_t page_id;
+  for (int i = 0; i < 3; i++) {
+    ASSERT_NE(nullptr, bpm.NewPage(&page_id));
+  }
+}
+
 }  // namespace bustub
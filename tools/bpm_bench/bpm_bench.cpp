@@ -0,0 +1,1687 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <functional>
+#include <future>  // NOLINT
+#include <iostream>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <numeric>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/frame_arena.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/page_table.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "common/exception.h"
+#include "common/util/crc32c.h"
+#include "container/hash/extendible_hash_table.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager_compressed.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_manager_simulated.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/generic_key.h"
+#include "storage/page/table_page.h"
+#include "storage/table/table_heap.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+struct BpmBenchConfig {
+  uint64_t duration_ms_{1000};
+  size_t max_threads_{32};
+  size_t instances_{8};
+  size_t pool_size_{1024};
+  size_t pages_{512};
+  size_t evictions_{10000};
+  size_t threads_{4};
+  uint64_t latency_us_{100};
+  uint64_t sequential_latency_us_{10};
+  double bandwidth_mb_s_{1000};
+  size_t queue_depth_{32};
+  uint64_t seed_{15445};
+};
+
+/**
+ * Simulated disk that also counts the pages each thread reads, so that the fetch workloads can tell hits from misses.
+ * While loading, requests are free.
+ */
+class SlowDiskManager : public bustub::DiskManagerSimulated {
+ public:
+  using bustub::DiskManagerSimulated::DiskManagerSimulated;
+
+  void WritePage(bustub::page_id_t page_id, const char *page_data) override {
+    if (loading_) {
+      DiskManagerUnlimitedMemory::WritePage(page_id, page_data);
+    } else {
+      DiskManagerSimulated::WritePage(page_id, page_data);
+    }
+  }
+
+  void WritePages(bustub::page_id_t first_page_id, const char *const *pages, size_t num_pages) override {
+    if (loading_) {
+      for (size_t i = 0; i < num_pages; i++) {
+        DiskManagerUnlimitedMemory::WritePage(first_page_id + static_cast<bustub::page_id_t>(i), pages[i]);
+      }
+    } else {
+      DiskManagerSimulated::WritePages(first_page_id, pages, num_pages);
+    }
+  }
+
+  void ReadPage(bustub::page_id_t page_id, char *page_data) override {
+    if (loading_) {
+      DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+    } else {
+      DiskManagerSimulated::ReadPage(page_id, page_data);
+    }
+    thread_reads_++;
+  }
+
+  void ReadPages(bustub::page_id_t first_page_id, char *const *pages, size_t num_pages) override {
+    if (loading_) {
+      for (size_t i = 0; i < num_pages; i++) {
+        DiskManagerUnlimitedMemory::ReadPage(first_page_id + static_cast<bustub::page_id_t>(i), pages[i]);
+      }
+    } else {
+      DiskManagerSimulated::ReadPages(first_page_id, pages, num_pages);
+    }
+    thread_reads_ += num_pages;
+  }
+
+  /** @param loading whether requests skip the simulated device */
+  void SetLoading(bool loading) { loading_ = loading; }
+
+  /** @return the number of pages the calling thread has read so far */
+  static auto ThreadReads() -> uint64_t { return thread_reads_; }
+
+ private:
+  std::atomic<bool> loading_{false};
+  inline static thread_local uint64_t thread_reads_{0};
+};
+
+/** @return the simulated device of the benchmarks, with the random latency given by --latency */
+auto DiskConfig(const BpmBenchConfig &config, uint64_t latency_us) -> bustub::SimulatedDiskConfig {
+  bustub::SimulatedDiskConfig disk;
+  disk.random_latency_ = std::chrono::microseconds(latency_us);
+  disk.sequential_latency_ = std::chrono::microseconds(std::min(config.sequential_latency_us_, latency_us));
+  disk.bandwidth_mb_s_ = config.bandwidth_mb_s_;
+  disk.queue_depth_ = config.queue_depth_;
+  disk.seed_ = config.seed_;
+  return disk;
+}
+
+auto DiskConfig(const BpmBenchConfig &config) -> bustub::SimulatedDiskConfig {
+  return DiskConfig(config, config.latency_us_);
+}
+
+void PrintDiskStats(const std::string &name, const bustub::SimulatedDiskStats &stats) {
+  using Stats = bustub::SimulatedDiskStats;
+  fmt::print(
+      "{} disk: reads={} pages_read={} writes={} pages_written={} sequential={} queued={} "
+      "read p50/p99={}/{}us write p50/p99={}/{}us\n",
+      name, stats.reads_, stats.pages_read_, stats.writes_, stats.pages_written_, stats.sequential_requests_,
+      stats.queued_requests_, Stats::Percentile(stats.read_latency_, 50), Stats::Percentile(stats.read_latency_, 99),
+      Stats::Percentile(stats.write_latency_, 50), Stats::Percentile(stats.write_latency_, 99));
+}
+
+/**
+ * Runs `num_threads` workers against `bpm` for the configured duration. Every worker repeatedly fetches a random
+ * page out of `page_ids`, touches it and unpins it. Returns the number of operations per second. If `hit_rate` is
+ * given, it receives the share of the workers' fetches that did not read from a SlowDiskManager.
+ */
+auto RunFetchWorkload(bustub::BufferPoolManager *bpm, const std::vector<bustub::page_id_t> &page_ids,
+                      size_t num_threads, uint64_t duration_ms, double *hit_rate = nullptr) -> double {
+  std::vector<std::thread> threads;
+  std::vector<uint64_t> ops(num_threads, 0);
+  std::vector<uint64_t> reads(num_threads, 0);
+  auto start = ClockMs();
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid]() {
+      std::mt19937 gen(tid);
+      std::uniform_int_distribution<size_t> dis(0, page_ids.size() - 1);
+      uint64_t cnt = 0;
+      auto reads_before = SlowDiskManager::ThreadReads();
+      while (ClockMs() - start < duration_ms) {
+        for (size_t i = 0; i < 64; i++) {
+          auto page_id = page_ids[dis(gen)];
+          auto *page = bpm->FetchPage(page_id);
+          if (page == nullptr) {
+            throw bustub::Exception("bpm bench: fetch failed");
+          }
+          page->RLatch();
+          cnt += static_cast<uint8_t>(page->GetData()[0]) == 0xff ? 0 : 1;
+          page->RUnlatch();
+          bpm->UnpinPage(page_id, false);
+        }
+      }
+      ops[tid] = cnt;
+      reads[tid] = SlowDiskManager::ThreadReads() - reads_before;
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  uint64_t total = 0;
+  uint64_t total_reads = 0;
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    total += ops[tid];
+    total_reads += reads[tid];
+  }
+  if (hit_rate != nullptr) {
+    *hit_rate = total == 0 ? 0 : 1 - total_reads / static_cast<double>(total);
+  }
+  return total / static_cast<double>(ClockMs() - start) * 1000;
+}
+
+auto CreatePages(bustub::BufferPoolManager *bpm, size_t pages) -> std::vector<bustub::page_id_t> {
+  std::vector<bustub::page_id_t> page_ids;
+  for (size_t i = 0; i < pages; i++) {
+    bustub::page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    if (page == nullptr) {
+      throw bustub::Exception("bpm bench: cannot create page");
+    }
+    bpm->UnpinPage(page_id, true);
+    page_ids.push_back(page_id);
+  }
+  return page_ids;
+}
+
+void PrintStats(const std::string &name, const bustub::BufferPoolStats &stats) {
+  fmt::print(
+      "{}: hits={:<10} misses={:<8} new_pages={:<6} evictions={:<8} write_backs={:<8} background_write_backs={:<8} "
+      "no_frame={} prefetches={} ring_reuses={} eviction_batches={} batch_writes={} warm_up_pages={} "
+      "reused_pages={} io_errors={}\n",
+      name, stats.hits_, stats.misses_, stats.new_pages_, stats.evictions_, stats.write_backs_,
+      stats.background_write_backs_, stats.no_frame_, stats.prefetches_, stats.ring_reuses_, stats.eviction_batches_,
+      stats.batch_writes_, stats.warm_up_pages_, stats.reused_pages_, stats.io_errors_);
+}
+
+/**
+ * Buffer hits only: compares one BufferPoolManagerInstance with a ParallelBufferPoolManager of the same total size
+ * while the number of threads grows from 1 to --max-threads.
+ */
+void ContentionBench(const BpmBenchConfig &config) {
+  fmt::print("contention: pool_size={} pages={} instances={}\n", config.pool_size_, config.pages_,
+             config.instances_);
+  fmt::print("{:>8} {:>16} {:>16} {:>8}\n", "threads", "single (op/s)", "parallel (op/s)", "speedup");
+  for (size_t num_threads = 1; num_threads <= config.max_threads_; num_threads *= 2) {
+    auto disk_manager = std::make_unique<bustub::DiskManagerUnlimitedMemory>();
+    auto single = std::make_unique<bustub::BufferPoolManagerInstance>(config.pool_size_, disk_manager.get());
+    auto parallel = std::make_unique<bustub::ParallelBufferPoolManager>(
+        config.instances_, config.pool_size_ / config.instances_, disk_manager.get());
+
+    auto single_pages = CreatePages(single.get(), config.pages_);
+    auto single_tput = RunFetchWorkload(single.get(), single_pages, num_threads, config.duration_ms_);
+    auto parallel_pages = CreatePages(parallel.get(), config.pages_);
+    auto parallel_tput = RunFetchWorkload(parallel.get(), parallel_pages, num_threads, config.duration_ms_);
+
+    fmt::print("{:>8} {:>16.0f} {:>16.0f} {:>7.2f}x\n", num_threads, single_tput, parallel_tput,
+               parallel_tput / single_tput);
+    if (num_threads * 2 > config.max_threads_) {
+      for (size_t i = 0; i < parallel->GetNumInstances(); i++) {
+        PrintStats(fmt::format("shard {}", i), parallel->GetInstanceStats(i));
+      }
+    }
+  }
+}
+
+/**
+ * The LRU-K replacer as it was before frames were kept in ordered sets: every eviction scans all tracked frames and
+ * every frame keeps its history in a std::list. Only used as the baseline of the replacer benchmark.
+ */
+class ScanLRUKReplacer {
+ public:
+  ScanLRUKReplacer(size_t num_frames, size_t k) : k_(k) {}
+
+  auto Evict(bustub::frame_id_t *frame_id) -> bool {
+    std::scoped_lock<std::mutex> lock(latch_);
+    auto k_it_evict = cache_.end();
+    auto none_k_it_evict = cache_.end();
+    for (auto it = cache_.begin(); it != cache_.end(); it++) {
+      if (!it->second.evictable_) {
+        continue;
+      }
+      auto &victim = it->second.accesses_.size() == k_ ? k_it_evict : none_k_it_evict;
+      if (victim == cache_.end() || it->second.accesses_.front() < victim->second.accesses_.front()) {
+        victim = it;
+      }
+    }
+    auto victim = none_k_it_evict != cache_.end() ? none_k_it_evict : k_it_evict;
+    if (victim == cache_.end()) {
+      return false;
+    }
+    *frame_id = victim->first;
+    cache_.erase(victim);
+    return true;
+  }
+
+  void RecordAccess(bustub::frame_id_t frame_id) {
+    std::scoped_lock<std::mutex> lock(latch_);
+    auto &frame = cache_[frame_id];
+    frame.accesses_.push_back(current_timestamp_++);
+    if (frame.accesses_.size() > k_) {
+      frame.accesses_.pop_front();
+    }
+  }
+
+  void SetEvictable(bustub::frame_id_t frame_id, bool set_evictable) {
+    std::scoped_lock<std::mutex> lock(latch_);
+    auto it = cache_.find(frame_id);
+    if (it != cache_.end()) {
+      it->second.evictable_ = set_evictable;
+    }
+  }
+
+ private:
+  struct Frame {
+    std::list<size_t> accesses_;
+    bool evictable_{false};
+  };
+  size_t k_;
+  size_t current_timestamp_{0};
+  std::unordered_map<bustub::frame_id_t, Frame> cache_;
+  std::mutex latch_;
+};
+
+/**
+ * Fills a replacer with `num_frames` evictable frames, then measures a buffer-pool-like loop: a few hits on random
+ * frames followed by one eviction whose frame is immediately reused. Returns the evictions per second.
+ */
+template <typename ReplacerType>
+auto RunReplacerWorkload(size_t num_frames, size_t evictions, uint64_t duration_ms) -> double {
+  ReplacerType replacer(num_frames, bustub::LRUK_REPLACER_K);
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<bustub::frame_id_t> dis(0, static_cast<bustub::frame_id_t>(num_frames - 1));
+  for (size_t i = 0; i < num_frames; i++) {
+    auto frame_id = static_cast<bustub::frame_id_t>(i);
+    replacer.RecordAccess(frame_id);
+    replacer.SetEvictable(frame_id, true);
+  }
+  for (size_t i = 0; i < num_frames; i++) {
+    replacer.RecordAccess(dis(gen));
+  }
+
+  auto start = ClockMs();
+  size_t done = 0;
+  while (done < evictions && ClockMs() - start < duration_ms) {
+    for (int i = 0; i < 4; i++) {
+      replacer.RecordAccess(dis(gen));
+    }
+    bustub::frame_id_t frame_id;
+    if (!replacer.Evict(&frame_id)) {
+      throw bustub::Exception("bpm bench: nothing to evict");
+    }
+    replacer.RecordAccess(frame_id);
+    replacer.SetEvictable(frame_id, true);
+    done++;
+  }
+  auto elapsed = std::max<uint64_t>(ClockMs() - start, 1);
+  return done / static_cast<double>(elapsed) * 1000;
+}
+
+/**
+ * Eviction cost of the LRU-K replacer against the scan-based baseline at growing pool sizes.
+ */
+void ReplacerBench(const BpmBenchConfig &config) {
+  fmt::print("replacer: k={} evictions={} (scan baseline capped at {} ms)\n", bustub::LRUK_REPLACER_K,
+             config.evictions_, config.duration_ms_);
+  fmt::print("{:>10} {:>16} {:>16} {:>10}\n", "frames", "scan (evict/s)", "lru-k (evict/s)", "speedup");
+  for (size_t num_frames : {1000, 100000, 1000000}) {
+    auto scan_tput = RunReplacerWorkload<ScanLRUKReplacer>(num_frames, config.evictions_, config.duration_ms_);
+    auto lru_k_tput = RunReplacerWorkload<bustub::LRUKReplacer>(num_frames, config.evictions_, UINT64_MAX);
+    fmt::print("{:>10} {:>16.0f} {:>16.0f} {:>9.1f}x\n", num_frames, scan_tput, lru_k_tput, lru_k_tput / scan_tput);
+  }
+}
+
+/**
+ * LRU-K replacer that applies every access under its latch right away, as it did before accesses were buffered: a pin
+ * takes the latch twice. Only used as the baseline of the recording benchmark.
+ */
+class LockedAccessLRUKReplacer {
+ public:
+  LockedAccessLRUKReplacer(size_t num_frames, size_t k) : replacer_(num_frames, k) {}
+
+  /** Size() drains the access right away, under the latch. */
+  void RecordAccess(bustub::frame_id_t frame_id) {
+    replacer_.RecordAccess(frame_id);
+    replacer_.Size();
+  }
+
+  void RecordAccessAndPin(bustub::frame_id_t frame_id, bustub::page_id_t page_id) {
+    RecordAccess(frame_id);
+    replacer_.SetEvictable(frame_id, false);
+  }
+
+  void SetEvictable(bustub::frame_id_t frame_id, bool set_evictable) {
+    replacer_.SetEvictable(frame_id, set_evictable);
+  }
+
+ private:
+  bustub::LRUKReplacer replacer_;
+};
+
+/**
+ * Buffer pool hits as the replacer sees them: every thread pins and unpins random frames. Returns the hits per second.
+ */
+template <typename ReplacerType>
+auto RunRecordingWorkload(size_t num_frames, size_t num_threads, uint64_t duration_ms) -> double {
+  ReplacerType replacer(num_frames, bustub::LRUK_REPLACER_K);
+  for (size_t i = 0; i < num_frames; i++) {
+    replacer.RecordAccess(static_cast<bustub::frame_id_t>(i));
+    replacer.SetEvictable(static_cast<bustub::frame_id_t>(i), true);
+  }
+  std::atomic<uint64_t> hits{0};
+  std::vector<std::thread> threads;
+  auto start = ClockMs();
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid]() {
+      std::mt19937 gen(tid);
+      std::uniform_int_distribution<bustub::frame_id_t> dis(0, static_cast<bustub::frame_id_t>(num_frames - 1));
+      uint64_t local_hits = 0;
+      while (ClockMs() - start < duration_ms) {
+        for (int i = 0; i < 64; i++) {
+          auto frame_id = dis(gen);
+          replacer.RecordAccessAndPin(frame_id, bustub::INVALID_PAGE_ID);
+          replacer.SetEvictable(frame_id, true);
+        }
+        local_hits += 64;
+      }
+      hits += local_hits;
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto elapsed = std::max<uint64_t>(ClockMs() - start, 1);
+  return hits / static_cast<double>(elapsed) * 1000;
+}
+
+/**
+ * Hit path of the LRU-K replacer with accesses applied under the latch one by one, and buffered and applied in
+ * batches.
+ */
+void RecordingBench(const BpmBenchConfig &config) {
+  fmt::print("recording: frames={} k={}\n", config.pool_size_, bustub::LRUK_REPLACER_K);
+  fmt::print("{:>8} {:>16} {:>18} {:>8}\n", "threads", "locked (hit/s)", "buffered (hit/s)", "speedup");
+  for (size_t num_threads = 1; num_threads <= config.max_threads_; num_threads *= 2) {
+    auto locked = RunRecordingWorkload<LockedAccessLRUKReplacer>(config.pool_size_, num_threads, config.duration_ms_);
+    auto buffered = RunRecordingWorkload<bustub::LRUKReplacer>(config.pool_size_, num_threads, config.duration_ms_);
+    fmt::print("{:>8} {:>16.0f} {:>18.0f} {:>7.2f}x\n", num_threads, locked, buffered, buffered / locked);
+  }
+}
+
+/**
+ * Hot resident set served to --threads workers, with and without a concurrent cold scan that misses on every page.
+ * With I/O done outside the buffer pool latch, the hot workers should barely notice the scan.
+ */
+void IOBench(const BpmBenchConfig &config) {
+  fmt::print("io: pool_size={} hot_pages={} threads={} latency={}us\n", config.pool_size_, config.pages_,
+             config.threads_, config.latency_us_);
+  auto disk_manager = std::make_unique<SlowDiskManager>(DiskConfig(config));
+  auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(config.pool_size_, disk_manager.get());
+  auto hot_pages = CreatePages(bpm.get(), config.pages_);
+  // Cold pages only exist on disk.
+  std::vector<char> data(bustub::BUSTUB_PAGE_SIZE, 0);
+  const size_t cold_pages = config.pool_size_ * 4;
+  const auto first_cold_page = static_cast<bustub::page_id_t>(config.pages_ + config.pool_size_);
+  for (size_t i = 0; i < cold_pages; i++) {
+    disk_manager->DiskManagerUnlimitedMemory::WritePage(first_cold_page + static_cast<bustub::page_id_t>(i),
+                                                        data.data());
+  }
+
+  disk_manager->ResetStats();
+  auto hot_alone = RunFetchWorkload(bpm.get(), hot_pages, config.threads_, config.duration_ms_);
+
+  std::atomic<bool> stop{false};
+  uint64_t scanned = 0;
+  std::thread scanner([&]() {
+    while (!stop) {
+      for (size_t i = 0; i < cold_pages && !stop; i++) {
+        auto page_id = first_cold_page + static_cast<bustub::page_id_t>(i);
+        if (bpm->FetchPage(page_id) != nullptr) {
+          bpm->UnpinPage(page_id, false);
+          scanned++;
+        }
+      }
+    }
+  });
+  auto hot_with_scan = RunFetchWorkload(bpm.get(), hot_pages, config.threads_, config.duration_ms_);
+  stop = true;
+  scanner.join();
+
+  fmt::print("hot only:        {:>12.0f} op/s\n", hot_alone);
+  fmt::print("hot + cold scan: {:>12.0f} op/s ({:.1f}%), scan {:.0f} pages/s\n", hot_with_scan,
+             hot_with_scan / hot_alone * 100, scanned / static_cast<double>(config.duration_ms_) * 1000);
+  PrintStats("bpm", bpm->GetStats());
+  PrintDiskStats("bpm", disk_manager->GetStats());
+}
+
+/**
+ * OLTP hit rate on a hot set of --pages pages while a large table is scanned, without and with a buffer access
+ * strategy for the scan. Like TableIterator, the scan fetches every page several times, which lets scanned pages
+ * compete with the hot set in an LRU-2 replacer. The effect shows once the hot set fills most of the pool, e.g.
+ * `--pages 960 --threads 1`. The ring scan runs once more without page checksums, for what they cost.
+ */
+void ScanBench(const BpmBenchConfig &config) {
+  fmt::print("scan: pool_size={} hot_pages={} threads={} latency={}us ring={}\n", config.pool_size_, config.pages_,
+             config.threads_, config.latency_us_, bustub::SCAN_RING_SIZE);
+  auto run = [&](const std::string &name, bool scan, bool ring, bool checksums) {
+    // Every round starts from a fresh buffer pool, where the hot set has been read often enough for the replacer to
+    // know it is hot.
+    auto disk_manager = std::make_unique<SlowDiskManager>(DiskConfig(config));
+    disk_manager->SetChecksums(checksums);
+    auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(config.pool_size_, disk_manager.get(), 2);
+    auto table_pages = CreatePages(bpm.get(), config.pool_size_ * 4);
+    auto hot_pages = CreatePages(bpm.get(), config.pages_);
+    for (auto page_id : hot_pages) {
+      if (bpm->FetchPage(page_id) != nullptr) {
+        bpm->UnpinPage(page_id, false);
+      }
+    }
+    disk_manager->ResetStats();
+    std::atomic<bool> stop{false};
+    uint64_t scanned = 0;
+    std::thread scanner([&]() {
+      while (scan && !stop) {
+        auto strategy = ring ? std::make_shared<bustub::BufferAccessStrategy>(bustub::SCAN_RING_SIZE) : nullptr;
+        for (size_t i = 0; i < table_pages.size() && !stop; i++) {
+          for (int touch = 0; touch < 3; touch++) {
+            if (bpm->FetchPageWithStrategy(table_pages[i], strategy.get()) != nullptr) {
+              bpm->UnpinPage(table_pages[i], false);
+            }
+          }
+          scanned++;
+        }
+      }
+    });
+    double hit_rate;
+    auto tput = RunFetchWorkload(bpm.get(), hot_pages, config.threads_, config.duration_ms_, &hit_rate);
+    stop = true;
+    scanner.join();
+    double scan_rate = scanned / static_cast<double>(config.duration_ms_) * 1000;
+    fmt::print("{:<30} {:>12.0f} op/s  hot hit rate {:>6.2f}%  scan {:>8.0f} pages/s\n", name, tput, hit_rate * 100,
+               scan_rate);
+    PrintStats(name, bpm->GetStats());
+    PrintDiskStats(name, disk_manager->GetStats());
+    if (disk_manager->GetNumChecksumFailures() != 0) {
+      throw bustub::Exception("bpm bench: checksum mismatch");
+    }
+    return std::make_pair(tput, scan_rate);
+  };
+  run("hot only", false, false, true);
+  run("hot + scan", true, false, true);
+  auto [tput, scan_rate] = run("hot + ring scan", true, true, true);
+  auto [plain_tput, plain_scan_rate] = run("hot + ring scan, no checksums", true, true, false);
+  fmt::print("checksum overhead: hot {:.1f}%  scan {:.1f}%\n", (1 - tput / plain_tput) * 100,
+             (1 - scan_rate / plain_scan_rate) * 100);
+}
+
+/**
+ * Bulk load of 8 x --pool-size new pages followed by an update of every page in random order, with victims evicted
+ * one at a time and in batches of growing size. Reports the time and the number of write requests that reached the
+ * disk; a batch writes a run of consecutive dirty pages with one request.
+ */
+void WriteBackBench(const BpmBenchConfig &config) {
+  const size_t num_pages = config.pool_size_ * 8;
+  fmt::print("writeback: pool_size={} pages={} latency={}us\n", config.pool_size_, num_pages, config.latency_us_);
+  fmt::print("{:>8} {:>12} {:>12} {:>12} {:>12} {:>16}\n", "batch", "load (ms)", "update (ms)", "writes", "pages/write",
+             "write p99 (us)");
+  for (size_t batch_size : {0, 8, 32, 128}) {
+    if (batch_size > config.pool_size_) {
+      break;
+    }
+    auto disk_manager = std::make_unique<SlowDiskManager>(DiskConfig(config));
+    auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(config.pool_size_, disk_manager.get());
+    if (batch_size > 0) {
+      bpm->EnableBatchEviction(1, batch_size);
+    }
+    auto start = ClockMs();
+    auto page_ids = CreatePages(bpm.get(), num_pages);
+    auto load_ms = ClockMs() - start;
+
+    std::shuffle(page_ids.begin(), page_ids.end(), std::mt19937(15445));
+    start = ClockMs();
+    for (auto page_id : page_ids) {
+      auto *page = bpm->FetchPage(page_id);
+      if (page == nullptr) {
+        throw bustub::Exception("bpm bench: fetch failed");
+      }
+      page->GetData()[0]++;
+      bpm->UnpinPage(page_id, true);
+    }
+    auto update_ms = ClockMs() - start;
+
+    auto stats = bpm->GetStats();
+    // Victims of single evictions are written one request each.
+    auto writes = stats.batch_writes_ + (batch_size == 0 ? stats.write_backs_ : 0);
+    fmt::print("{:>8} {:>12} {:>12} {:>12} {:>12.1f} {:>16}\n", batch_size == 0 ? "off" : std::to_string(batch_size),
+               load_ms, update_ms, writes, stats.write_backs_ / static_cast<double>(std::max<uint64_t>(writes, 1)),
+               bustub::SimulatedDiskStats::Percentile(disk_manager->GetStats().write_latency_, 99));
+  }
+}
+
+/**
+ * RID fetches of an index scan: every worker resolves groups of 16 random pages of a table twice the pool size, one
+ * FetchPage() at a time and with one FetchPages() call per group. Misses of a group are read concurrently by the
+ * latter.
+ */
+void FetchPagesBench(const BpmBenchConfig &config) {
+  const size_t group_size = 16;
+  fmt::print("fetchpages: pool_size={} pages={} threads={} latency={}us\n", config.pool_size_, config.pool_size_ * 2,
+             config.threads_, config.latency_us_);
+  for (bool batched : {false, true}) {
+    auto disk_manager = std::make_unique<SlowDiskManager>(DiskConfig(config));
+    auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(config.pool_size_, disk_manager.get());
+    auto page_ids = CreatePages(bpm.get(), config.pool_size_ * 2);
+    disk_manager->ResetStats();
+
+    std::atomic<uint64_t> fetched{0};
+    std::vector<std::thread> threads;
+    auto start = ClockMs();
+    for (size_t tid = 0; tid < config.threads_; tid++) {
+      threads.emplace_back([&, tid]() {
+        std::mt19937 gen(tid);
+        std::uniform_int_distribution<size_t> dis(0, page_ids.size() - 1);
+        std::vector<bustub::page_id_t> group(group_size);
+        std::vector<bustub::Page *> pages;
+        while (ClockMs() - start < config.duration_ms_) {
+          for (auto &page_id : group) {
+            page_id = page_ids[dis(gen)];
+          }
+          if (batched) {
+            bpm->FetchPages(group, &pages);
+            bpm->UnpinPages(group, false);
+          } else {
+            for (auto page_id : group) {
+              if (bpm->FetchPage(page_id) != nullptr) {
+                bpm->UnpinPage(page_id, false);
+              }
+            }
+          }
+          fetched += group_size;
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    fmt::print("{:<12} {:>12.0f} pages/s\n", batched ? "FetchPages" : "FetchPage",
+               fetched / static_cast<double>(ClockMs() - start) * 1000);
+    PrintStats(batched ? "FetchPages" : "FetchPage", bpm->GetStats());
+    PrintDiskStats(batched ? "FetchPages" : "FetchPage", disk_manager->GetStats());
+  }
+}
+
+/**
+ * Restart of a buffer pool whose hot set of --pages pages is scattered over a table of 4 x --pool-size pages. The
+ * first --duration milliseconds after the restart are measured with a cold pool, after a synchronous warm-up from the
+ * saved hot set, and while the hot set is loaded in the background.
+ */
+void WarmUpBench(const BpmBenchConfig &config) {
+  const std::string hot_set_path = "bpm_bench.hotset";
+  fmt::print("warmup: pool_size={} hot_pages={} threads={} latency={}us\n", config.pool_size_, config.pages_,
+             config.threads_, config.latency_us_);
+  auto disk_manager = std::make_unique<SlowDiskManager>(DiskConfig(config, 0));
+  std::vector<bustub::page_id_t> hot_pages;
+  {
+    auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(config.pool_size_, disk_manager.get());
+    auto table_pages = CreatePages(bpm.get(), config.pool_size_ * 4);
+    std::mt19937 gen(15445);
+    std::shuffle(table_pages.begin(), table_pages.end(), gen);
+    hot_pages.assign(table_pages.begin(), table_pages.begin() + std::min(config.pages_, table_pages.size()));
+    RunFetchWorkload(bpm.get(), hot_pages, config.threads_, 100);
+    bpm->FlushAllPages();
+    if (!bpm->SaveHotSet(hot_set_path)) {
+      throw bustub::Exception("bpm bench: cannot save the hot set");
+    }
+  }
+
+  auto slow_disk_manager = std::make_unique<SlowDiskManager>(DiskConfig(config));
+  std::vector<char> data(bustub::BUSTUB_PAGE_SIZE);
+  for (bustub::page_id_t page_id = 0; page_id < static_cast<bustub::page_id_t>(config.pool_size_ * 4); page_id++) {
+    disk_manager->DiskManagerUnlimitedMemory::ReadPage(page_id, data.data());
+    slow_disk_manager->DiskManagerUnlimitedMemory::WritePage(page_id, data.data());
+  }
+  for (const std::string name : {"cold", "warm-up", "background warm-up"}) {
+    auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(config.pool_size_, slow_disk_manager.get());
+    auto start = ClockMs();
+    if (name != "cold") {
+      bpm->WarmUp(hot_set_path, name != "warm-up");
+    }
+    auto warm_up_ms = ClockMs() - start;
+    double hit_rate;
+    auto tput = RunFetchWorkload(bpm.get(), hot_pages, config.threads_, config.duration_ms_, &hit_rate);
+    fmt::print("{:<20} warm-up {:>6}ms  then {:>12.0f} op/s  hit rate {:>6.2f}%\n", name, warm_up_ms, tput,
+               hit_rate * 100);
+    bpm->WaitForWarmUp();
+    PrintStats(name, bpm->GetStats());
+    PrintDiskStats(name, slow_disk_manager->GetStats());
+    slow_disk_manager->ResetStats();
+  }
+  std::remove(hot_set_path.c_str());
+}
+
+/**
+ * Random reads over a table of 3 x --pool-size pages, without and with a compressed victim cache as large as the
+ * pool. Pages are filled with text records, which compress about as well as real table pages.
+ */
+void VictimCacheBench(const BpmBenchConfig &config) {
+  const size_t num_pages = config.pool_size_ * 3;
+  fmt::print("victimcache: pool_size={} pages={} threads={} latency={}us\n", config.pool_size_, num_pages,
+             config.threads_, config.latency_us_);
+  for (bool cached : {false, true}) {
+    auto disk_manager = std::make_unique<SlowDiskManager>(DiskConfig(config));
+    auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(config.pool_size_, disk_manager.get());
+    if (cached) {
+      bpm->EnableVictimCache(config.pool_size_ * bustub::BUSTUB_PAGE_SIZE);
+    }
+    std::mt19937 gen(15445);
+    std::vector<bustub::page_id_t> page_ids;
+    for (size_t i = 0; i < num_pages; i++) {
+      bustub::page_id_t page_id;
+      auto *page = bpm->NewPage(&page_id);
+      if (page == nullptr) {
+        throw bustub::Exception("bpm bench: cannot create page");
+      }
+      for (size_t offset = 0; offset + 64 <= bustub::BUSTUB_PAGE_SIZE; offset += 64) {
+        auto record = fmt::format("{:08}|customer#{:06}|{:>10}.{:02}|NY|active", page_id * 64 + offset / 64,
+                                  gen() % 1000000, gen() % 100000, gen() % 100);
+        memcpy(page->GetData() + offset, record.data(), record.size());
+      }
+      bpm->UnpinPage(page_id, true);
+      page_ids.push_back(page_id);
+    }
+
+    disk_manager->ResetStats();
+    double hit_rate;
+    auto tput = RunFetchWorkload(bpm.get(), page_ids, config.threads_, config.duration_ms_, &hit_rate);
+    auto name = cached ? "victim cache" : "no cache";
+    fmt::print("{:<14} {:>12.0f} op/s  no disk read {:>6.2f}%\n", name, tput, hit_rate * 100);
+    PrintStats(name, bpm->GetStats());
+    PrintDiskStats(name, disk_manager->GetStats());
+    auto stats = bpm->GetVictimCacheStats();
+    fmt::print("{}: cache hits={} misses={} inserts={} rejects={} evictions={} pages={} ratio={:.2f}\n", name,
+               stats.hits_, stats.misses_, stats.inserts_, stats.rejects_, stats.evictions_, stats.pages_,
+               stats.CompressionRatio());
+  }
+}
+
+/**
+ * Disk manager whose page reads and writes take one latch, as the file stream backend did before it moved to
+ * positional I/O. Only used as the baseline of the diskio benchmark.
+ */
+class SerializedDiskManager : public bustub::DiskManager {
+ public:
+  using bustub::DiskManager::DiskManager;
+
+  void ReadPage(bustub::page_id_t page_id, char *page_data) override {
+    std::scoped_lock lock(latch_);
+    bustub::DiskManager::ReadPage(page_id, page_data);
+  }
+
+ private:
+  std::mutex latch_;
+};
+
+/**
+ * Runs `num_threads` threads that read random pages of the first `num_pages` pages of the file of `disk_manager` for
+ * `duration_ms`. Returns the number of reads per second.
+ */
+auto RunDiskReadWorkload(bustub::DiskManager *disk_manager, size_t num_pages, size_t num_threads,
+                         uint64_t duration_ms) -> double {
+  std::atomic<uint64_t> reads{0};
+  std::vector<std::thread> threads;
+  auto start = ClockMs();
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid]() {
+      std::mt19937 gen(tid);
+      std::uniform_int_distribution<bustub::page_id_t> dis(0, static_cast<bustub::page_id_t>(num_pages - 1));
+      std::vector<char> data(bustub::BUSTUB_PAGE_SIZE);
+      uint64_t local_reads = 0;
+      while (ClockMs() - start < duration_ms) {
+        for (int i = 0; i < 64; i++) {
+          disk_manager->ReadPage(dis(gen), data.data());
+        }
+        local_reads += 64;
+      }
+      reads += local_reads;
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto elapsed = std::max<uint64_t>(ClockMs() - start, 1);
+  return reads / static_cast<double>(elapsed) * 1000;
+}
+
+/**
+ * Random page reads from a real database file, with all reads taking one latch and with positional reads that run
+ * in parallel. The file is small enough to stay in the page cache, so this measures the I/O path rather than the
+ * device.
+ */
+void DiskIOBench(const BpmBenchConfig &config) {
+  const std::string db_file = "bpm_bench_diskio.db";
+  fmt::print("diskio: pages={}\n", config.pages_);
+  {
+    bustub::DiskManager disk_manager(db_file);
+    std::vector<char> data(bustub::BUSTUB_PAGE_SIZE);
+    for (size_t i = 0; i < config.pages_; i++) {
+      memset(data.data(), static_cast<int>(i), data.size());
+      disk_manager.WritePage(static_cast<bustub::page_id_t>(i), data.data());
+    }
+    disk_manager.ShutDown();
+  }
+  fmt::print("{:>8} {:>16} {:>18} {:>8}\n", "threads", "latched (IOPS)", "positional (IOPS)", "speedup");
+  {
+    SerializedDiskManager serialized(db_file);
+    bustub::DiskManager positional(db_file);
+    for (size_t num_threads = 1; num_threads <= config.max_threads_; num_threads *= 2) {
+      auto latched = RunDiskReadWorkload(&serialized, config.pages_, num_threads, config.duration_ms_);
+      auto parallel = RunDiskReadWorkload(&positional, config.pages_, num_threads, config.duration_ms_);
+      fmt::print("{:>8} {:>16.0f} {:>18.0f} {:>7.2f}x\n", num_threads, latched, parallel, parallel / latched);
+    }
+    serialized.ShutDown();
+    positional.ShutDown();
+  }
+  remove(db_file.c_str());
+  remove("bpm_bench_diskio.log");
+}
+
+/**
+ * One thread that keeps `queue_depth` random page reads in flight on `disk_manager` for `duration_ms`, submitting a
+ * new read as soon as the oldest completes. Returns the number of reads per second.
+ */
+auto RunAsyncReadWorkload(bustub::DiskManager *disk_manager, size_t num_pages, size_t queue_depth,
+                          uint64_t duration_ms) -> double {
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<bustub::page_id_t> dis(0, static_cast<bustub::page_id_t>(num_pages - 1));
+  std::vector<std::vector<char>> buffers(queue_depth, std::vector<char>(bustub::BUSTUB_PAGE_SIZE));
+  std::vector<std::future<bool>> requests(queue_depth);
+  for (size_t i = 0; i < queue_depth; i++) {
+    requests[i] = disk_manager->ReadPageAsync(dis(gen), buffers[i].data());
+  }
+  uint64_t reads = 0;
+  auto start = ClockMs();
+  while (ClockMs() - start < duration_ms) {
+    for (size_t i = 0; i < queue_depth; i++) {
+      requests[i].wait();
+      requests[i] = disk_manager->ReadPageAsync(dis(gen), buffers[i].data());
+    }
+    reads += queue_depth;
+  }
+  for (auto &request : requests) {
+    request.wait();
+  }
+  auto elapsed = std::max<uint64_t>(ClockMs() - start, 1);
+  return reads / static_cast<double>(elapsed) * 1000;
+}
+
+/**
+ * Random page reads from a real database file through the asynchronous interface at queue depths 1 to 128, with the
+ * default engine (io_uring where the kernel allows it) and with the thread pool fallback.
+ */
+void AsyncIOBench(const BpmBenchConfig &config) {
+  const std::string db_file = "bpm_bench_asyncio.db";
+  fmt::print("asyncio: pages={}\n", config.pages_);
+  {
+    bustub::DiskManager disk_manager(db_file);
+    std::vector<char> data(bustub::BUSTUB_PAGE_SIZE);
+    for (size_t i = 0; i < config.pages_; i++) {
+      memset(data.data(), static_cast<int>(i), data.size());
+      disk_manager.WritePage(static_cast<bustub::page_id_t>(i), data.data());
+    }
+    disk_manager.ShutDown();
+  }
+  bustub::DiskManager native(db_file);
+  bustub::DiskManager pooled(db_file);
+  pooled.SetIOEngine(std::make_unique<bustub::ThreadPoolIOEngine>(&pooled, bustub::ASYNC_IO_WORKERS));
+  fmt::print("{:>8} {:>12} {:>12}\n", "depth", native.GetIOEngine()->GetName(), pooled.GetIOEngine()->GetName());
+  for (size_t queue_depth = 1; queue_depth <= 128; queue_depth *= 2) {
+    auto native_iops = RunAsyncReadWorkload(&native, config.pages_, queue_depth, config.duration_ms_);
+    auto pooled_iops = RunAsyncReadWorkload(&pooled, config.pages_, queue_depth, config.duration_ms_);
+    fmt::print("{:>8} {:>12.0f} {:>12.0f}\n", queue_depth, native_iops, pooled_iops);
+  }
+  native.ShutDown();
+  pooled.ShutDown();
+  remove(db_file.c_str());
+  remove("bpm_bench_asyncio.log");
+}
+
+/** @return the number of bytes of a file that the kernel page cache holds */
+auto PageCacheBytes(const std::string &file) -> size_t {
+  int fd = open(file.c_str(), O_RDONLY);
+  struct stat st {};
+  if (fd < 0 || fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    return 0;
+  }
+  void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  auto os_page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  std::vector<unsigned char> resident((st.st_size + os_page_size - 1) / os_page_size);
+  size_t cached = 0;
+  if (addr != MAP_FAILED && mincore(addr, st.st_size, resident.data()) == 0) {
+    cached = std::count_if(resident.begin(), resident.end(), [](unsigned char r) { return (r & 1) != 0; });
+    munmap(addr, st.st_size);
+  }
+  close(fd);
+  return cached * os_page_size;
+}
+
+/**
+ * Random fetches from a working set twice the largest pool, backed by a real database file opened with buffered
+ * I/O and with O_DIRECT, for a quarter, half and all of --pool-size. Buffered I/O serves misses from the page cache,
+ * which holds a second copy of the pool's pages; the page cache column shows how much of the file it holds after the
+ * run. The third run of every size uses O_DIRECT with that memory added to the pool.
+ */
+void DirectIOBench(const BpmBenchConfig &config) {
+  const std::string db_file = "bpm_bench_directio.db";
+  const size_t num_pages = std::max(config.pages_, 2 * config.pool_size_);
+  fmt::print("directio: pages={} threads={}\n", num_pages, config.threads_);
+  fmt::print("{:>10} {:>9} {:>12} {:>16}\n", "pool_size", "mode", "op/s", "page cache (MB)");
+  for (size_t pool_size = config.pool_size_ / 4; pool_size <= config.pool_size_; pool_size *= 2) {
+    // The last run gives the memory that the page cache took in buffered mode to the pool instead.
+    size_t cache_frames = 0;
+    for (int run = 0; run < 3; run++) {
+      bool direct_io = run > 0;
+      size_t frames = pool_size + (run == 2 ? cache_frames : 0);
+      remove(db_file.c_str());
+      bustub::DiskManager disk_manager(db_file, direct_io);
+      auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(frames, &disk_manager);
+      auto page_ids = CreatePages(bpm.get(), num_pages);
+      bpm->FlushAllPages();
+      // Start both modes from a cold page cache.
+      int fd = open(db_file.c_str(), O_RDONLY);
+      posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+      close(fd);
+      auto tput = RunFetchWorkload(bpm.get(), page_ids, config.threads_, config.duration_ms_);
+      auto cached = PageCacheBytes(db_file);
+      if (run == 0) {
+        cache_frames = cached / bustub::BUSTUB_PAGE_SIZE;
+      }
+      auto mode = disk_manager.IsDirectIO() ? "direct" : (direct_io ? "refused" : "buffered");
+      fmt::print("{:>10} {:>9} {:>12.0f} {:>16.1f}\n", frames, mode, tput, cached / (1024.0 * 1024.0));
+      bpm.reset();
+      disk_manager.ShutDown();
+    }
+  }
+  remove(db_file.c_str());
+  remove("bpm_bench_directio.log");
+}
+
+/** @return the size and the allocated disk space in bytes of a database, over all of its segment files */
+auto DatabaseSize(const std::string &db_file) -> std::pair<int64_t, int64_t> {
+  int64_t size = 0;
+  int64_t allocated = 0;
+  for (int segment = 0;; segment++) {
+    std::string name = segment == 0 ? db_file : db_file + "." + std::to_string(segment);
+    struct stat st {};
+    if (stat(name.c_str(), &st) != 0) {
+      break;
+    }
+    size += st.st_size;
+    allocated += static_cast<int64_t>(st.st_blocks) * 512;
+  }
+  return {size, allocated};
+}
+
+/**
+ * Grows a database file to --pages pages through the buffer pool, then deletes three quarters of them: the upper
+ * half, like a dropped index, and every other page of the lower half, like the nodes a B+ tree merges away. Then it
+ * creates half as many pages again, and another half. Reports the size of the files and the disk space they take
+ * after every phase: deleted pages are punched out, segments left empty are truncated, and new pages reuse deleted
+ * ids before the database grows.
+ */
+void DeleteBench(const BpmBenchConfig &config) {
+  const std::string db_file = "bpm_bench_delete.db";
+  const size_t num_pages = std::max<size_t>(config.pages_, 64);
+  const size_t segment_pages = num_pages / 8;
+  for (int segment = 1; segment < 8; segment++) {
+    remove((db_file + "." + std::to_string(segment)).c_str());
+  }
+  remove(db_file.c_str());
+  remove((db_file + ".free").c_str());
+  bustub::DiskManager disk_manager(db_file, false, segment_pages);
+  auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(config.pool_size_, &disk_manager);
+  fmt::print("delete: pages={} pool_size={} segment_pages={}\n", num_pages, config.pool_size_, segment_pages);
+  fmt::print("{:>9} {:>11} {:>15} {:>13} {:>11} {:>12}\n", "phase", "live pages", "file size (MB)", "on disk (MB)",
+             "free pages", "op/s");
+  size_t live = 0;
+  auto run_phase = [&](const char *phase, size_t ops, const std::function<void()> &work) {
+    auto start = std::chrono::steady_clock::now();
+    work();
+    bpm->FlushAllPages();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    auto [size, allocated] = DatabaseSize(db_file);
+    fmt::print("{:>9} {:>11} {:>15.1f} {:>13.1f} {:>11} {:>12.0f}\n", phase, live, size / (1024.0 * 1024.0),
+               allocated / (1024.0 * 1024.0), disk_manager.GetNumFreePages(), ops / seconds);
+  };
+
+  std::vector<bustub::page_id_t> page_ids;
+  run_phase("create", num_pages, [&] {
+    page_ids = CreatePages(bpm.get(), num_pages);
+    live = num_pages;
+  });
+  run_phase("delete", num_pages * 3 / 4, [&] {
+    for (size_t i = 0; i < num_pages; i++) {
+      if ((i >= num_pages / 2 || i % 2 == 1) && bpm->DeletePage(page_ids[i])) {
+        live--;
+      }
+    }
+  });
+  for (const char *phase : {"recreate", "regrow"}) {
+    run_phase(phase, num_pages / 2, [&] {
+      CreatePages(bpm.get(), num_pages / 2);
+      live += num_pages / 2;
+    });
+  }
+  PrintStats("delete", bpm->GetStats());
+  bpm.reset();
+  disk_manager.ShutDown();
+  for (int segment = 1; segment < 8; segment++) {
+    remove((db_file + "." + std::to_string(segment)).c_str());
+  }
+  remove(db_file.c_str());
+  remove((db_file + ".free").c_str());
+  remove("bpm_bench_delete.log");
+}
+
+/**
+ * Appends `rows` rows made by `make_row` to a new table heap in the pool of `bpm`. The pages are filled one after the
+ * other, since TableHeap::InsertTuple() looks for space from the first page on. Returns the first page of the table.
+ */
+auto AppendTable(bustub::BufferPoolManager *bpm, bustub::Transaction *transaction, size_t rows,
+                 const std::function<bustub::Tuple(size_t)> &make_row) -> bustub::page_id_t {
+  bustub::page_id_t first_page_id = bustub::INVALID_PAGE_ID;
+  bustub::page_id_t page_id = bustub::INVALID_PAGE_ID;
+  bustub::TablePage *page = nullptr;
+  for (size_t row = 0; row < rows; row++) {
+    bustub::Tuple tuple = make_row(row);
+    bustub::RID rid;
+    while (page == nullptr || !page->InsertTuple(tuple, &rid, transaction, nullptr, nullptr)) {
+      bustub::page_id_t next_page_id;
+      auto *next_page = reinterpret_cast<bustub::TablePage *>(bpm->NewPage(&next_page_id));
+      if (next_page == nullptr) {
+        throw bustub::Exception("bpm bench: cannot create page");
+      }
+      next_page->Init(next_page_id, bustub::BUSTUB_PAGE_SIZE, page_id, nullptr, transaction);
+      if (page == nullptr) {
+        first_page_id = next_page_id;
+      } else {
+        page->SetNextPageId(next_page_id);
+        bpm->UnpinPage(page_id, true);
+      }
+      page = next_page;
+      page_id = next_page_id;
+    }
+  }
+  if (page != nullptr) {
+    bpm->UnpinPage(page_id, true);
+  }
+  return first_page_id;
+}
+
+/**
+ * What the page size this bench was built with buys, see the BUSTUB_PAGE_SIZE build option. Loads a table heap of
+ * about --pages x 4 KB of 64-byte tuples and a B+ tree with 64-byte keys over as many rows, in random order, through
+ * a pool of --pool-size x 4 KB on the simulated disk. Then times a full scan of the table and random point lookups in
+ * the tree. Data and pool are sized in bytes, so that builds with different page sizes compare like for like;
+ * build_support/page_size_sweep.sh builds and runs all of them.
+ */
+void PageSizeBench(const BpmBenchConfig &config) {
+  using WideKey = bustub::GenericKey<64>;
+  using WideTree = bustub::BPlusTree<WideKey, bustub::RID, bustub::GenericComparator<64>>;
+  using WideInternalPage = bustub::BPlusTreeInternalPage<WideKey, bustub::page_id_t, bustub::GenericComparator<64>>;
+  constexpr size_t row_bytes = 64;
+  const size_t data_bytes = config.pages_ * 4096;
+  const size_t pool_frames = std::max<size_t>(config.pool_size_ * 4096 / bustub::BUSTUB_PAGE_SIZE, 16);
+  const size_t rows = data_bytes / row_bytes;
+  fmt::print("pagesize: page_size={} data={:.1f} MB pool={:.1f} MB ({} frames) threads={} latency={}us\n",
+             bustub::BUSTUB_PAGE_SIZE, data_bytes / 1048576.0, pool_frames * bustub::BUSTUB_PAGE_SIZE / 1048576.0,
+             pool_frames, config.threads_, config.latency_us_);
+  auto disk_manager = std::make_unique<SlowDiskManager>(DiskConfig(config));
+  disk_manager->SetLoading(true);
+  auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(pool_frames, disk_manager.get());
+  bustub::Transaction transaction(0);
+  bustub::page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+
+  // A bigint and a varchar of 40 bytes make a row of some 70 bytes with its slot.
+  auto schema = bustub::ParseCreateStatement("a bigint,b varchar(40)");
+  const std::string filler(40, 'x');
+  auto first_page_id = AppendTable(bpm.get(), &transaction, rows, [&](size_t row) {
+    return bustub::Tuple({bustub::ValueFactory::GetBigIntValue(static_cast<int64_t>(row)),
+                          bustub::ValueFactory::GetVarcharValue(filler)},
+                         schema.get());
+  });
+  bustub::TableHeap table(bpm.get(), nullptr, nullptr, first_page_id);
+  std::vector<int64_t> keys(rows);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(config.seed_));
+  auto key_schema = bustub::ParseCreateStatement("a bigint");
+  bustub::GenericComparator<64> comparator(key_schema.get());
+  WideTree tree("pagesize", bpm.get(), comparator);
+  WideKey index_key;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, bustub::RID(0, static_cast<uint32_t>(key)), &transaction);
+  }
+  bpm->FlushAllPages();
+  disk_manager->SetLoading(false);
+
+  // The scan goes through a ring, as it would in a query, so that it does not push the inner pages of the tree out.
+  auto start = ClockMs();
+  size_t scanned = 0;
+  std::set<bustub::page_id_t> table_pages;
+  for (auto it = table.Begin(&transaction, std::make_shared<bustub::BufferAccessStrategy>(bustub::SCAN_RING_SIZE));
+       it != table.End(); ++it) {
+    table_pages.insert(it->GetRid().GetPageId());
+    scanned++;
+  }
+  auto scan_ms = std::max<uint64_t>(ClockMs() - start, 1);
+  if (scanned != rows) {
+    throw bustub::Exception("bpm bench: scan missed tuples");
+  }
+  auto scan_stats = disk_manager->GetStats();
+  fmt::print("table: rows={} pages={} rows/page={:.1f} scan {} ms {:.1f} MB/s {} read requests\n", rows,
+             table_pages.size(), rows / static_cast<double>(table_pages.size()), scan_ms,
+             data_bytes / 1048576.0 / scan_ms * 1000, scan_stats.reads_);
+  PrintDiskStats("table scan", scan_stats);
+
+  // Walk down the leftmost path for the height of the tree.
+  size_t height = 1;
+  for (auto page_id = tree.GetRootPageId();; height++) {
+    auto *page = reinterpret_cast<WideInternalPage *>(bpm->FetchPage(page_id)->GetData());
+    bool leaf = page->IsLeafPage();
+    auto child = leaf ? bustub::INVALID_PAGE_ID : page->ValueAt(0);
+    bpm->UnpinPage(page_id, false);
+    if (leaf) {
+      break;
+    }
+    page_id = child;
+  }
+  disk_manager->ResetStats();
+  std::atomic<uint64_t> lookups{0};
+  std::vector<std::thread> threads;
+  start = ClockMs();
+  for (size_t tid = 0; tid < config.threads_; tid++) {
+    threads.emplace_back([&, tid]() {
+      std::mt19937 gen(config.seed_ + tid);
+      std::uniform_int_distribution<int64_t> dis(0, static_cast<int64_t>(rows) - 1);
+      WideKey key;
+      std::vector<bustub::RID> rids;
+      while (ClockMs() - start < config.duration_ms_) {
+        rids.clear();
+        key.SetFromInteger(dis(gen));
+        if (!tree.GetValue(key, &rids)) {
+          throw bustub::Exception("bpm bench: key not found");
+        }
+        lookups++;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto lookup_stats = disk_manager->GetStats();
+  fmt::print("btree: keys={} height={} lookups {:.0f} op/s {:.2f} pages read/lookup\n", rows, height,
+             lookups / static_cast<double>(ClockMs() - start) * 1000,
+             lookup_stats.pages_read_ / static_cast<double>(std::max<uint64_t>(lookups, 1)));
+  PrintDiskStats("btree lookups", lookup_stats);
+}
+
+/**
+ * What page checksums cost. Times CRC-32C over pages with the crc32 instruction and without, then sequential scans
+ * through a ring of a database file of max(--pages, 4 x --pool-size) pages with checksums verified and not: once
+ * with the file in the page cache, where the scan is bound by the read path and the overhead is at its largest, and
+ * once with the page cache dropped before every scan. The modes take turns for five rounds and the fastest scan of
+ * each counts.
+ */
+void ChecksumBench(const BpmBenchConfig &config) {
+  const std::string db_file = "bpm_bench_checksum.db";
+  const size_t num_pages = std::max(config.pages_, 4 * config.pool_size_);
+  fmt::print("checksum: pages={} pool_size={} page_size={}\n", num_pages, config.pool_size_, bustub::BUSTUB_PAGE_SIZE);
+
+  std::vector<char> data(bustub::BUSTUB_PAGE_SIZE);
+  std::mt19937 gen(config.seed_);
+  for (auto &byte : data) {
+    byte = static_cast<char>(gen());
+  }
+  auto crc_throughput = [&](const std::function<uint32_t(uint32_t, const char *, size_t)> &extend) {
+    uint32_t crc = 0;
+    size_t bytes = 0;
+    auto start = ClockMs();
+    while (ClockMs() - start < config.duration_ms_ / 4) {
+      for (int i = 0; i < 1024; i++) {
+        crc = extend(crc, data.data(), data.size());
+      }
+      bytes += 1024 * data.size();
+    }
+    auto elapsed = std::max<uint64_t>(ClockMs() - start, 1);
+    return bytes / 1048576.0 / elapsed * 1000;
+  };
+  fmt::print("crc32c: hardware {:.0f} MB/s{} software {:.0f} MB/s\n", crc_throughput(bustub::Crc32c::Extend),
+             bustub::Crc32c::IsHardwareAccelerated() ? "" : " (not available, software)",
+             crc_throughput(bustub::Crc32c::ExtendSoftware));
+
+  remove(db_file.c_str());
+  bustub::DiskManager disk_manager(db_file);
+  auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(config.pool_size_, &disk_manager);
+  auto page_ids = CreatePages(bpm.get(), num_pages);
+  bpm->FlushAllPages();
+  auto scan = [&](bool cold) {
+    if (cold) {
+      int fd = open(db_file.c_str(), O_RDONLY);
+      fdatasync(fd);
+      posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+      close(fd);
+    }
+    auto strategy = std::make_shared<bustub::BufferAccessStrategy>(bustub::SCAN_RING_SIZE);
+    auto start = std::chrono::steady_clock::now();
+    for (auto page_id : page_ids) {
+      if (bpm->FetchPageWithStrategy(page_id, strategy.get()) == nullptr) {
+        throw bustub::Exception("bpm bench: cannot fetch page");
+      }
+      bpm->UnpinPage(page_id, false);
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  };
+  fmt::print("{:>12} {:>10} {:>10} {:>12} {:>10}\n", "page cache", "checksums", "scan (ms)", "pages/s", "overhead");
+  for (bool cold : {false, true}) {
+    // A first scan warms the page cache for the cached runs.
+    scan(false);
+    double best_off = std::numeric_limits<double>::max();
+    double best_on = std::numeric_limits<double>::max();
+    for (int round = 0; round < 5; round++) {
+      disk_manager.SetChecksums(false);
+      best_off = std::min(best_off, scan(cold));
+      disk_manager.SetChecksums(true);
+      best_on = std::min(best_on, scan(cold));
+    }
+    const char *cache = cold ? "cold" : "cached";
+    fmt::print("{:>12} {:>10} {:>10.1f} {:>12.0f}\n", cache, "off", best_off, num_pages / best_off * 1000);
+    fmt::print("{:>12} {:>10} {:>10.1f} {:>12.0f} {:>9.2f}%\n", cache, "on", best_on, num_pages / best_on * 1000,
+               (best_on / best_off - 1) * 100);
+  }
+  if (disk_manager.GetNumChecksumFailures() != 0) {
+    throw bustub::Exception("bpm bench: checksum mismatch");
+  }
+  bpm.reset();
+  disk_manager.ShutDown();
+  remove(db_file.c_str());
+  remove("bpm_bench_checksum.log");
+}
+
+/**
+ * What compressing the database file buys on the data it is meant for: an append-mostly table of orders of about
+ * --pages x 4 KB, with increasing ids, few distinct customers, statuses and cities, and comments made from a template.
+ * The table is loaded through a pool of --pool-size frames into a plain and into a compressed database file, and then
+ * scanned through a ring by a fresh pool, with the page cache dropped before every scan and with the file in it.
+ * Throughput counts plain pages; the fastest of three scans counts.
+ */
+void CompressionBench(const BpmBenchConfig &config) {
+  const std::string db_file = "bpm_bench_compression.db";
+  const size_t data_bytes = config.pages_ * 4096;
+  // Rows take some 80 bytes with their slot.
+  const size_t rows = data_bytes / 80;
+  fmt::print("compression: rows={} data={:.1f} MB pool_size={}\n", rows, data_bytes / 1048576.0, config.pool_size_);
+  auto schema =
+      bustub::ParseCreateStatement("id bigint,customer integer,status integer,city varchar(16),comment varchar(64)");
+  const std::vector<std::string> cities = {"Pittsburgh", "Seattle", "Boston", "Austin", "Chicago"};
+  auto make_row = [&](size_t row) {
+    const auto &city = cities[(row / 13) % cities.size()];
+    return bustub::Tuple({bustub::ValueFactory::GetBigIntValue(static_cast<int64_t>(row)),
+                          bustub::ValueFactory::GetIntegerValue(static_cast<int32_t>(row / 7 % 1000)),
+                          bustub::ValueFactory::GetIntegerValue(static_cast<int32_t>(row % 4)),
+                          bustub::ValueFactory::GetVarcharValue(city),
+                          bustub::ValueFactory::GetVarcharValue(fmt::format("order {} shipped to {}", row, city))},
+                         schema.get());
+  };
+  auto remove_files = [&]() {
+    remove(db_file.c_str());
+    remove((db_file + ".free").c_str());
+    remove((db_file + ".extents").c_str());
+    remove("bpm_bench_compression.log");
+  };
+
+  fmt::print("{:>11} {:>10} {:>10} {:>7} {:>11} {:>16} {:>18}\n", "format", "pages", "file (MB)", "ratio",
+             "load (MB/s)", "cold scan (MB/s)", "cached scan (MB/s)");
+  for (bool compressed : {false, true}) {
+    remove_files();
+    std::unique_ptr<bustub::DiskManager> disk_manager;
+    if (compressed) {
+      disk_manager = std::make_unique<bustub::DiskManagerCompressed>(db_file);
+    } else {
+      disk_manager = std::make_unique<bustub::DiskManager>(db_file);
+    }
+    bustub::Transaction transaction(0);
+    auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(config.pool_size_, disk_manager.get());
+    auto start = std::chrono::steady_clock::now();
+    auto first_page_id = AppendTable(bpm.get(), &transaction, rows, make_row);
+    bpm->FlushAllPages();
+    double load_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // A fresh pool, so that every page of the scan comes from the disk manager.
+    bpm = std::make_unique<bustub::BufferPoolManagerInstance>(config.pool_size_, disk_manager.get());
+    bustub::TableHeap table(bpm.get(), nullptr, nullptr, first_page_id);
+    std::set<bustub::page_id_t> table_pages;
+    auto scan = [&](bool cold) {
+      if (cold) {
+        int fd = open(db_file.c_str(), O_RDONLY);
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+      }
+      size_t scanned = 0;
+      auto start = std::chrono::steady_clock::now();
+      auto strategy = std::make_shared<bustub::BufferAccessStrategy>(bustub::SCAN_RING_SIZE);
+      for (auto it = table.Begin(&transaction, strategy); it != table.End(); ++it) {
+        table_pages.insert(it->GetRid().GetPageId());
+        scanned++;
+      }
+      if (scanned != rows) {
+        throw bustub::Exception("bpm bench: scan missed tuples");
+      }
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+    double cold_seconds = std::numeric_limits<double>::max();
+    double cached_seconds = std::numeric_limits<double>::max();
+    for (int round = 0; round < 3; round++) {
+      cold_seconds = std::min(cold_seconds, scan(true));
+    }
+    for (int round = 0; round < 3; round++) {
+      cached_seconds = std::min(cached_seconds, scan(false));
+    }
+    if (disk_manager->GetNumChecksumFailures() != 0) {
+      throw bustub::Exception("bpm bench: corrupt page");
+    }
+    double plain_mb = table_pages.size() * bustub::BUSTUB_PAGE_SIZE / 1048576.0;
+    auto file_mb = DatabaseSize(db_file).first / 1048576.0;
+    fmt::print("{:>11} {:>10} {:>10.1f} {:>6.2f}x {:>11.0f} {:>16.0f} {:>18.0f}\n",
+               compressed ? "compressed" : "plain", table_pages.size(), file_mb, plain_mb / file_mb,
+               plain_mb / load_seconds, plain_mb / cold_seconds, plain_mb / cached_seconds);
+    bpm.reset();
+    disk_manager->ShutDown();
+  }
+  remove_files();
+}
+
+/**
+ * Runs `num_threads` threads that look up random resident pages in `table` for `duration_ms`, like buffer pool hits
+ * do. Returns the number of lookups per second.
+ */
+template <typename TableType>
+auto RunPageTableWorkload(TableType *table, size_t num_pages, size_t num_threads, uint64_t duration_ms) -> double {
+  std::vector<std::thread> threads;
+  std::vector<uint64_t> ops(num_threads, 0);
+  auto start = ClockMs();
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid]() {
+      std::mt19937 gen(tid);
+      std::uniform_int_distribution<bustub::page_id_t> dis(0, static_cast<bustub::page_id_t>(num_pages - 1));
+      uint64_t cnt = 0;
+      bustub::frame_id_t frame_id;
+      while (ClockMs() - start < duration_ms) {
+        for (size_t i = 0; i < 1024; i++) {
+          if (!table->Find(dis(gen), frame_id)) {
+            throw bustub::Exception("bpm bench: page not found");
+          }
+        }
+        cnt += 1024;
+      }
+      ops[tid] = cnt;
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  uint64_t total = 0;
+  for (auto cnt : ops) {
+    total += cnt;
+  }
+  return total / static_cast<double>(ClockMs() - start) * 1000;
+}
+
+/**
+ * Hit-path lookups in the page table: the ExtendibleHashTable the buffer pool used to have against PageTable, holding
+ * --pool-size pages, while the number of threads grows from 1 to --max-threads.
+ */
+void PageTableBench(const BpmBenchConfig &config) {
+  fmt::print("pagetable: pages={}\n", config.pool_size_);
+  bustub::ExtendibleHashTable<bustub::page_id_t, bustub::frame_id_t> extendible(4);
+  bustub::PageTable page_table(config.pool_size_);
+  for (size_t i = 0; i < config.pool_size_; i++) {
+    auto page_id = static_cast<bustub::page_id_t>(i);
+    extendible.Insert(page_id, page_id);
+    page_table.Insert(page_id, page_id);
+  }
+  fmt::print("{:>8} {:>18} {:>12} {:>18} {:>12} {:>8}\n", "threads", "extendible (op/s)", "(ns/op)",
+             "page table (op/s)", "(ns/op)", "speedup");
+  for (size_t num_threads = 1; num_threads <= config.max_threads_; num_threads *= 2) {
+    auto extendible_tput = RunPageTableWorkload(&extendible, config.pool_size_, num_threads, config.duration_ms_);
+    auto page_table_tput = RunPageTableWorkload(&page_table, config.pool_size_, num_threads, config.duration_ms_);
+    fmt::print("{:>8} {:>18.0f} {:>12.1f} {:>18.0f} {:>12.1f} {:>7.2f}x\n", num_threads, extendible_tput,
+               num_threads * 1e9 / extendible_tput, page_table_tput, num_threads * 1e9 / page_table_tput,
+               page_table_tput / extendible_tput);
+  }
+}
+
+/** Keeps the compiler from dropping reads whose results are otherwise unused. */
+volatile uint64_t bench_sink;
+
+/**
+ * Reads one random word of a random frame at a time for `duration_ms`, then scans every frame once. Returns the
+ * random reads per second and the scan bandwidth in GB/s.
+ */
+auto RunArenaWorkload(char *data, size_t num_frames, uint64_t duration_ms) -> std::pair<double, double> {
+  std::mt19937_64 gen(15445);
+  uint64_t sum = 0;
+  uint64_t cnt = 0;
+  auto start = ClockMs();
+  while (ClockMs() - start < duration_ms) {
+    for (size_t i = 0; i < 4096; i++) {
+      auto rand = gen();
+      auto frame = rand % num_frames;
+      auto word = (rand >> 32) % (bustub::BUSTUB_PAGE_SIZE / sizeof(uint64_t));
+      sum += reinterpret_cast<uint64_t *>(data + frame * bustub::BUSTUB_PAGE_SIZE)[word];
+    }
+    cnt += 4096;
+  }
+  auto random_tput = cnt / static_cast<double>(ClockMs() - start) * 1000;
+
+  start = ClockMs();
+  auto *words = reinterpret_cast<uint64_t *>(data);
+  for (size_t i = 0; i < num_frames * bustub::BUSTUB_PAGE_SIZE / sizeof(uint64_t); i++) {
+    sum += words[i];
+  }
+  auto scan_ms = std::max<uint64_t>(ClockMs() - start, 1);
+  bench_sink = sum;
+  return {random_tput, num_frames * bustub::BUSTUB_PAGE_SIZE / 1e6 / scan_ms};
+}
+
+/**
+ * Random reads and a sequential scan over --pool-size frames: first straight over a FrameArena with regular and with
+ * huge pages, then through FetchPage() and UnpinPage() of a buffer pool holding every page. Random reads over a
+ * multi-GB pool are dominated by TLB misses, e.g. `--pool-size 524288` for 2 GB with 4 KB pages.
+ */
+void ArenaBench(const BpmBenchConfig &config) {
+  auto num_frames = config.pool_size_;
+  fmt::print("arena: frames={} size={:.1f} GB\n", num_frames, num_frames * bustub::BUSTUB_PAGE_SIZE / 1e9);
+  fmt::print("{:>24} {:>12} {:>16} {:>12} {:>12}\n", "backing", "touch (ms)", "random (op/s)", "(ns/op)",
+             "scan (GB/s)");
+  for (bool use_huge_pages : {false, true}) {
+    bustub::FrameArena arena(num_frames, use_huge_pages);
+    auto start = ClockMs();
+    memset(arena.GetData(), 1, num_frames * bustub::BUSTUB_PAGE_SIZE);
+    auto touch_ms = ClockMs() - start;
+    auto [random_tput, scan_gbps] = RunArenaWorkload(arena.GetData(), num_frames, config.duration_ms_);
+    fmt::print("{:>24} {:>12} {:>16.0f} {:>12.1f} {:>12.2f}\n",
+               bustub::FrameArena::BackingToString(arena.GetBacking()), touch_ms, random_tput, 1e9 / random_tput,
+               scan_gbps);
+  }
+
+  auto disk_manager = std::make_unique<bustub::DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(num_frames, disk_manager.get());
+  std::vector<bustub::page_id_t> page_ids;
+  for (size_t i = 0; i < num_frames; i++) {
+    bustub::page_id_t page_id;
+    bpm->NewPage(&page_id);
+    bpm->UnpinPage(page_id, false);
+    page_ids.push_back(page_id);
+  }
+  auto lookup_tput = RunFetchWorkload(bpm.get(), page_ids, 1, config.duration_ms_);
+  auto start = ClockMs();
+  uint64_t sum = 0;
+  for (auto page_id : page_ids) {
+    auto *page = bpm->FetchPage(page_id);
+    auto *words = reinterpret_cast<uint64_t *>(page->GetData());
+    for (size_t i = 0; i < bustub::BUSTUB_PAGE_SIZE / sizeof(uint64_t); i++) {
+      sum += words[i];
+    }
+    bpm->UnpinPage(page_id, false);
+  }
+  auto scan_ms = std::max<uint64_t>(ClockMs() - start, 1);
+  bench_sink = sum;
+  fmt::print("buffer pool ({}): fetch+unpin {:.0f} op/s ({:.1f} ns/op), scan {:.2f} GB/s\n",
+             bustub::FrameArena::BackingToString(bpm->GetFrameArena()->GetBacking()), lookup_tput, 1e9 / lookup_tput,
+             num_frames * bustub::BUSTUB_PAGE_SIZE / 1e6 / scan_ms);
+}
+
+using BenchTree = bustub::BPlusTree<bustub::GenericKey<8>, bustub::RID, bustub::GenericComparator<8>>;
+
+/**
+ * Runs `num_threads` threads that look up random keys in [0, num_keys) with GetValue for `duration_ms`. If
+ * `with_writer` is set, another thread keeps inserting and deleting keys above num_keys meanwhile. Returns the number
+ * of lookups per second.
+ */
+auto RunBPlusTreeWorkload(BenchTree *tree, int64_t num_keys, size_t num_threads, bool with_writer,
+                          uint64_t duration_ms) -> double {
+  std::vector<std::thread> threads;
+  std::vector<uint64_t> ops(num_threads, 0);
+  std::atomic<bool> done{false};
+  auto start = ClockMs();
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid]() {
+      std::mt19937 gen(tid);
+      std::uniform_int_distribution<int64_t> dis(0, num_keys - 1);
+      bustub::GenericKey<8> index_key;
+      std::vector<bustub::RID> rids;
+      uint64_t cnt = 0;
+      while (ClockMs() - start < duration_ms) {
+        for (size_t i = 0; i < 1024; i++) {
+          rids.clear();
+          index_key.SetFromInteger(dis(gen));
+          if (!tree->GetValue(index_key, &rids)) {
+            throw bustub::Exception("bpm bench: key not found");
+          }
+        }
+        cnt += 1024;
+      }
+      ops[tid] = cnt;
+    });
+  }
+  std::thread writer;
+  if (with_writer) {
+    writer = std::thread([&]() {
+      bustub::Transaction transaction(0);
+      bustub::GenericKey<8> index_key;
+      while (!done) {
+        for (int64_t key = num_keys; key < num_keys + 256; key++) {
+          index_key.SetFromInteger(key);
+          tree->Insert(index_key, bustub::RID(0, static_cast<uint32_t>(key)), &transaction);
+        }
+        for (int64_t key = num_keys; key < num_keys + 256; key++) {
+          index_key.SetFromInteger(key);
+          tree->Remove(index_key, &transaction);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto elapsed = ClockMs() - start;
+  done = true;
+  if (writer.joinable()) {
+    writer.join();
+  }
+  uint64_t total = 0;
+  for (auto cnt : ops) {
+    total += cnt;
+  }
+  return total / static_cast<double>(elapsed) * 1000;
+}
+
+/**
+ * Point lookups in a B+ tree of --pages * 128 keys over the parallel buffer pool, read-only and next to one writer,
+ * while the number of reader threads grows from 1 to --max-threads. Lookups validate page versions instead of taking
+ * page latches, so read-only throughput should grow with the number of cores.
+ */
+void BPlusTreeBench(const BpmBenchConfig &config) {
+  auto num_keys = static_cast<int64_t>(config.pages_ * 128);
+  auto key_schema = bustub::ParseCreateStatement("a bigint");
+  bustub::GenericComparator<8> comparator(key_schema.get());
+  auto disk_manager = std::make_unique<bustub::DiskManagerUnlimitedMemory>();
+  auto pool_size = config.pool_size_ / config.instances_;
+  auto bpm = std::make_unique<bustub::ParallelBufferPoolManager>(config.instances_, pool_size, disk_manager.get());
+  bustub::page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  BenchTree tree("bench", bpm.get(), comparator);
+  bustub::Transaction transaction(0);
+  bustub::GenericKey<8> index_key;
+  for (int64_t key = 0; key < num_keys; key++) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, bustub::RID(0, static_cast<uint32_t>(key)), &transaction);
+  }
+
+  fmt::print("btree: keys={} pool_size={} instances={}\n", num_keys, config.pool_size_, config.instances_);
+  fmt::print("{:>8} {:>18} {:>12} {:>18} {:>12}\n", "threads", "read-only (op/s)", "(ns/op)", "+1 writer (op/s)",
+             "(ns/op)");
+  for (size_t num_threads = 1; num_threads <= config.max_threads_; num_threads *= 2) {
+    auto read_only_tput = RunBPlusTreeWorkload(&tree, num_keys, num_threads, false, config.duration_ms_);
+    auto mixed_tput = RunBPlusTreeWorkload(&tree, num_keys, num_threads, true, config.duration_ms_);
+    fmt::print("{:>8} {:>18.0f} {:>12.1f} {:>18.0f} {:>12.1f}\n", num_threads, read_only_tput,
+               num_threads * 1e9 / read_only_tput, mixed_tput, num_threads * 1e9 / mixed_tput);
+  }
+  bpm->UnpinPage(header_page_id, true);
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-bpm-bench");
+  program.add_argument("--scenario")
+      .help(
+          "benchmark to run: contention, replacer, recording, io, scan, writeback, fetchpages, warmup, victimcache, "
+          "diskio, asyncio, directio, delete, pagesize, checksum, compression, pagetable, btree, arena")
+      .default_value(std::string("contention"));
+  program.add_argument("--duration").help("run each configuration for n milliseconds");
+  program.add_argument("--max-threads").help("largest number of worker threads");
+  program.add_argument("--instances").help("number of shards of the parallel buffer pool");
+  program.add_argument("--pool-size").help("total number of frames");
+  program.add_argument("--pages").help("number of pages in the working set");
+  program.add_argument("--evictions").help("number of evictions per replacer configuration");
+  program.add_argument("--threads").help("number of worker threads");
+  program.add_argument("--latency").help("simulated disk latency of a random request in microseconds");
+  program.add_argument("--seq-latency").help("simulated disk latency of a sequential request in microseconds");
+  program.add_argument("--bandwidth").help("simulated disk bandwidth in MB/s, 0 for unlimited");
+  program.add_argument("--queue-depth").help("requests the simulated disk serves at once");
+  program.add_argument("--seed").help("seed of the simulated disk latency jitter");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  BpmBenchConfig config;
+  if (program.present("--duration")) {
+    config.duration_ms_ = std::stoull(program.get("--duration"));
+  }
+  if (program.present("--max-threads")) {
+    config.max_threads_ = std::stoull(program.get("--max-threads"));
+  }
+  if (program.present("--instances")) {
+    config.instances_ = std::stoull(program.get("--instances"));
+  }
+  if (program.present("--pool-size")) {
+    config.pool_size_ = std::stoull(program.get("--pool-size"));
+  }
+  if (program.present("--pages")) {
+    config.pages_ = std::stoull(program.get("--pages"));
+  }
+  if (program.present("--evictions")) {
+    config.evictions_ = std::stoull(program.get("--evictions"));
+  }
+  if (program.present("--threads")) {
+    config.threads_ = std::stoull(program.get("--threads"));
+  }
+  if (program.present("--latency")) {
+    config.latency_us_ = std::stoull(program.get("--latency"));
+  }
+  if (program.present("--seq-latency")) {
+    config.sequential_latency_us_ = std::stoull(program.get("--seq-latency"));
+  }
+  if (program.present("--bandwidth")) {
+    config.bandwidth_mb_s_ = std::stod(program.get("--bandwidth"));
+  }
+  if (program.present("--queue-depth")) {
+    config.queue_depth_ = std::stoull(program.get("--queue-depth"));
+  }
+  if (program.present("--seed")) {
+    config.seed_ = std::stoull(program.get("--seed"));
+  }
+
+  auto scenario = program.get("--scenario");
+  if (scenario == "contention") {
+    ContentionBench(config);
+  } else if (scenario == "replacer") {
+    ReplacerBench(config);
+  } else if (scenario == "recording") {
+    RecordingBench(config);
+  } else if (scenario == "io") {
+    IOBench(config);
+  } else if (scenario == "scan") {
+    ScanBench(config);
+  } else if (scenario == "writeback") {
+    WriteBackBench(config);
+  } else if (scenario == "fetchpages") {
+    FetchPagesBench(config);
+  } else if (scenario == "warmup") {
+    WarmUpBench(config);
+  } else if (scenario == "victimcache") {
+    VictimCacheBench(config);
+  } else if (scenario == "diskio") {
+    DiskIOBench(config);
+  } else if (scenario == "asyncio") {
+    AsyncIOBench(config);
+  } else if (scenario == "directio") {
+    DirectIOBench(config);
+  } else if (scenario == "delete") {
+    DeleteBench(config);
+  } else if (scenario == "pagesize") {
+    PageSizeBench(config);
+  } else if (scenario == "checksum") {
+    ChecksumBench(config);
+  } else if (scenario == "compression") {
+    CompressionBench(config);
+  } else if (scenario == "pagetable") {
+    PageTableBench(config);
+  } else if (scenario == "btree") {
+    BPlusTreeBench(config);
+  } else if (scenario == "arena") {
+    ArenaBench(config);
+  } else {
+    std::cerr << "unknown scenario: " << scenario << std::endl;
+    return 1;
+  }
+  return 0;
+}
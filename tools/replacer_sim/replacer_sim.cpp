@@ -0,0 +1,274 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "fmt/core.h"
+
+/**
+ * Trace-driven replacement policy simulator. Replays a page access trace against every replacement policy the
+ * buffer pool supports, through the same BufferPoolReplacer interface the buffer pool uses, and reports hit ratios.
+ *
+ * A trace is a text file with one page id per line; empty lines and lines starting with '#' are skipped. Without
+ * --trace, a synthetic workload is generated, and --save-trace writes it out in that format.
+ */
+
+struct SimConfig {
+  std::string workload_{"mixed"};
+  size_t accesses_{1000000};
+  size_t pages_{10000};
+  double skew_{0.99};
+  size_t scan_interval_{50000};
+  size_t scan_length_{5000};
+  uint64_t seed_{15445};
+};
+
+/** Draws page ids 0..n-1 with a Zipfian distribution; page 0 is the most popular. */
+class ZipfGenerator {
+ public:
+  ZipfGenerator(size_t n, double skew) : cdf_(n) {
+    double sum = 0;
+    for (size_t i = 0; i < n; i++) {
+      sum += 1.0 / std::pow(static_cast<double>(i + 1), skew);
+      cdf_[i] = sum;
+    }
+    for (auto &c : cdf_) {
+      c /= sum;
+    }
+  }
+
+  auto operator()(std::mt19937_64 &gen) const -> bustub::page_id_t {
+    auto pos = std::lower_bound(cdf_.begin(), cdf_.end(), std::uniform_real_distribution<double>(0, 1)(gen));
+    return static_cast<bustub::page_id_t>(std::min<size_t>(pos - cdf_.begin(), cdf_.size() - 1));
+  }
+
+ private:
+  std::vector<double> cdf_;
+};
+
+/**
+ * zipf:  skewed point lookups on --pages pages.
+ * mixed: the same point lookups, interrupted every --scan-interval accesses by a sequential scan of --scan-length
+ *        pages that are never looked up otherwise.
+ * loop:  repeated sequential passes over --pages pages, the worst case for LRU.
+ */
+auto GenerateTrace(const SimConfig &config) -> std::vector<bustub::page_id_t> {
+  std::vector<bustub::page_id_t> trace;
+  trace.reserve(config.accesses_);
+  std::mt19937_64 gen(config.seed_);
+  if (config.workload_ == "loop") {
+    for (size_t i = 0; i < config.accesses_; i++) {
+      trace.push_back(static_cast<bustub::page_id_t>(i % config.pages_));
+    }
+    return trace;
+  }
+  ZipfGenerator zipf(config.pages_, config.skew_);
+  // Scanned pages live behind the point lookup pages; every scan moves on to the next range.
+  auto next_scan_page = static_cast<bustub::page_id_t>(config.pages_);
+  bool scans = config.workload_ == "mixed" && config.scan_interval_ > 0;
+  while (trace.size() < config.accesses_) {
+    if (scans && trace.size() % config.scan_interval_ == config.scan_interval_ - 1) {
+      for (size_t i = 0; i < config.scan_length_ && trace.size() < config.accesses_; i++) {
+        trace.push_back(next_scan_page++);
+      }
+      continue;
+    }
+    // Scatter the popular pages so that they are not also the lowest page ids.
+    auto rank = static_cast<uint64_t>(zipf(gen));
+    trace.push_back(static_cast<bustub::page_id_t>(rank * 2654435761ULL % config.pages_));
+  }
+  return trace;
+}
+
+auto LoadTrace(const std::string &path, std::vector<bustub::page_id_t> *trace) -> bool {
+  std::ifstream in(path);
+  if (!in) {
+    return false;
+  }
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    trace->push_back(static_cast<bustub::page_id_t>(std::stol(line)));
+  }
+  return true;
+}
+
+auto SaveTrace(const std::string &path, const std::vector<bustub::page_id_t> &trace) -> bool {
+  std::ofstream out(path);
+  out << "# page access trace, one page id per line\n";
+  for (auto page_id : trace) {
+    out << page_id << '\n';
+  }
+  return static_cast<bool>(out);
+}
+
+/**
+ * Replay the trace against a cache of num_frames frames. A hit records an access to the page's frame; a miss takes a
+ * free frame or evicts one, like BufferPoolManagerInstance does, and leaves the page unpinned.
+ * @return the hit ratio
+ */
+auto Simulate(bustub::ReplacerPolicy policy, size_t num_frames, size_t k,
+              const std::vector<bustub::page_id_t> &trace) -> double {
+  std::unique_ptr<bustub::BufferPoolReplacer> replacer(bustub::CreateReplacer(policy, num_frames, k));
+  std::unordered_map<bustub::page_id_t, bustub::frame_id_t> page_table;
+  std::vector<bustub::page_id_t> frame_pages(num_frames, bustub::INVALID_PAGE_ID);
+  size_t used_frames = 0;
+  size_t hits = 0;
+  for (auto page_id : trace) {
+    auto it = page_table.find(page_id);
+    if (it != page_table.end()) {
+      hits++;
+      replacer->RecordAccess(it->second, page_id);
+      continue;
+    }
+    bustub::frame_id_t frame_id;
+    if (used_frames < num_frames) {
+      frame_id = static_cast<bustub::frame_id_t>(used_frames++);
+    } else {
+      if (!replacer->Evict(&frame_id)) {
+        std::cerr << "replacer found no victim" << std::endl;
+        std::abort();
+      }
+      page_table.erase(frame_pages[frame_id]);
+    }
+    frame_pages[frame_id] = page_id;
+    page_table[page_id] = frame_id;
+    replacer->RecordAccess(frame_id, page_id);
+    replacer->SetEvictable(frame_id, true);
+  }
+  return trace.empty() ? 0 : static_cast<double>(hits) / static_cast<double>(trace.size());
+}
+
+auto ParseList(const std::string &list) -> std::vector<std::string> {
+  std::vector<std::string> items;
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-replacer-sim");
+  program.add_argument("--trace").help("page access trace to replay, one page id per line");
+  program.add_argument("--save-trace").help("write the replayed trace to this file");
+  program.add_argument("--workload")
+      .help("synthetic workload if no trace is given: zipf, mixed, loop")
+      .default_value(std::string("mixed"));
+  program.add_argument("--accesses").help("number of accesses of the synthetic workload");
+  program.add_argument("--pages").help("number of point lookup pages of the synthetic workload");
+  program.add_argument("--skew").help("Zipf exponent of the point lookups");
+  program.add_argument("--scan-interval").help("accesses between two scans of the mixed workload");
+  program.add_argument("--scan-length").help("pages per scan of the mixed workload");
+  program.add_argument("--seed").help("random seed of the synthetic workload");
+  program.add_argument("--frames")
+      .help("comma-separated cache sizes in frames")
+      .default_value(std::string("100,500,1000,2000,5000"));
+  program.add_argument("--policies")
+      .help("comma-separated replacement policies: lru-k, arc, 2q, w-tinylfu")
+      .default_value(std::string("lru-k,arc,2q,w-tinylfu"));
+  program.add_argument("--k").help("lookback constant of LRU-K");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  SimConfig config;
+  config.workload_ = program.get("--workload");
+  if (program.present("--accesses")) {
+    config.accesses_ = std::stoull(program.get("--accesses"));
+  }
+  if (program.present("--pages")) {
+    config.pages_ = std::stoull(program.get("--pages"));
+  }
+  if (program.present("--skew")) {
+    config.skew_ = std::stod(program.get("--skew"));
+  }
+  if (program.present("--scan-interval")) {
+    config.scan_interval_ = std::stoull(program.get("--scan-interval"));
+  }
+  if (program.present("--scan-length")) {
+    config.scan_length_ = std::stoull(program.get("--scan-length"));
+  }
+  if (program.present("--seed")) {
+    config.seed_ = std::stoull(program.get("--seed"));
+  }
+  size_t k = bustub::LRUK_REPLACER_K;
+  if (program.present("--k")) {
+    k = std::stoull(program.get("--k"));
+  }
+
+  std::vector<bustub::ReplacerPolicy> policies;
+  for (const auto &name : ParseList(program.get("--policies"))) {
+    bustub::ReplacerPolicy policy;
+    if (!bustub::ReplacerPolicyFromString(name, &policy)) {
+      std::cerr << "unknown policy: " << name << std::endl;
+      return 1;
+    }
+    policies.push_back(policy);
+  }
+  std::vector<size_t> frame_counts;
+  for (const auto &frames : ParseList(program.get("--frames"))) {
+    frame_counts.push_back(std::stoull(frames));
+  }
+
+  std::vector<bustub::page_id_t> trace;
+  std::string source;
+  if (program.present("--trace")) {
+    source = program.get("--trace");
+    if (!LoadTrace(source, &trace)) {
+      std::cerr << "cannot read trace " << source << std::endl;
+      return 1;
+    }
+  } else {
+    if (config.workload_ != "zipf" && config.workload_ != "mixed" && config.workload_ != "loop") {
+      std::cerr << "unknown workload: " << config.workload_ << std::endl;
+      return 1;
+    }
+    source = config.workload_;
+    trace = GenerateTrace(config);
+  }
+  if (program.present("--save-trace") && !SaveTrace(program.get("--save-trace"), trace)) {
+    std::cerr << "cannot write trace " << program.get("--save-trace") << std::endl;
+    return 1;
+  }
+
+  std::unordered_map<bustub::page_id_t, bool> distinct;
+  for (auto page_id : trace) {
+    distinct[page_id] = true;
+  }
+  fmt::print("trace: {} accesses={} distinct_pages={} k={}\n", source, trace.size(), distinct.size(), k);
+  fmt::print("{:>10}", "frames");
+  for (auto policy : policies) {
+    fmt::print(" {:>10}", bustub::ReplacerPolicyToString(policy));
+  }
+  fmt::print("\n");
+  for (auto num_frames : frame_counts) {
+    fmt::print("{:>10}", num_frames);
+    for (auto policy : policies) {
+      fmt::print(" {:>9.2f}%", 100 * Simulate(policy, num_frames, k, trace));
+    }
+    fmt::print("\n");
+  }
+  return 0;
+}
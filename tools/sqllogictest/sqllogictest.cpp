@@ -147,6 +147,10 @@ auto main(int argc, char **argv) -> int {  // NOLINT
   program.add_argument("--verbose").help("increase output verbosity").default_value(false).implicit_value(true);
   program.add_argument("-d", "--diff").help("write diff file").default_value(false).implicit_value(true);
   program.add_argument("--in-memory").help("use in-memory backend").default_value(false).implicit_value(true);
+  program.add_argument("--buffer-pool-size")
+      .help("number of frames of the buffer pool")
+      .default_value(bustub::BustubInstance::DEFAULT_BUFFER_POOL_SIZE)
+      .scan<'u', size_t>();
 
   try {
     program.parse_args(argc, argv);
@@ -173,10 +177,11 @@ auto main(int argc, char **argv) -> int {  // NOLINT
 
   std::unique_ptr<bustub::BustubInstance> bustub;
 
+  auto buffer_pool_size = program.get<size_t>("--buffer-pool-size");
   if (program.get<bool>("--in-memory")) {
-    bustub = std::make_unique<bustub::BustubInstance>();
+    bustub = std::make_unique<bustub::BustubInstance>(buffer_pool_size);
   } else {
-    bustub = std::make_unique<bustub::BustubInstance>("test.db");
+    bustub = std::make_unique<bustub::BustubInstance>("test.db", buffer_pool_size);
   }
 
   bustub->GenerateMockTable();